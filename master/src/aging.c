@@ -4,93 +4,104 @@
 #include "aging.h"
 #include "scheduler.h"
 #include "disconnection_handler.h"
+#include "query_queue.h"
 #include <unistd.h>
+#include <time.h>
 #include <commons/log.h>
 
-static int search_worker_id = -1;
+// Espera hasta el instante absoluto deadline_ms del reloj monotónico o hasta que la despierten
+static void aging_wait_until(t_master *master, uint64_t deadline_ms) {
+    struct timespec deadline = {
+        .tv_sec = deadline_ms / 1000,
+        .tv_nsec = (deadline_ms % 1000) * 1000000L
+    };
+    pthread_cond_timedwait(&master->queries_table->aging_cond,
+                           &master->queries_table->query_table_mutex, &deadline);
+}
+
+/**
+ * Aplica el aging a las queries cuyo plazo ya venció. La lista de aging de la cola READY
+ * está ordenada por ready_timestamp, así que sólo se recorren las que cambian de prioridad.
+ * Debe llamarse con query_table_mutex tomado. Retorna true si alguna prioridad cambió.
+ */
+static bool age_due_queries(t_master *master, uint64_t now) {
+    t_query_queue *ready_queue = master->queries_table->ready_queue;
+    uint64_t interval = (uint64_t)master->aging_interval;
+    bool priorities_changed = false;
+
+    t_query_control_block *qcb;
+    while ((qcb = ready_queue->aging_head) != NULL && qcb->ready_timestamp + interval <= now) {
+        // Si no tiene timestamp válido (legacy), inicializarlo
+        if (qcb->ready_timestamp == 0) {
+            qcb->ready_timestamp = now;
+            query_queue_update(ready_queue, qcb, qcb->priority);
+            continue;
+        }
+
+        uint64_t elapsed = now - qcb->ready_timestamp; // Calculo cuanto tiempo estuvo en READY
+
+        // Si el hilo se demoró más de un intervalo, se aplican todos los decrementos juntos
+        int intervals = elapsed / interval;
+        int original_priority = qcb->priority;
+
+        if (intervals >= qcb->priority) {
+            qcb->priority = 0;
+        } else {
+            qcb->priority -= intervals;
+        }
+
+        // Actualizamos en timestamp en Ready
+        qcb->ready_timestamp += (uint64_t)intervals * interval;
+
+        // Mover la query al bucket de su nueva prioridad; con prioridad 0 deja de envejecer
+        query_queue_update(ready_queue, qcb, qcb->priority);
+        priorities_changed = true;
+
+        log_info(master->logger, "##<QUERY_ID: %d> Cambio de prioridad: <PRIORIDAD_ANTERIOR: %d> - <PRIORIDAD_NUEVA: %d>", qcb->query_id, original_priority, qcb->priority);
+    }
+
+    return priorities_changed;
+}
 
 void *aging_thread_func(void *arg) {
     t_master *master = (t_master*) arg;
 
-    while (master->running) {
-        // Definir cada cuanto se hace la verificación, un tiempo fijo (100ms, 250ms)
-        // o una fracción del aging interval (10 veces cada intervalo)
-        if (master->aging_interval <= 0) {
-            usleep(100000); // 100ms
-            continue;
-        }else{
-            usleep(master->aging_interval * 100); // -> Por ahora, 10 verificaciones por intervalo
-        }
-        //try_dispatch(master); // Intentar despachar queries pendientes (por errores)
+    if (pthread_mutex_lock(&master->queries_table->query_table_mutex) != 0) {
+        log_error(master->logger, "[Aging] Error al lockear query_table_mutex");
+        return NULL;
+    }
 
+    while (master->running) {
         uint64_t now = now_ms_monotonic();
 
-        if (pthread_mutex_lock(&master->queries_table->query_table_mutex) != 0) {
-            log_error(master->logger, "[Aging] Error al lockear query_table_mutex");
+        if (master->aging_interval <= 0) {
+            // Aging deshabilitado: sólo se vuelve a mirar por si cambia el running
+            aging_wait_until(master, now + 100);
             continue;
         }
 
-        // si ready queue está vacia, nada para hacer
-        if (list_is_empty(master->queries_table->ready_queue)) {            
-            pthread_mutex_unlock(&master->queries_table->query_table_mutex);
+        // El hilo duerme hasta que la próxima query llegue a su intervalo. Si no hay
+        // ninguna, espera un intervalo completo por si se encoló sin avisar
+        t_query_control_block *next = master->queries_table->ready_queue->aging_head;
+        uint64_t next_change = next != NULL
+            ? next->ready_timestamp + (uint64_t)master->aging_interval
+            : now + (uint64_t)master->aging_interval;
+
+        if (next_change > now) {
+            aging_wait_until(master, next_change);
             continue;
         }
 
-        bool priorities_changed = false;
-
-        int ready_count = list_size(master->queries_table->ready_queue);
-        for (int i = 0; i < ready_count; i++) {
-            t_query_control_block *qcb = list_get(master->queries_table->ready_queue, i);
-            if (!qcb) continue;
-
-            // Asegurarse que esté realmente en READY (por si hay inconsistencias)
-            if (qcb->state != QUERY_STATE_READY) continue;
-
-            // Si no tiene timestamp válido (legacy), inicializarlo
-            if (qcb->ready_timestamp == 0) {
-                qcb->ready_timestamp = now;
-                continue;
-            }
-
-            uint64_t elapsed = now - qcb->ready_timestamp; // Calculo cuanto tiempo estuvo en READY
-
-            if (elapsed < (uint64_t)master->aging_interval) {
-                // No llegó al intervalo aún
-                continue;
-            }
-
-            // Esta verificación es por si tenemos tiempo fijo y "se pasa" de un intervalo
-            // NO DEBERÍA PASAR...
-            int intervals = elapsed / master->aging_interval;
-            // Aplicar hasta que prioridad llegue a 0
-            int decrements = intervals;
-            int original_priority = qcb->priority;
-
-            if (decrements > 0 && qcb->priority > 0) {
-                if (decrements >= qcb->priority) {
-                    qcb->priority = 0;
-                } else {
-                    qcb->priority -= decrements;
-                }
-                priorities_changed = true;
-
-                // Actualizamos en timestamp en Ready
-                qcb->ready_timestamp += (uint64_t)intervals * (uint64_t)master->aging_interval;
-                
-                log_info(master->logger, "##<QUERY_ID: %d> Cambio de prioridad: <PRIORIDAD_ANTERIOR: %d> - <PRIORIDAD_NUEVA: %d>", qcb->query_id, original_priority, qcb->priority);
-            }
-        }
+        bool priorities_changed = age_due_queries(master, now);
 
         if (priorities_changed) {
-            // Reordenar la READY queue
-            list_sort(master->queries_table->ready_queue, _qcb_priority_compare);
+            pthread_mutex_unlock(&master->queries_table->query_table_mutex);
+            check_preemption(master);
+            pthread_mutex_lock(&master->queries_table->query_table_mutex);
         }
-
-        pthread_mutex_unlock(&master->queries_table->query_table_mutex);
-
-        check_preemption(master);
     }
 
+    pthread_mutex_unlock(&master->queries_table->query_table_mutex);
     return NULL;
 }
 
@@ -101,23 +112,17 @@ void check_preemption(t_master *master) {
 
     // Nada para hacer si no hay running o no hay ready
     if(list_is_empty(master->workers_table->busy_list) ||
-       list_is_empty(master->queries_table->ready_queue)) {
+       query_queue_is_empty(master->queries_table->ready_queue)) {
         goto unlock_and_exit;
     }
 
     // La mejor query en READY (ya ordenado por prioridad)
     t_query_control_block *best_ready =
-        list_get(master->queries_table->ready_queue, 0);
+        query_queue_peek_min(master->queries_table->ready_queue);
 
-    // Buscar la query de menor prioridad en RUNNING
-    t_query_control_block *worst_running = NULL;
-
-    for(int i = 0; i < list_size(master->queries_table->running_list); i++) {
-        t_query_control_block *qcb = list_get(master->queries_table->running_list, i);
-        if(worst_running == NULL || qcb->priority > worst_running->priority) {
-            worst_running = qcb;
-        }
-    }
+    // La query de menor prioridad en RUNNING
+    t_query_control_block *worst_running =
+        query_queue_peek_max(master->queries_table->running_by_priority);
 
     // Si NO hay preemption necesaria
     if(worst_running == NULL || best_ready->priority >= worst_running->priority) {
@@ -143,13 +148,9 @@ int preempt_query_in_exec(t_query_control_block *qcb, t_master *master) {
         return 0;
     }
 
-    search_worker_id = qcb->assigned_worker_id;
-    t_worker_control_block *worker = list_find(
-        master->workers_table->worker_list,
-        match_worker_by_id
-    );
+    t_worker_control_block *worker = find_worker_by_id(master->workers_table, qcb->assigned_worker_id);
 
-    if (!worker || worker->socket_fd <= 0) {
+    if (!worker || worker->socket_fd <= 0 || worker->outbox == NULL) {
         log_error(master->logger,
             "[preempt_query_in_exec] Worker inválido durante preemption. Finalizando Query ID=%d",
             qcb->query_id
@@ -162,11 +163,11 @@ int preempt_query_in_exec(t_query_control_block *qcb, t_master *master) {
 
     qcb->preemption_pending = true;
 
-    // Envío solicitud de desalojo
+    // Encolo la solicitud de desalojo: la envía el hilo del worker, sin los mutex tomados
     t_package *pkg = package_create_empty(OP_WORKER_PREEMPT_REQ);
     package_add_uint32(pkg, (uint32_t)qcb->query_id);
     
-    if (package_send(pkg, worker->socket_fd) != 0) {
+    if (worker_outbox_push(worker->outbox, pkg) != 0) {
         log_error(master->logger,
             "[preempt_query_in_exec] Error al enviar solicitud de desalojo al Worker ID=%d",
             worker->worker_id);
@@ -174,8 +175,6 @@ int preempt_query_in_exec(t_query_control_block *qcb, t_master *master) {
         package_destroy(pkg);
         return -1;
     }
-    
-    package_destroy(pkg);
 
     log_info(master->logger,
         "## Se desaloja la Query id: %d (<PRIORIDAD: %d>) del Worker <WORKER_ID: %d> - Motivo: <PRIORIDAD>",
@@ -190,8 +189,3 @@ bool _qcb_priority_compare(void *a, void *b) {
     t_query_control_block *q2 = b;
     return q1->priority < q2->priority; // menor número gana
 }
-
-bool match_worker_by_id(void *elem) {
-    t_worker_control_block *w = elem;
-    return w && w->worker_id == search_worker_id;
-}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include <unistd.h>
+#include <stdlib.h>
+
+#include "client_handler.h"
+#include "query_control_manager.h"
+#include "worker_manager.h"
+#include "disconnection_handler.h"
+
+void *handle_client(void *arg) {
+    t_client_data *client_data = (t_client_data*)arg;
+    int client_socket = client_data->client_socket;
+    t_master *master = client_data->master;
+
+    // flags para identificar tipo de cliente y manejar desconexiones
+    t_client_role role = { .is_query_control = false, .is_worker = false };
+
+    while (1) {
+        t_package *required_package = package_receive(client_socket);
+
+        if (required_package == NULL) {
+            log_debug(master->logger, "Error al recibir el paquete del cliente %d, se cierra conexión y libera socket.", client_socket);
+            handle_client_disconnection(client_socket, &role, master);
+            break; // Sale del bucle y termina el hilo
+        }
+
+        dispatch_client_package(required_package, client_socket, &role, master);
+        package_destroy(required_package); // Libera el paquete recibido
+    }
+
+    close(client_socket);
+    free(client_data);
+
+    return NULL;
+}
+
+bool is_disconnection_package(t_package *package) {
+    return package->operation_code == QC_OP_DISCONNECTION ||
+           package->operation_code == WORKER_OP_DISCONNECTION;
+}
+
+void handle_client_disconnection(int client_socket, t_client_role *role, t_master *master) {
+    // Manejar desconexión según tipo de cliente identificado
+    if (role->is_query_control) {
+        handle_query_control_disconnection(client_socket, master);
+    } else if (role->is_worker) {
+        handle_worker_disconnection(client_socket, master);
+    } else {
+        // Cliente no identificado, solo cerrar socket
+        log_warning(master->logger, "Cliente no identificado en socket %d se desconectó", client_socket);
+        close(client_socket);
+    }
+}
+
+void dispatch_client_package(t_package *required_package, int client_socket, t_client_role *role, t_master *master) {
+    switch (required_package->operation_code)
+    {
+        case OP_QUERY_HANDSHAKE:
+            log_debug(master->logger, "Recibido OP_QUERY_HANDSHAKE de socket %d", client_socket);
+            if (manage_query_handshake(client_socket, master->logger) == 0) {
+                role->is_query_control = true;
+                log_debug(master->logger, "Handshake completado con Query Control en socket %d", client_socket);
+            }
+            break;
+        case OP_QUERY_FILE_PATH:
+            log_debug(master->logger, "Recibido OP_QUERY_FILE_PATH de socket %d", client_socket);
+            if (manage_query_file_path(required_package, client_socket, master) != 0) {
+                log_error(master->logger, "Error al manejar OP_QUERY_FILE_PATH del cliente %d", client_socket);
+            }
+            break;
+        case QC_OP_DISCONNECTION:
+            log_info(master->logger, "Recibido QC_OP_DISCONNECTION de socket %d", client_socket);
+            handle_query_control_disconnection(client_socket, master);
+            break;
+
+        // Worker
+        case OP_WORKER_HANDSHAKE_REQ:
+            log_debug(master->logger, "Recibido OP_WORKER_HANDSHAKE de socket %d", client_socket);
+            if (manage_worker_handshake(required_package->buffer, client_socket, master) == 0) {
+                role->is_worker = true;
+                log_debug(master->logger, "Handshake completado con worker en socket %d", client_socket);
+            }
+            break;
+        case OP_WORKER_READ_MESSAGE_REQ:
+            log_debug(master->logger, "Recibido OP_WORKER_READ_MESSAGE de socket %d", client_socket);
+            if (manage_read_message_from_worker(required_package->buffer, client_socket, master) != 0) {
+                log_error(master->logger, "Error al manejar OP_WORKER_READ_MESSAGE del cliente %d", client_socket);
+            }
+            break;
+        case OP_WORKER_END_QUERY:
+            log_debug(master->logger, "Recibido OP_WORKER_END_QUERY en socket %d", client_socket);
+            if (manage_worker_end_query(required_package->buffer, client_socket, master) != 0) {
+                log_error(master->logger, "Error al manejar OP_WORKER_END_QUERY desde socket %d", client_socket);
+            }
+            break;
+        case OP_WORKER_EVICT_RES:
+            log_debug(master->logger, "Recibido OP_WORKER_EVICT_RES en socket %d", client_socket);
+            manage_worker_evict_response(client_socket, required_package, master);
+            break;
+        case WORKER_OP_DISCONNECTION:
+            log_info(master->logger, "Recibido WORKER_OP_DISCONNECTION de socket %d", client_socket);
+            handle_worker_disconnection(client_socket, master);
+            break;
+        case STORAGE_OP_ERROR:
+            handle_error_from_storage(required_package, client_socket, master);
+            break;
+        default:
+            log_warning(master->logger, "Operacion desconocida recibida del cliente %d", client_socket);
+            break;
+    }
+}
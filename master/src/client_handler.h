@@ -0,0 +1,56 @@
+/**
+ * @file client_handler.h
+ * @brief Atención de paquetes recibidos desde Query Controls y Workers
+ *
+ * Lo comparten los dos modos de conexión del Master: un hilo por cliente
+ * (handle_client) y el reactor basado en epoll (reactor.h).
+ */
+
+#ifndef CLIENT_HANDLER_H
+#define CLIENT_HANDLER_H
+
+#include <stdbool.h>
+#include <connection/serialization.h>
+#include "init_master.h"
+
+// Tipo de cliente identificado durante el handshake, para manejar su desconexión
+typedef struct {
+    bool is_query_control;
+    bool is_worker;
+} t_client_role;
+
+typedef struct {
+    int client_socket;
+    t_master *master;
+} t_client_data;
+
+/**
+ * @brief Hilo que atiende a un único cliente con lecturas bloqueantes (modo HILOS).
+ *
+ * @param arg t_client_data alocado por el hilo que acepta conexiones, se libera al terminar
+ */
+void *handle_client(void *arg);
+
+/**
+ * @brief Despacha un paquete recibido al manejador que corresponde según su código de operación.
+ *
+ * Actualiza el rol del cliente cuando el paquete es un handshake exitoso.
+ * No libera el paquete.
+ */
+void dispatch_client_package(t_package *package, int client_socket, t_client_role *role, t_master *master);
+
+/**
+ * @brief Indica si el paquete es un aviso de desconexión explícito.
+ *
+ * Al despacharlo, el manejador correspondiente cierra el socket del cliente.
+ */
+bool is_disconnection_package(t_package *package);
+
+/**
+ * @brief Maneja el cierre de la conexión según el tipo de cliente identificado.
+ *
+ * En todos los casos el socket queda cerrado.
+ */
+void handle_client_disconnection(int client_socket, t_client_role *role, t_master *master);
+
+#endif // CLIENT_HANDLER_H
@@ -23,6 +23,25 @@ t_master_config *create_master_config(char *config_file_path)
     master_config->aging_time = config_get_int_value(config, "TIEMPO_AGING");
     master_config->log_level = log_level_from_string(config_get_string_value(config, "LOG_LEVEL"));
 
+    // Opcionales: sin ellas se mantiene un hilo por conexión
+    master_config->connection_mode = strdup(config_has_property(config, "MODO_CONEXIONES")
+        ? config_get_string_value(config, "MODO_CONEXIONES")
+        : CONNECTION_MODE_THREADS);
+    if (strcmp(master_config->connection_mode, CONNECTION_MODE_THREADS) != 0 &&
+        strcmp(master_config->connection_mode, CONNECTION_MODE_EPOLL) != 0)
+    {
+        fprintf(stderr, "MODO_CONEXIONES invalido: %s (se esperaba HILOS o EPOLL)\n", master_config->connection_mode);
+        goto error;
+    }
+    master_config->reactor_pool_size = config_has_property(config, "HILOS_REACTOR")
+        ? config_get_int_value(config, "HILOS_REACTOR")
+        : REACTOR_POOL_DEFAULT_SIZE;
+    if (master_config->reactor_pool_size <= 0)
+    {
+        fprintf(stderr, "HILOS_REACTOR debe ser mayor a 0\n");
+        goto error;
+    }
+
     config_destroy(config);
     
     return master_config;
@@ -41,5 +60,6 @@ void destroy_master_config_instance(t_master_config *master_config)
     free(master_config->ip);
     free(master_config->port);
     free(master_config->scheduler_algorithm);
+    free(master_config->connection_mode);
     free(master_config);
 }
@@ -9,6 +9,10 @@
 #include <stdbool.h>
 #include <errno.h>
 
+#define CONNECTION_MODE_THREADS "HILOS"
+#define CONNECTION_MODE_EPOLL "EPOLL"
+#define REACTOR_POOL_DEFAULT_SIZE 4
+
 typedef struct
 {
     char *ip;
@@ -16,6 +20,8 @@ typedef struct
     char *scheduler_algorithm;
     int aging_time;
     t_log_level log_level;
+    char *connection_mode;   // HILOS (un hilo por cliente) o EPOLL (reactor)
+    int reactor_pool_size;   // Hilos de despacho del reactor
 } t_master_config;
 
 
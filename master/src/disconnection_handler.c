@@ -10,35 +10,10 @@
 
 #include "init_master.h"
 #include "query_control_manager.h"
+#include "query_queue.h"
 #include "worker_manager.h"
 #include "connection/serialization.h"
 
-// Variables estáticas para predicados de búsqueda
-static int running_query_id_for_predicate = -1;
-static int search_worker_id = -1;
-static int search_query_socket_fd = -1;
-static int search_worker_socket_fd = -1;
-
-// --- Query por ID ---
-static bool match_query_by_id(void *elem) {
-    t_query_control_block *query = (t_query_control_block*)elem;
-    return query && (query->query_id == running_query_id_for_predicate);
-}
-
-// --- Query por socket_fd ---
-static bool match_query_by_socket(void *element) {
-    t_query_control_block *query = (t_query_control_block *)element;
-    if (!query) return false;
-    return (query->socket_fd == search_query_socket_fd);
-}
-
-// --- Worker por socket_fd ---
-static bool match_worker_by_socket(void *element) {
-    t_worker_control_block *worker = (t_worker_control_block *)element;
-    if (!worker) return false;
-    return (worker->socket_fd == search_worker_socket_fd);
-}
-
 int handle_query_control_disconnection(int client_socket, t_master *master) {
     if (master == NULL || master->queries_table == NULL) {
         if (master && master->logger) log_error(master->logger, "[handle_query_control_disconnection] master o query_table NULL");
@@ -134,6 +109,12 @@ int handle_worker_disconnection(int client_socket, t_master *master) {
         return -1;
     }
 
+    // La cola de salida se cierra después de soltar los mutex: close espera al hilo de envío
+    t_worker_outbox *outbox = wcb->outbox;
+    wcb->outbox = NULL;
+    bool start_not_delivered = worker_outbox_lost_start(outbox);
+    bool requeued = false;
+
     // Si tenía una query en ejecución, marcarla como finalizada con error y notificar al QC
     int running_query_id = wcb->current_query_id;
     if (running_query_id >= 0) {
@@ -143,11 +124,20 @@ int handle_worker_disconnection(int client_socket, t_master *master) {
             // En caso de fallo en bloqueo, igual marcamos en worker y continuamos con best-effort
         } else {
             // Buscar la QCB por ID (no por socket en este caso)
-            // Predicate for list_find: es true cuando query id es igual a running_query_id en worker.
-            running_query_id_for_predicate = running_query_id;
-            t_query_control_block *qcb = list_find(master->queries_table->query_list, match_query_by_id);
-
-            if (qcb) {
+            t_query_control_block *qcb = find_query_by_id(master->queries_table, running_query_id);
+
+            if (qcb && start_not_delivered && qcb->state == QUERY_STATE_RUNNING) {
+                // El worker nunca recibió la query: vuelve a READY para otro worker
+                log_warning(master->logger, "[handle_worker_disconnection] Query ID=%d no llegó al Worker id %d, vuelve a READY",
+                            qcb->query_id, wcb->worker_id);
+
+                remove_running_query(master, qcb);
+                qcb->state = QUERY_STATE_READY;
+                qcb->assigned_worker_id = -1;
+                qcb->preemption_pending = false;
+                wcb->current_query_id = -1;
+                requeued = enqueue_ready_query(master, qcb) == 0;
+            } else if (qcb) {
                 log_warning(master->logger, "[handle_worker_disconnection] Worker id %d desconectado mientras realizaba la Query ID=%d (QC socket=%d)",
                             wcb->worker_id, qcb->query_id, qcb->socket_fd);
 
@@ -165,10 +155,15 @@ int handle_worker_disconnection(int client_socket, t_master *master) {
     // Remover worker de las listas y liberar recursos
     cleanup_worker_resources(wcb, master);
 
-    // Cerrar socket
+    pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
+
+    // Sin los mutex tomados: el hilo de envío puede estar esperándolos. Cerrar el socket después
+    worker_outbox_close(outbox);
     close(client_socket);
 
-    pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
+    if (requeued) {
+        try_dispatch(master);
+    }
     return 0;
 }
 
@@ -234,7 +229,7 @@ int handle_eviction_response(int worker_socket, t_buffer *buffer, t_master *mast
         return -1;
     }
 
-    t_query_control_block *qcb = list_find(master->queries_table->query_list, match_query_by_id);
+    t_query_control_block *qcb = find_query_by_id(master->queries_table, (int)qid);
 
     if (!qcb) {
         log_error(master->logger, "[handle_eviction_response] Query ID=%u no encontrada en la tabla de queries", qid);
@@ -305,11 +300,12 @@ void cleanup_query_resources(t_query_control_block *qcb, t_master *master) {
 
     // Remover de TODAS las listas (best-effort)
     if (master->queries_table) {
-        list_remove_element(master->queries_table->ready_queue, qcb);
-        list_remove_element(master->queries_table->running_list, qcb);
+        query_queue_remove(master->queries_table->ready_queue, qcb);
+        remove_running_query(master, qcb);
         list_remove_element(master->queries_table->completed_list, qcb);
         list_remove_element(master->queries_table->canceled_list, qcb);
         list_remove_element(master->queries_table->query_list, qcb);
+        remove_query_from_indexes(master->queries_table, qcb);
     }
 
     if (qcb->query_file_path) {
@@ -324,6 +320,8 @@ void cleanup_query_resources(t_query_control_block *qcb, t_master *master) {
  * cleanup_worker_resources
  *  - Remueve el worker de las listas y libera memoria asociada
  *  - Asume que caller posee el lock workers_table->worker_table_mutex
+ *  - No cierra la cola de salida: el caller la separa antes y la cierra sin
+ *    los mutex tomados (worker_outbox_close espera al hilo de envío)
  */
 void cleanup_worker_resources(t_worker_control_block *wcb, t_master *master) {
     if (!wcb || !master) return;
@@ -336,6 +334,7 @@ void cleanup_worker_resources(t_worker_control_block *wcb, t_master *master) {
         list_remove_element(master->workers_table->idle_list, wcb);
         list_remove_element(master->workers_table->busy_list, wcb);
         list_remove_element(master->workers_table->worker_list, wcb);
+        remove_worker_from_indexes(master->workers_table, wcb);
         
         // Decrementar contador
         if (master->workers_table->total_workers_connected > 0) {
@@ -350,6 +349,9 @@ void cleanup_worker_resources(t_worker_control_block *wcb, t_master *master) {
     if (wcb->ip_address) {
         free(wcb->ip_address);
     }
+    if (wcb->resident_file_tags) {
+        list_destroy_and_destroy_elements(wcb->resident_file_tags, free);
+    }
     
     free(wcb);
 }
@@ -358,22 +360,24 @@ void cleanup_worker_resources(t_worker_control_block *wcb, t_master *master) {
  * find_query_by_socket
  */
 t_query_control_block *find_query_by_socket(t_query_table *table, int socket_fd) {
-    if (!table || !table->query_list)
+    if (!table || !table->queries_by_socket)
         return NULL;
 
-    search_query_socket_fd = socket_fd;
-    return (t_query_control_block *)list_find(table->query_list, match_query_by_socket);
+    char key[INDEX_KEY_SIZE];
+    index_key(key, socket_fd);
+    return dictionary_get(table->queries_by_socket, key);
 }
 
 /**
  * find_worker_by_socket
  */
 t_worker_control_block *find_worker_by_socket(t_worker_table *table, int socket_fd) {
-    if (!table || !table->worker_list)
+    if (!table || !table->workers_by_socket)
         return NULL;
 
-    search_worker_socket_fd = socket_fd;
-    return (t_worker_control_block *)list_find(table->worker_list, match_worker_by_socket);
+    char key[INDEX_KEY_SIZE];
+    index_key(key, socket_fd);
+    return dictionary_get(table->workers_by_socket, key);
 }
 
 int handle_error_from_storage(t_package *required_package, int client_socket, t_master *master) {
@@ -410,8 +414,7 @@ int handle_error_from_storage(t_package *required_package, int client_socket, t_
     char *error_msg = package_read_string(required_package);
 
 /*     // Intentar encontrar worker por ese primer valor (podría ser worker_id)
-    search_worker_id = (int)first_val;
-    t_worker_control_block *wcb = list_find(master->workers_table->worker_list, match_worker_by_id);
+    t_worker_control_block *wcb = find_worker_by_id(master->workers_table, (int)first_val);
 
     if (wcb) {
         // Formato con worker_id presente. Leer query_id a continuación.
@@ -448,14 +451,7 @@ int handle_error_from_storage(t_package *required_package, int client_socket, t_
     printf("Worker ID=%d reportó error en Query ID=%u\n", wcb->worker_id, query_id);
     
     // Buscar query
-    t_query_control_block *qcb = NULL;
-    for (int i = 0; i < list_size(master->queries_table->running_list); i++) {
-        t_query_control_block *q = list_get(master->queries_table->running_list, i);
-        if (q && q->query_id == query_id) {
-            qcb = q;
-            break;
-        }
-    }
+    t_query_control_block *qcb = find_running_query(master->queries_table, query_id);
 
     if (!qcb) {
         log_error(master->logger, "[handle_error_from_storage] Query ID=%u no encontrada en running_list", query_id);
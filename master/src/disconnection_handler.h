@@ -40,7 +40,7 @@ t_worker_control_block* find_worker_by_socket(t_worker_table *table, int socket_
 // Limpia los recursos asociados a una query en EXIT
 void cleanup_query_resources(t_query_control_block *qcb, t_master *master);
 
-// Limpia los recursos asociados a un worker
+// Limpia los recursos asociados a un worker (la cola de salida la cierra el caller)
 void cleanup_worker_resources(t_worker_control_block *wcb, t_master *master);
 
 // Maneja errores recibidos desde el Storage
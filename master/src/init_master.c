@@ -1,10 +1,12 @@
 #include <commons/log.h>
 #include "init_master.h"
 #include "query_control_manager.h"
+#include "query_queue.h"
 #include "worker_manager.h"
 #include "aging.h"
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 t_master* init_master(char *ip, char *port, int aging_interval, char *scheduling_algorithm, t_log *logger) {
     t_master *master = malloc(sizeof(t_master));
@@ -20,22 +22,35 @@ t_master* init_master(char *ip, char *port, int aging_interval, char *scheduling
         goto error;
     }
     master->queries_table->query_list = list_create();
+    master->queries_table->queries_by_id = dictionary_create();
+    master->queries_table->queries_by_socket = dictionary_create();
     master->queries_table->total_queries = 0;
     master->queries_table->next_query_id = -1; // Comienza en 0, se incrementa con cada nueva query
 
     // Crear e inicializar listas de estados (utilizando las commons)
-    master->queries_table->ready_queue = list_create();
+    master->queries_table->ready_queue = query_queue_create();
     master->queries_table->running_list = list_create();
+    master->queries_table->running_by_priority = query_queue_create();
     master->queries_table->completed_list = list_create();
     master->queries_table->canceled_list = list_create();
+    master->queries_table->file_tags_by_path = dictionary_create();
     pthread_mutex_init(&master->queries_table->query_table_mutex, NULL);
 
+    // El hilo de aging espera plazos absolutos del reloj monotónico (now_ms_monotonic)
+    pthread_condattr_t aging_cond_attr;
+    pthread_condattr_init(&aging_cond_attr);
+    pthread_condattr_setclock(&aging_cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&master->queries_table->aging_cond, &aging_cond_attr);
+    pthread_condattr_destroy(&aging_cond_attr);
+
     master->workers_table = malloc(sizeof(t_worker_table));
     if (master->workers_table == NULL) {
         log_error(logger, "No se pudo asignar memoria para la tabla de workers");
         goto error;
     }
     master->workers_table->worker_list = list_create();
+    master->workers_table->workers_by_id = dictionary_create();
+    master->workers_table->workers_by_socket = dictionary_create();
     master->workers_table->total_workers_connected = 0;
     master->workers_table->idle_list = list_create();
     master->workers_table->busy_list = list_create();
@@ -81,12 +96,29 @@ error:
     exit(EXIT_FAILURE);
 }
 
+static void destroy_file_tag_list(void *file_tags) {
+    list_destroy_and_destroy_elements(file_tags, free);
+}
+
 void destroy_master(t_master *master) {
     if (!master) return;
     
     // Guardar antes de liberar el string
     bool is_priority = master->scheduling_algorithm && 
                        (strcmp(master->scheduling_algorithm, "PRIORITY") == 0);
+
+    // join de thread (si estamos en priority), antes de liberar las tablas que usa
+    if (is_priority && master->queries_table) {
+        pthread_mutex_lock(&master->queries_table->query_table_mutex);
+        master->running = false;
+        pthread_cond_signal(&master->queries_table->aging_cond);
+        pthread_mutex_unlock(&master->queries_table->query_table_mutex);
+
+        pthread_join(master->aging_thread, NULL);
+        if (master->logger) {
+            log_info(master->logger, "Aging thread finalizado correctamente.");
+        }
+    }
     
     if (master->queries_table) {
         if (master->queries_table->query_list) {
@@ -101,22 +133,35 @@ void destroy_master(t_master *master) {
             }
             list_destroy(master->queries_table->query_list);
         }
+        if (master->queries_table->queries_by_id) {
+            dictionary_destroy(master->queries_table->queries_by_id);
+        }
+        if (master->queries_table->queries_by_socket) {
+            dictionary_destroy(master->queries_table->queries_by_socket);
+        }
         
         // Destruir cada lista solo si existe
         if (master->queries_table->ready_queue) {
-            list_destroy(master->queries_table->ready_queue);
+            query_queue_destroy(master->queries_table->ready_queue);
         }
         if (master->queries_table->running_list) {
             list_destroy(master->queries_table->running_list);
         }
+        if (master->queries_table->running_by_priority) {
+            query_queue_destroy(master->queries_table->running_by_priority);
+        }
         if (master->queries_table->completed_list) {
             list_destroy(master->queries_table->completed_list);
         }
         if (master->queries_table->canceled_list) {
             list_destroy(master->queries_table->canceled_list);
         }
+        if (master->queries_table->file_tags_by_path) {
+            dictionary_destroy_and_destroy_elements(master->queries_table->file_tags_by_path, destroy_file_tag_list);
+        }
         
         pthread_mutex_destroy(&master->queries_table->query_table_mutex);
+        pthread_cond_destroy(&master->queries_table->aging_cond);
         free(master->queries_table);
     }
     
@@ -125,14 +170,24 @@ void destroy_master(t_master *master) {
             while (!list_is_empty(master->workers_table->worker_list)) {
                 t_worker_control_block *wcb = list_remove(master->workers_table->worker_list, 0);
                 if (wcb) {
+                    worker_outbox_close(wcb->outbox);
                     if (wcb->ip_address) {
                         free(wcb->ip_address);
                     }
+                    if (wcb->resident_file_tags) {
+                        list_destroy_and_destroy_elements(wcb->resident_file_tags, free);
+                    }
                     free(wcb);
                 }
             }
             list_destroy(master->workers_table->worker_list);
         }
+        if (master->workers_table->workers_by_id) {
+            dictionary_destroy(master->workers_table->workers_by_id);
+        }
+        if (master->workers_table->workers_by_socket) {
+            dictionary_destroy(master->workers_table->workers_by_socket);
+        }
         
         // Destruir cada lista (solo si existe)
         if (master->workers_table->idle_list) {
@@ -154,14 +209,6 @@ void destroy_master(t_master *master) {
     if (master->port) free(master->port);
     if (master->scheduling_algorithm) free(master->scheduling_algorithm);
     
-    // join de thread (si estamos en priority)
-    if (is_priority) {
-        pthread_join(master->aging_thread, NULL);
-        if (master->logger) {
-            log_info(master->logger, "Aging thread finalizado correctamente.");
-        }
-    }
-    
     if (master->logger) log_destroy(master->logger);
     
     free(master);
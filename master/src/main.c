@@ -17,17 +17,12 @@
 #include <config/master_config.h>
 #include <aging.h>
 #include <disconnection_handler.h>
+#include <client_handler.h>
+#include <reactor.h>
 
 #define MODULO "MASTER"
 #define LOG_LEVEL LOG_LEVEL_DEBUG //inicialmente DEBUG, luego se setea desde el config
 
-void* handle_client(void* arg);
-
-typedef struct {
-    int client_socket;
-    t_master *master;
-} t_client_data;
-
 int main(int argc, char* argv[]) {
     // Verifico que se hayan pasado los parametros correctamente
     if (argc != 2) 
@@ -66,11 +61,14 @@ int main(int argc, char* argv[]) {
     // Seteo el nivel de logeo desde el config
     logger->detail = master_config->log_level;
 
-    log_debug(logger, "Configuracion leida: \n\tIP_ESCUCHA=%s\n\tPUERTO_ESCUCHA=%s\n\tALGORITMO_PLANIFICACION=%s\n\tTIEMPO_AGING=%d\n\tLOG_LEVEL=%s",
-             master_config->ip, master_config->port, master_config->scheduler_algorithm, master_config->aging_time, log_level_as_string(master_config->log_level));
+    log_debug(logger, "Configuracion leida: \n\tIP_ESCUCHA=%s\n\tPUERTO_ESCUCHA=%s\n\tALGORITMO_PLANIFICACION=%s\n\tTIEMPO_AGING=%d\n\tLOG_LEVEL=%s\n\tMODO_CONEXIONES=%s\n\tHILOS_REACTOR=%d",
+             master_config->ip, master_config->port, master_config->scheduler_algorithm, master_config->aging_time, log_level_as_string(master_config->log_level),
+             master_config->connection_mode, master_config->reactor_pool_size);
 
     // Inicializo la estructura principal del Master (tablas, datos de config, hilos, etc.)
     t_master *master = init_master(master_config->ip, master_config->port, master_config->aging_time, master_config->scheduler_algorithm, logger);
+    bool use_reactor = strcmp(master_config->connection_mode, CONNECTION_MODE_EPOLL) == 0;
+    int reactor_pool_size = master_config->reactor_pool_size;
     
     // Destruyo master_config
     destroy_master_config_instance(master_config);
@@ -96,6 +94,14 @@ int main(int argc, char* argv[]) {
 
     log_info(logger, "Socket %d creado con exito!", server_socket_fd);
 
+    // Modo reactor: un único hilo con epoll atiende todos los sockets
+    if (use_reactor)
+    {
+        run_reactor(master, server_socket_fd, reactor_pool_size);
+        log_error(logger, "No se pudo iniciar el reactor epoll");
+        goto clean;
+    }
+
     // Bucle principal para aceptar conexiones entrantes
     while (1) {
         struct sockaddr client_addr;
@@ -141,102 +147,3 @@ error:
 
     return 0;
 }
-
-void* handle_client(void* arg) {
-    t_client_data *client_data = (t_client_data*)arg;
-    int client_socket = client_data->client_socket;
-    t_master *master = client_data->master;
-
-    // flags para identificar tipo de cliente y manejar desconexiones
-    bool is_query_control = false, is_worker = false;
-
-    while (1) {
-        t_package *required_package = package_receive(client_socket);
-
-        if (required_package == NULL) {
-            log_debug(master->logger, "Error al recibir el paquete del cliente %d, se cierra conexión y libera socket.", client_socket);
-            
-            // Manejar desconexión según tipo de cliente identificado
-            if (is_query_control) {
-                handle_query_control_disconnection(client_socket, master);
-            } else if (is_worker) {
-                handle_worker_disconnection(client_socket, master);
-            } else {
-                // Cliente no identificado, solo cerrar socket
-                log_warning(master->logger, "Cliente no identificado en socket %d se desconectó", client_socket);
-                close(client_socket);
-            }
-            
-            break; // Sale del bucle y termina el hilo
-        }
-
-        switch (required_package->operation_code)
-        {
-            case OP_QUERY_HANDSHAKE:
-                log_debug(master->logger, "Recibido OP_QUERY_HANDSHAKE de socket %d", client_socket);
-                if (manage_query_handshake(client_socket, master->logger) == 0) {
-                    is_query_control = true;
-                    log_debug(master->logger, "Handshake completado con Query Control en socket %d", client_socket);
-                }       
-                break;
-            case OP_QUERY_FILE_PATH:
-                log_debug(master->logger, "Recibido OP_QUERY_FILE_PATH de socket %d", client_socket);
-                if (manage_query_file_path(required_package, client_socket, master) != 0) {
-                    log_error(master->logger, "Error al manejar OP_QUERY_FILE_PATH del cliente %d", client_socket);
-                }
-                break;
-            case QC_OP_DISCONNECTION:
-                log_info(master->logger, "Recibido QC_OP_DISCONNECTION de socket %d", client_socket);
-                handle_query_control_disconnection(client_socket, master);
-                break;
-                
-            // Worker
-            case OP_WORKER_HANDSHAKE_REQ:
-                log_debug(master->logger, "Recibido OP_WORKER_HANDSHAKE de socket %d", client_socket);
-                if (manage_worker_handshake(required_package->buffer, client_socket, master) == 0) {
-                    is_worker = true;
-                    log_debug(master->logger, "Handshake completado con worker en socket %d", client_socket);
-                }              
-                break;
-            case OP_WORKER_READ_MESSAGE_REQ:
-                log_debug(master->logger, "Recibido OP_WORKER_READ_MESSAGE de socket %d", client_socket);
-                if (manage_read_message_from_worker(required_package->buffer, client_socket, master) != 0) {
-                    log_error(master->logger, "Error al manejar OP_WORKER_READ_MESSAGE del cliente %d", client_socket);
-                }
-                break;
-            case OP_WORKER_END_QUERY:
-                log_debug(master->logger, "Recibido OP_WORKER_END_QUERY en socket %d", client_socket);
-                if (manage_worker_end_query(required_package->buffer, client_socket, master) != 0) {
-                    log_error(master->logger, "Error al manejar OP_WORKER_END_QUERY desde socket %d", client_socket);
-                }                
-                break;
-            case OP_WORKER_EVICT_RES:
-                log_debug(master->logger, "Recibido OP_WORKER_EVICT_RES en socket %d", client_socket);
-                manage_worker_evict_response(client_socket, required_package, master);
-                break;
-            case WORKER_OP_DISCONNECTION:
-                log_info(master->logger, "Recibido WORKER_OP_DISCONNECTION de socket %d", client_socket);
-                handle_worker_disconnection(client_socket, master);
-                break;
-            case STORAGE_OP_ERROR:
-                handle_error_from_storage(required_package, client_socket, master);
-                break;
-            default:
-                log_warning(master->logger, "Operacion desconocida recibida del cliente %d", client_socket);
-                break;
-        }
-        if(required_package)
-        {
-            package_destroy(required_package); // Libera el paquete recibido
-        }
-            
-    }
-
-    close(client_socket);
-    if(client_data)
-    {
-        free(client_data);
-    }
-        
-    return NULL;
-}
\ No newline at end of file
@@ -2,11 +2,13 @@
 #include "init_master.h"
 #include "query_control_manager.h"
 #include "scheduler.h"
+#include "query_queue.h"
 #include "connection/protocol.h"
 #include "connection/serialization.h"
 #include "commons/log.h"
 #include <time.h>
 #include <stdint.h>
+#include <stdio.h>
 
 // función auxiliar para manejar el aging
 uint64_t now_ms_monotonic() {
@@ -100,45 +102,100 @@ t_query_control_block *create_query(t_master *master, int query_id, char *query_
     qcb->preemption_pending = false; // No hay desalojo pendiente al inicio
     qcb->cleaned_up = false; // No se han liberado recursos aún
     qcb->ready_timestamp = now_ms_monotonic();
+    qcb->queue_prev = NULL;
+    qcb->queue_next = NULL;
+    qcb->queue_owner = NULL;
+    qcb->queue_key = 0;
+    qcb->aging_prev = NULL;
+    qcb->aging_next = NULL;
 
     // Agregamos a la lista principal y a la cola de ready (teniendo en cuenta planificador)
     list_add(master->queries_table->query_list, qcb);
 
-    if (strcmp(master->scheduling_algorithm, "PRIORITY") == 0) {
-        if(insert_query_by_priority(master->queries_table->ready_queue, qcb) != 0){
-            log_error(master->logger, "Error al intentar insertar query (query ID: %d) en Ready Queue.", query_id);
-       
-        }
-        log_debug(master->logger, "Query id %d agregada a la Ready QUEUE (PRIORITY)", qcb->query_id);
-    } else {
-        list_add(master->queries_table->ready_queue, qcb);
-        log_debug(master->logger, "Query id %d agregada a la Ready QUEUE (FIFO)", qcb->query_id);
+    char key[INDEX_KEY_SIZE];
+    index_key(key, qcb->query_id);
+    dictionary_put(master->queries_table->queries_by_id, key, qcb);
+    if (socket_fd >= 0) {
+        index_key(key, socket_fd);
+        dictionary_put(master->queries_table->queries_by_socket, key, qcb);
     }
 
+    if(enqueue_ready_query(master, qcb) != 0){
+        log_error(master->logger, "Error al intentar insertar query (query ID: %d) en Ready Queue.", query_id);
+    }
+    log_debug(master->logger, "Query id %d agregada a la Ready QUEUE (%s)", qcb->query_id, master->scheduling_algorithm);
+
     master->queries_table->total_queries++;
 
     pthread_mutex_unlock(&master->queries_table->query_table_mutex);
     return qcb;
 }
 
-int insert_query_by_priority(t_list *ready_queue, t_query_control_block *new_qcb) {
+int insert_query_by_priority(t_query_queue *ready_queue, t_query_control_block *new_qcb) {
     if (ready_queue == NULL || new_qcb == NULL) {
         return -1; // Error por parámetros inválidos
     }
 
-    for (int i = 0; i < list_size(ready_queue); i++) {
-        t_query_control_block *existing_qcb = list_get(ready_queue, i);
-        if (existing_qcb == NULL) {
-            return -1; // Error inesperado en la lista
-        }
+    // Detrás de las que tienen la misma prioridad, igual que la inserción ordenada
+    return query_queue_push(ready_queue, new_qcb, new_qcb->priority);
+}
+
+int enqueue_ready_query(t_master *master, t_query_control_block *qcb) {
+    t_query_queue *ready_queue = master->queries_table->ready_queue;
 
-        if (new_qcb->priority < existing_qcb->priority) {
-            list_add_in_index(ready_queue, i, new_qcb);
-            return 0; // Éxito
-        }
+    if (strcmp(master->scheduling_algorithm, "PRIORITY") != 0) {
+        return query_queue_push(ready_queue, qcb, 0);
+    }
+
+    if (insert_query_by_priority(ready_queue, qcb) != 0) {
+        return -1;
     }
-    // Si recorro la lista completa y todas las queries tienen mayor prioridad
-    list_add(ready_queue, new_qcb);
-    return 0; // Éxito
+    if (ready_queue->aging_head == qcb) {
+        pthread_cond_signal(&master->queries_table->aging_cond);
+    }
+    return 0;
+}
+
+void add_running_query(t_master *master, t_query_control_block *qcb) {
+    list_add(master->queries_table->running_list, qcb);
+    query_queue_push(master->queries_table->running_by_priority, qcb, qcb->priority);
 }
 
+bool remove_running_query(t_master *master, t_query_control_block *qcb) {
+    query_queue_remove(master->queries_table->running_by_priority, qcb);
+    return list_remove_element(master->queries_table->running_list, qcb);
+}
+
+void index_key(char key[INDEX_KEY_SIZE], int value) {
+    snprintf(key, INDEX_KEY_SIZE, "%d", value);
+}
+
+t_query_control_block *find_query_by_id(t_query_table *table, int query_id) {
+    if (!table || !table->queries_by_id) return NULL;
+
+    char key[INDEX_KEY_SIZE];
+    index_key(key, query_id);
+    return dictionary_get(table->queries_by_id, key);
+}
+
+t_query_control_block *find_running_query(t_query_table *table, int query_id) {
+    t_query_control_block *qcb = find_query_by_id(table, query_id);
+    if (!qcb || !query_queue_contains(table->running_by_priority, qcb)) {
+        return NULL;
+    }
+    return qcb;
+}
+
+void remove_query_from_indexes(t_query_table *table, t_query_control_block *qcb) {
+    char key[INDEX_KEY_SIZE];
+
+    index_key(key, qcb->query_id);
+    if (dictionary_get(table->queries_by_id, key) == qcb) {
+        dictionary_remove(table->queries_by_id, key);
+    }
+
+    index_key(key, qcb->socket_fd);
+    if (dictionary_get(table->queries_by_socket, key) == qcb) {
+        dictionary_remove(table->queries_by_socket, key);
+    }
+}
@@ -10,12 +10,14 @@
 #include <connection/serialization.h>
 #include <commons/log.h>
 #include <commons/collections/list.h>
+#include <commons/collections/dictionary.h>
 #include <pthread.h>
 #include <commons/log.h>
 
 // Forward declaration para evitar inclusiones circulares
 // Se utiliza un puntero a esta estructura en las funciones
 typedef struct master t_master;
+typedef struct query_queue t_query_queue;
 
 typedef enum {
     QUERY_STATE_NEW,
@@ -25,7 +27,7 @@ typedef enum {
     QUERY_STATE_CANCELED
 } t_query_state;
 
-typedef struct {
+typedef struct query_control_block {
     int socket_fd;
     int query_id;
     char *query_file_path;
@@ -37,22 +39,39 @@ typedef struct {
     bool preemption_pending; // Indica si está en proceso de ser desalojada
     bool cleaned_up;; // Indica si se han liberado los recursos asociados
     t_query_state state;
+
+    // Enlaces de la cola (READY o RUNNING) en la que está encolada, ver query_queue.h
+    struct query_control_block *queue_prev;
+    struct query_control_block *queue_next;
+    t_query_queue *queue_owner;
+    int queue_key;
+    // Enlaces de la lista de aging de la cola, ordenada por ready_timestamp
+    struct query_control_block *aging_prev;
+    struct query_control_block *aging_next;
 } t_query_control_block;
 
 typedef struct query_table {
     t_list *query_list; // Lista de t_query_control_block
+    t_dictionary *queries_by_id;     // query_id -> t_query_control_block
+    t_dictionary *queries_by_socket; // socket_fd del Query Control -> t_query_control_block
 
     // Manejo de estados
-    t_list *ready_queue;   // Cola de queries listas para ejecutar
+    t_query_queue *ready_queue;   // Cola de queries listas para ejecutar, ordenada por prioridad
     t_list *running_list; // Lista de queries en ejecución
+    t_query_queue *running_by_priority; // Las mismas queries de running_list, para encontrar la peor en O(1)
     t_list *completed_list; // Lista de queries completadas
     t_list *canceled_list; // Lista de queries canceladas
 
+    // Afinidad: path del script -> t_list de "FILE:TAG" que usó la última vez que corrió
+    t_dictionary *file_tags_by_path;
+
     int total_queries;
     int next_query_id; // ID para la próxima query que se agregue
 
     // Mutex para sincronización en cambio de estados
     pthread_mutex_t query_table_mutex;
+    // Despierta al hilo de aging cuando cambia la próxima query en envejecer (reloj monotónico)
+    pthread_cond_t aging_cond;
 } t_query_table;
 
 int manage_query_file_path(t_package *response_package, int client_socket, t_master *master);
@@ -92,17 +111,65 @@ t_query_control_block *create_query(t_master *master, int query_id, char *query_
 /**
  * @brief Inserta una query en la cola de ready respetando el orden por prioridad.
  *
- * Esta función recorre la cola de ready (`ready_queue`) y ubica la nueva query (`new_qcb`)
- * en la posición correspondiente según su prioridad. Las prioridades más bajas indican
- * mayor prioridad de ejecución. Si no hay ninguna query con menor prioridad, se agrega al final.
+ * La query se encola en el bucket de su prioridad, detrás de las que ya tienen
+ * la misma prioridad. Las prioridades más bajas indican mayor prioridad de ejecución.
  *
- * @param ready_queue Puntero a la lista de queries en estado READY.
+ * @param ready_queue Puntero a la cola de queries en estado READY.
  * @param new_qcb Puntero al bloque de control de la nueva query a insertar.
  * @return int Devuelve 0 en caso de éxito, o -1 si ocurre un error (por ejemplo, parámetros nulos).
  */
-int insert_query_by_priority(t_list *ready_queue, t_query_control_block *new_qcb);
+int insert_query_by_priority(t_query_queue *ready_queue, t_query_control_block *new_qcb);
+
+/**
+ * @brief Encola una query en READY según el algoritmo de planificación.
+ *
+ * En PRIORITY se ordena por prioridad; en FIFO todas comparten la misma clave.
+ * Si la query pasa a ser la próxima en envejecer, despierta al hilo de aging.
+ * Debe llamarse con query_table_mutex tomado.
+ */
+int enqueue_ready_query(t_master *master, t_query_control_block *qcb);
+
+/**
+ * @brief Pasa una query a RUNNING: la agrega a running_list y a running_by_priority.
+ *
+ * Debe llamarse con query_table_mutex tomado y la query fuera de la cola READY.
+ */
+void add_running_query(t_master *master, t_query_control_block *qcb);
+
+/**
+ * @brief Quita una query de RUNNING.
+ *
+ * @return true si la query estaba en running_list
+ */
+bool remove_running_query(t_master *master, t_query_control_block *qcb);
 
 
 uint64_t now_ms_monotonic();
 
+// Tamaño suficiente para cualquier int en decimal, usado como clave de los índices
+#define INDEX_KEY_SIZE 12
+
+/**
+ * @brief Escribe en key la clave de índice correspondiente a un id o socket.
+ */
+void index_key(char key[INDEX_KEY_SIZE], int value);
+
+/**
+ * @brief Busca una query por ID en O(1). Debe llamarse con query_table_mutex tomado.
+ */
+t_query_control_block *find_query_by_id(t_query_table *table, int query_id);
+
+/**
+ * @brief Busca una query en ejecución (presente en running_list) por ID.
+ */
+t_query_control_block *find_running_query(t_query_table *table, int query_id);
+
+/**
+ * @brief Quita la query de los índices por ID y por socket.
+ *
+ * Sólo borra las entradas que todavía apuntan a esta query: si el socket ya fue
+ * reutilizado por otro Query Control, su entrada se conserva.
+ */
+void remove_query_from_indexes(t_query_table *table, t_query_control_block *qcb);
+
 #endif // QUERY_CONTROL_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include <stdlib.h>
+
+#include "query_queue.h"
+
+static int clamp_key(int key) {
+    if (key < 0) return 0;
+    if (key >= QUERY_QUEUE_PRIORITIES) return QUERY_QUEUE_PRIORITIES - 1;
+    return key;
+}
+
+static void bitmap_set(t_query_queue *queue, int key) {
+    queue->bitmap[key / 64] |= (1ULL << (key % 64));
+}
+
+static void bitmap_clear(t_query_queue *queue, int key) {
+    queue->bitmap[key / 64] &= ~(1ULL << (key % 64));
+}
+
+static int bitmap_lowest(t_query_queue *queue) {
+    for (int word = 0; word < QUERY_QUEUE_BITMAP_WORDS; word++) {
+        if (queue->bitmap[word] != 0) {
+            return word * 64 + __builtin_ctzll(queue->bitmap[word]);
+        }
+    }
+    return -1;
+}
+
+static int bitmap_highest(t_query_queue *queue) {
+    for (int word = QUERY_QUEUE_BITMAP_WORDS - 1; word >= 0; word--) {
+        if (queue->bitmap[word] != 0) {
+            return word * 64 + 63 - __builtin_clzll(queue->bitmap[word]);
+        }
+    }
+    return -1;
+}
+
+// Inserta desde el final: una query recién encolada casi siempre es la más nueva
+static void aging_link(t_query_queue *queue, t_query_control_block *qcb) {
+    t_query_control_block *prev = queue->aging_tail;
+    while (prev != NULL && prev->ready_timestamp > qcb->ready_timestamp) {
+        prev = prev->aging_prev;
+    }
+
+    qcb->aging_prev = prev;
+    qcb->aging_next = prev != NULL ? prev->aging_next : queue->aging_head;
+    if (qcb->aging_next != NULL) {
+        qcb->aging_next->aging_prev = qcb;
+    } else {
+        queue->aging_tail = qcb;
+    }
+    if (prev != NULL) {
+        prev->aging_next = qcb;
+    } else {
+        queue->aging_head = qcb;
+    }
+}
+
+static void aging_unlink(t_query_queue *queue, t_query_control_block *qcb) {
+    if (qcb->aging_prev != NULL) {
+        qcb->aging_prev->aging_next = qcb->aging_next;
+    } else if (queue->aging_head == qcb) {
+        queue->aging_head = qcb->aging_next;
+    } else {
+        return; // No estaba en la lista (clave 0)
+    }
+    if (qcb->aging_next != NULL) {
+        qcb->aging_next->aging_prev = qcb->aging_prev;
+    } else {
+        queue->aging_tail = qcb->aging_prev;
+    }
+    qcb->aging_prev = NULL;
+    qcb->aging_next = NULL;
+}
+
+t_query_queue *query_queue_create(void) {
+    return calloc(1, sizeof(t_query_queue));
+}
+
+void query_queue_destroy(t_query_queue *queue) {
+    // Igual que list_destroy: las queries pueden haberse liberado antes desde query_list
+    free(queue);
+}
+
+int query_queue_push(t_query_queue *queue, t_query_control_block *qcb, int key) {
+    if (queue == NULL || qcb == NULL || qcb->queue_owner != NULL) {
+        return -1;
+    }
+
+    key = clamp_key(key);
+    qcb->queue_owner = queue;
+    qcb->queue_key = key;
+    qcb->queue_next = NULL;
+    qcb->queue_prev = queue->tails[key];
+
+    if (queue->tails[key] != NULL) {
+        queue->tails[key]->queue_next = qcb;
+    } else {
+        queue->heads[key] = qcb;
+        bitmap_set(queue, key);
+    }
+    queue->tails[key] = qcb;
+    queue->size++;
+
+    qcb->aging_prev = NULL;
+    qcb->aging_next = NULL;
+    if (key > 0) {
+        aging_link(queue, qcb);
+    }
+    return 0;
+}
+
+bool query_queue_remove(t_query_queue *queue, t_query_control_block *qcb) {
+    if (!query_queue_contains(queue, qcb)) {
+        return false;
+    }
+
+    int key = qcb->queue_key;
+    if (qcb->queue_prev != NULL) {
+        qcb->queue_prev->queue_next = qcb->queue_next;
+    } else {
+        queue->heads[key] = qcb->queue_next;
+    }
+    if (qcb->queue_next != NULL) {
+        qcb->queue_next->queue_prev = qcb->queue_prev;
+    } else {
+        queue->tails[key] = qcb->queue_prev;
+    }
+    if (queue->heads[key] == NULL) {
+        bitmap_clear(queue, key);
+    }
+    aging_unlink(queue, qcb);
+
+    qcb->queue_owner = NULL;
+    qcb->queue_prev = NULL;
+    qcb->queue_next = NULL;
+    queue->size--;
+    return true;
+}
+
+int query_queue_update(t_query_queue *queue, t_query_control_block *qcb, int key) {
+    if (!query_queue_remove(queue, qcb)) {
+        return -1;
+    }
+    return query_queue_push(queue, qcb, key);
+}
+
+t_query_control_block *query_queue_peek_min(t_query_queue *queue) {
+    if (queue == NULL) return NULL;
+    int key = bitmap_lowest(queue);
+    return key < 0 ? NULL : queue->heads[key];
+}
+
+t_query_control_block *query_queue_peek_max(t_query_queue *queue) {
+    if (queue == NULL) return NULL;
+    int key = bitmap_highest(queue);
+    return key < 0 ? NULL : queue->heads[key];
+}
+
+t_query_control_block *query_queue_pop_min(t_query_queue *queue) {
+    t_query_control_block *qcb = query_queue_peek_min(queue);
+    if (qcb != NULL) {
+        query_queue_remove(queue, qcb);
+    }
+    return qcb;
+}
+
+bool query_queue_contains(t_query_queue *queue, t_query_control_block *qcb) {
+    return queue != NULL && qcb != NULL && qcb->queue_owner == queue;
+}
+
+bool query_queue_is_empty(t_query_queue *queue) {
+    return queue == NULL || queue->size == 0;
+}
+
+int query_queue_size(t_query_queue *queue) {
+    return queue == NULL ? 0 : queue->size;
+}
+
+t_query_control_block *query_queue_get(t_query_queue *queue, int index) {
+    if (queue == NULL || index < 0 || index >= queue->size) {
+        return NULL;
+    }
+
+    for (int key = 0; key < QUERY_QUEUE_PRIORITIES; key++) {
+        for (t_query_control_block *qcb = queue->heads[key]; qcb != NULL; qcb = qcb->queue_next) {
+            if (index-- == 0) {
+                return qcb;
+            }
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file query_queue.h
+ * @brief Cola de queries por prioridad con buckets
+ *
+ * Las prioridades llegan como uint8, por lo que alcanza con un bucket FIFO por
+ * cada valor posible y un bitmap que indica qué buckets tienen queries. Los
+ * enlaces viven dentro del QCB (una query está a lo sumo en una cola a la vez),
+ * así que insertar, quitar una query cualquiera y cambiarle la prioridad es
+ * O(1), y buscar la mejor o la peor es O(QUERY_QUEUE_PRIORITIES / 64).
+ *
+ * Se usa para READY (la mejor query es la de menor prioridad) y para RUNNING
+ * (la peor, candidata a desalojo, es la de mayor prioridad). En FIFO todas las
+ * queries se encolan con la misma clave y la cola se comporta como una lista.
+ *
+ * Además, las queries con clave mayor a 0 (las que todavía pueden envejecer)
+ * se mantienen en una lista ordenada por ready_timestamp. Como el intervalo de
+ * aging es el mismo para todas, la primera de esa lista es siempre la próxima
+ * en cambiar de prioridad y el hilo de aging puede dormir hasta ese momento.
+ */
+
+#ifndef QUERY_QUEUE_H
+#define QUERY_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "query_control_manager.h"
+
+#define QUERY_QUEUE_PRIORITIES 256
+#define QUERY_QUEUE_BITMAP_WORDS (QUERY_QUEUE_PRIORITIES / 64)
+
+typedef struct query_queue {
+    t_query_control_block *heads[QUERY_QUEUE_PRIORITIES];
+    t_query_control_block *tails[QUERY_QUEUE_PRIORITIES];
+    uint64_t bitmap[QUERY_QUEUE_BITMAP_WORDS]; // Bit encendido: bucket con queries
+    int size;
+
+    // Queries con clave > 0, de menor a mayor ready_timestamp
+    t_query_control_block *aging_head;
+    t_query_control_block *aging_tail;
+} t_query_queue;
+
+t_query_queue *query_queue_create(void);
+
+/**
+ * @brief Libera la cola. No libera ni modifica las queries que contiene.
+ */
+void query_queue_destroy(t_query_queue *queue);
+
+/**
+ * @brief Agrega la query al final del bucket de la clave indicada.
+ *
+ * La clave se acota al rango [0, QUERY_QUEUE_PRIORITIES).
+ * @return 0 en éxito, -1 si la query ya está en alguna cola o los parámetros son inválidos
+ */
+int query_queue_push(t_query_queue *queue, t_query_control_block *qcb, int key);
+
+/**
+ * @brief Quita la query de la cola.
+ *
+ * @return true si la query estaba en esta cola
+ */
+bool query_queue_remove(t_query_queue *queue, t_query_control_block *qcb);
+
+/**
+ * @brief Cambia la clave de una query encolada; queda al final de su nuevo bucket.
+ *
+ * También la reubica en la lista de aging según su ready_timestamp actual.
+ */
+int query_queue_update(t_query_queue *queue, t_query_control_block *qcb, int key);
+
+// Primera query de la menor clave, o NULL si la cola está vacía
+t_query_control_block *query_queue_peek_min(t_query_queue *queue);
+
+// Primera query de la mayor clave, o NULL si la cola está vacía
+t_query_control_block *query_queue_peek_max(t_query_queue *queue);
+
+t_query_control_block *query_queue_pop_min(t_query_queue *queue);
+
+bool query_queue_contains(t_query_queue *queue, t_query_control_block *qcb);
+bool query_queue_is_empty(t_query_queue *queue);
+int query_queue_size(t_query_queue *queue);
+
+/**
+ * @brief Devuelve la query en la posición indicada, recorriendo la cola en orden.
+ *
+ * Es O(n): pensada para logs y tests, no para el camino de planificación.
+ */
+t_query_control_block *query_queue_get(t_query_queue *queue, int index);
+
+#endif // QUERY_QUEUE_H
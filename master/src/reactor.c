@@ -0,0 +1,312 @@
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <commons/collections/list.h>
+
+#include "reactor.h"
+#include "client_handler.h"
+
+#define FRAME_HEADER_SIZE (sizeof(uint8_t) + sizeof(uint32_t))
+
+typedef struct {
+    int socket_fd;
+    t_client_role role;
+
+    // Paquete que se está armando
+    uint8_t header[FRAME_HEADER_SIZE];
+    size_t header_received;
+    t_package *partial;        // NULL mientras no se completó el header
+    size_t body_received;
+
+    t_list *pending;           // t_package completos, en orden de llegada
+    bool peer_closed;          // El cliente cerró o la lectura falló
+} t_reactor_connection;
+
+typedef struct {
+    t_master *master;
+    int epoll_fd;
+
+    // Conexiones con paquetes listos para despachar
+    t_list *ready;
+    pthread_mutex_t ready_mutex;
+    pthread_cond_t ready_cond;
+} t_reactor;
+
+static t_reactor_connection *connection_create(int socket_fd) {
+    t_reactor_connection *connection = calloc(1, sizeof(t_reactor_connection));
+    if (connection == NULL) {
+        return NULL;
+    }
+    connection->socket_fd = socket_fd;
+    connection->pending = list_create();
+    return connection;
+}
+
+static void connection_destroy(t_reactor_connection *connection) {
+    if (connection->partial) {
+        package_destroy(connection->partial);
+    }
+    list_destroy_and_destroy_elements(connection->pending, (void *)package_destroy);
+    free(connection);
+}
+
+static int connection_arm(t_reactor *reactor, t_reactor_connection *connection, int operation) {
+    struct epoll_event event = {
+        .events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT,
+        .data.ptr = connection
+    };
+    return epoll_ctl(reactor->epoll_fd, operation, connection->socket_fd, &event);
+}
+
+/**
+ * Consume los bytes leídos y agrega a pending los paquetes que se completan.
+ * Retorna -1 si el header indica un tamaño inválido.
+ */
+static int connection_feed(t_reactor_connection *connection, const uint8_t *data, size_t size) {
+    while (size > 0) {
+        if (connection->partial == NULL) {
+            size_t missing = FRAME_HEADER_SIZE - connection->header_received;
+            size_t chunk = size < missing ? size : missing;
+            memcpy(connection->header + connection->header_received, data, chunk);
+            connection->header_received += chunk;
+            data += chunk;
+            size -= chunk;
+
+            if (connection->header_received < FRAME_HEADER_SIZE) {
+                return 0;
+            }
+
+            uint32_t network_size;
+            memcpy(&network_size, connection->header + sizeof(uint8_t), sizeof(uint32_t));
+            uint32_t body_size = ntohl(network_size);
+            if (body_size > MAX_BUFFER_SIZE) {
+                return -1;
+            }
+
+            connection->partial = package_create(connection->header[0], buffer_create_pooled(body_size));
+            if (connection->partial == NULL) {
+                return -1;
+            }
+            connection->header_received = 0;
+            connection->body_received = 0;
+        }
+
+        t_buffer *body = connection->partial->buffer;
+        size_t missing = body->size - connection->body_received;
+        size_t chunk = size < missing ? size : missing;
+        memcpy((uint8_t *)body->stream + connection->body_received, data, chunk);
+        connection->body_received += chunk;
+        data += chunk;
+        size -= chunk;
+
+        if (connection->body_received == body->size) {
+            list_add(connection->pending, connection->partial);
+            connection->partial = NULL;
+        }
+    }
+    return 0;
+}
+
+// Lee todo lo disponible en el socket sin bloquear
+static void connection_read(t_reactor_connection *connection, t_log *logger) {
+    uint8_t chunk[REACTOR_READ_CHUNK];
+
+    while (1) {
+        ssize_t received = recv(connection->socket_fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (received > 0) {
+            if (connection_feed(connection, chunk, (size_t)received) != 0) {
+                log_error(logger, "Paquete inválido recibido del cliente %d", connection->socket_fd);
+                connection->peer_closed = true;
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        connection->peer_closed = true;
+        return;
+    }
+}
+
+static void reactor_enqueue(t_reactor *reactor, t_reactor_connection *connection) {
+    pthread_mutex_lock(&reactor->ready_mutex);
+    list_add(reactor->ready, connection);
+    pthread_cond_signal(&reactor->ready_cond);
+    pthread_mutex_unlock(&reactor->ready_mutex);
+}
+
+static void reactor_unregister(t_reactor *reactor, t_reactor_connection *connection) {
+    // Se quita de epoll antes de que el manejador cierre el socket, para no
+    // tocar un descriptor que ya pudo ser reutilizado por otra conexión
+    epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, connection->socket_fd, NULL);
+}
+
+// Despacha en orden los paquetes de una conexión. Retorna false si la conexión terminó.
+static bool reactor_process_connection(t_reactor *reactor, t_reactor_connection *connection) {
+    t_master *master = reactor->master;
+
+    while (!list_is_empty(connection->pending)) {
+        t_package *package = list_remove(connection->pending, 0);
+
+        if (is_disconnection_package(package)) {
+            reactor_unregister(reactor, connection);
+            dispatch_client_package(package, connection->socket_fd, &connection->role, master);
+            package_destroy(package);
+            return false;
+        }
+
+        dispatch_client_package(package, connection->socket_fd, &connection->role, master);
+        package_destroy(package);
+    }
+
+    if (connection->peer_closed) {
+        log_debug(master->logger, "Error al recibir el paquete del cliente %d, se cierra conexión y libera socket.", connection->socket_fd);
+        reactor_unregister(reactor, connection);
+        handle_client_disconnection(connection->socket_fd, &connection->role, master);
+        return false;
+    }
+
+    return true;
+}
+
+static void *reactor_worker_thread(void *arg) {
+    t_reactor *reactor = (t_reactor *)arg;
+
+    while (1) {
+        pthread_mutex_lock(&reactor->ready_mutex);
+        while (list_is_empty(reactor->ready)) {
+            pthread_cond_wait(&reactor->ready_cond, &reactor->ready_mutex);
+        }
+        t_reactor_connection *connection = list_remove(reactor->ready, 0);
+        pthread_mutex_unlock(&reactor->ready_mutex);
+
+        if (!reactor_process_connection(reactor, connection)) {
+            connection_destroy(connection);
+            continue;
+        }
+
+        // Recién ahora el reactor puede volver a leer de este cliente
+        if (connection_arm(reactor, connection, EPOLL_CTL_MOD) != 0) {
+            log_error(reactor->master->logger, "Error al rearmar el socket %d en epoll", connection->socket_fd);
+            connection->peer_closed = true;
+            reactor_enqueue(reactor, connection);
+        }
+    }
+
+    return NULL;
+}
+
+static void reactor_accept(t_reactor *reactor, int server_socket_fd) {
+    t_log *logger = reactor->master->logger;
+
+    int client_socket_fd = accept(server_socket_fd, NULL, NULL);
+    if (client_socket_fd < 0) {
+        log_error(logger, "Error al aceptar conexion del cliente");
+        return;
+    }
+
+    log_debug(logger, "Cliente conectado en socket %d", client_socket_fd);
+
+    t_reactor_connection *connection = connection_create(client_socket_fd);
+    if (connection == NULL) {
+        log_error(logger, "Error al asignar memoria para datos del cliente");
+        close(client_socket_fd);
+        return;
+    }
+
+    if (connection_arm(reactor, connection, EPOLL_CTL_ADD) != 0) {
+        log_error(logger, "Error al registrar el socket %d en epoll", client_socket_fd);
+        close(client_socket_fd);
+        connection_destroy(connection);
+    }
+}
+
+int run_reactor(t_master *master, int server_socket_fd, int pool_size) {
+    t_reactor reactor = { .master = master };
+
+    reactor.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor.epoll_fd < 0) {
+        log_error(master->logger, "Error al crear la instancia de epoll");
+        return -1;
+    }
+
+    reactor.ready = list_create();
+    pthread_mutex_init(&reactor.ready_mutex, NULL);
+    pthread_cond_init(&reactor.ready_cond, NULL);
+
+    // El socket de escucha se identifica con data.ptr == NULL
+    struct epoll_event server_event = { .events = EPOLLIN, .data.ptr = NULL };
+    if (epoll_ctl(reactor.epoll_fd, EPOLL_CTL_ADD, server_socket_fd, &server_event) != 0) {
+        log_error(master->logger, "Error al registrar el socket de escucha en epoll");
+        goto error;
+    }
+
+    int started = 0;
+    for (int i = 0; i < pool_size; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, reactor_worker_thread, &reactor) != 0) {
+            log_error(master->logger, "Error al crear hilo %d del pool del reactor", i);
+            continue;
+        }
+        pthread_detach(thread);
+        started++;
+    }
+    if (started == 0) {
+        goto error;
+    }
+
+    log_info(master->logger, "Reactor epoll iniciado con %d hilos de despacho", started);
+
+    struct epoll_event events[REACTOR_MAX_EVENTS];
+    while (1) {
+        int count = epoll_wait(reactor.epoll_fd, events, REACTOR_MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log_error(master->logger, "Error en epoll_wait: %s", strerror(errno));
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            t_reactor_connection *connection = events[i].data.ptr;
+            if (connection == NULL) {
+                reactor_accept(&reactor, server_socket_fd);
+                continue;
+            }
+
+            // EPOLLONESHOT: hasta que se rearme, sólo este hilo toca la conexión
+            connection_read(connection, master->logger);
+            if ((events[i].events & (EPOLLHUP | EPOLLERR)) != 0) {
+                connection->peer_closed = true;
+            }
+
+            if (!list_is_empty(connection->pending) || connection->peer_closed) {
+                reactor_enqueue(&reactor, connection);
+                continue;
+            }
+
+            // Paquete incompleto: se sigue esperando el resto
+            if (connection_arm(&reactor, connection, EPOLL_CTL_MOD) != 0) {
+                connection->peer_closed = true;
+                reactor_enqueue(&reactor, connection);
+            }
+        }
+    }
+
+error:
+    // Sólo se llega acá si no arrancó ningún hilo del pool
+    close(reactor.epoll_fd);
+    list_destroy(reactor.ready);
+    pthread_mutex_destroy(&reactor.ready_mutex);
+    pthread_cond_destroy(&reactor.ready_cond);
+    return -1;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file reactor.h
+ * @brief Modo de conexiones basado en epoll (MODO_CONEXIONES=EPOLL)
+ *
+ * Un único hilo es dueño de todos los sockets: acepta conexiones, lee con
+ * recv no bloqueante y arma los paquetes a medida que llegan los bytes.
+ * Los paquetes completos se despachan a los manejadores existentes desde un
+ * pool fijo de hilos. Cada socket se registra con EPOLLONESHOT, por lo que
+ * nunca hay dos hilos atendiendo al mismo cliente y los paquetes de un
+ * cliente se procesan en el orden en que llegaron.
+ *
+ * Los sockets siguen siendo bloqueantes para las escrituras: los manejadores
+ * envían sus respuestas con package_send igual que en el modo HILOS.
+ */
+
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include "init_master.h"
+
+#define REACTOR_MAX_EVENTS 64
+#define REACTOR_READ_CHUNK 4096
+
+/**
+ * @brief Ejecuta el bucle de eventos sobre el socket de escucha.
+ *
+ * Sólo retorna si falla la inicialización de epoll o del pool de hilos.
+ *
+ * @param master Estructura principal del Master
+ * @param server_socket_fd Socket de escucha ya creado con start_server
+ * @param pool_size Cantidad de hilos que despachan paquetes (mayor a 0)
+ * @return -1 si no se pudo iniciar el reactor
+ */
+int run_reactor(t_master *master, int server_socket_fd, int pool_size);
+
+#endif // REACTOR_H
@@ -4,14 +4,109 @@
 #include "init_master.h"
 #include "worker_manager.h"
 #include "query_control_manager.h"
+#include "query_queue.h"
+#include "aging.h"
 
 int try_dispatch(t_master *master) {
+    return try_dispatch_batch(master, NULL);
+}
+
+/*
+ * Elige el worker IDLE para la query: el que más "FILE:TAG" del script tiene en
+ * memoria según su último resumen, para reusar páginas en vez de volver a pedirlas
+ * a Storage. Sin información de afinidad (o sin coincidencias) toma el primero.
+ * Se llama con ambas tablas bloqueadas; quita al worker elegido de idle_list.
+ */
+static t_worker_control_block *take_idle_worker_for(t_master *master, t_query_control_block *query) {
+    t_list *idle = master->workers_table->idle_list;
+    t_dictionary *by_path = master->queries_table->file_tags_by_path;
+    t_list *wanted = (by_path && query->query_file_path) ? dictionary_get(by_path, query->query_file_path) : NULL;
+
+    int best_index = 0;
+    int best_score = 0;
+    for (int i = 0; wanted != NULL && i < list_size(idle); i++) {
+        int score = worker_affinity_score(list_get(idle, i), wanted);
+        if (score > best_score) {
+            best_score = score;
+            best_index = i;
+        }
+    }
+
+    if (best_score > 0) {
+        log_debug(master->logger, "[try_dispatch] Query ID=%d: worker elegido por afinidad (%d File:Tag en memoria)",
+                  query->query_id, best_score);
+    }
+    return list_remove(idle, best_index);
+}
+
+// Asigna una query READY a un worker IDLE. Se llama con ambas tablas bloqueadas
+static int dispatch_one(t_master *master, t_query_control_block *query, t_worker_control_block *worker) {
+    // Actualizar estados
+    worker->current_query_id = query->query_id;
+    worker->state = WORKER_STATE_BUSY;
+    query->state = QUERY_STATE_RUNNING;
+    query->assigned_worker_id = worker->worker_id;
+    query->preemption_pending = false; 
+
+    // Mover a las listas activas
+    add_running_query(master, query);
+    list_add(master->workers_table->busy_list, worker);
+
+    log_debug(master->logger,
+        "[try_dispatch] Asignada Query ID=%d al Worker ID=%d",
+        query->query_id, worker->worker_id);
+
+    // Encolar el inicio de la query; el envío por red se hace fuera de los mutex
+    if (send_query_to_worker(master, worker, query) == 0) {
+        return 0;
+    }
+
+    log_error(master->logger, "[try_dispatch] Error al enviar inicio de query al Worker ID=%d para Query ID=%d",
+              worker->worker_id, query->query_id);
+
+    // Revertir cambios en caso de error
+    worker->current_query_id = -1;
+    worker->state = WORKER_STATE_IDLE;
+    query->state = QUERY_STATE_READY;
+    query->assigned_worker_id = -1;
+
+    if (!remove_running_query(master, query)) {
+        log_warning(master->logger, "[try_dispatch] Query ID=%d no estaba en running_list al revertir.",
+                    query->query_id);
+    }
+
+    if (!list_remove_element(master->workers_table->busy_list, worker)) {
+        log_warning(master->logger, "[try_dispatch] Worker ID=%d no estaba en busy_list al revertir.",
+                    worker->worker_id);
+    }
+
+    // La query vuelve a READY. El worker sólo vuelve a IDLE si su cola sigue aceptando envíos:
+    // si falló, su socket ya está cerrado y la desconexión lo saca de las tablas
+    enqueue_ready_query(master, query);
+
+    if (worker_outbox_failed(worker->outbox)) {
+        log_warning(master->logger, "[try_dispatch] Worker ID=%d no acepta envíos, queda fuera de IDLE hasta su desconexión.",
+                    worker->worker_id);
+    } else {
+        list_add(master->workers_table->idle_list, worker);
+    }
+
+    log_debug(master->logger, "[try_dispatch] Revertidos cambios tras error en envío de query.");
+    return -1;
+}
+
+int try_dispatch_batch(t_master *master, int *dispatched) {
+    if (dispatched != NULL) {
+        *dispatched = 0;
+    }
+
     if (master == NULL || master->workers_table == NULL || master->queries_table == NULL) {
         log_error(master ? master->logger : NULL, "[try_dispatch] Estructura master inválida o no inicializada.");
         return -1;
     }
 
     int result = 0;
+    int count = 0;
 
     // Bloqueo ordenado: primero workers, luego queries
     if (pthread_mutex_lock(&master->workers_table->worker_table_mutex) != 0) {
@@ -38,7 +133,7 @@ int try_dispatch(t_master *master) {
         goto unlock_and_exit;
     }
 
-    if (list_is_empty(master->queries_table->ready_queue)) {
+    if (query_queue_is_empty(master->queries_table->ready_queue)) {
         log_debug(master->logger, "[try_dispatch] No hay queries READY para despachar.");
         goto unlock_and_exit;
     }
@@ -62,70 +157,44 @@ int try_dispatch(t_master *master) {
         goto unlock_and_exit;
     }
 
-    // FIFO: tomar el primero de cada lista
-    t_query_control_block *query = list_remove(master->queries_table->ready_queue, 0);
-    t_worker_control_block *worker = list_remove(master->workers_table->idle_list, 0);
-
-    if (query == NULL || worker == NULL) {
-        log_error(master->logger, "[try_dispatch] Error inesperado: query o worker NULL al remover de las listas.");
-        result = -1;
-        goto unlock_and_exit;
-    }
-
-    // Actualizar estados
-    worker->current_query_id = query->query_id;
-    worker->state = WORKER_STATE_BUSY;
-    query->state = QUERY_STATE_RUNNING;
-    query->assigned_worker_id = worker->worker_id;
-    query->preemption_pending = false; 
-
-    // Mover a las listas activas
-    list_add(master->queries_table->running_list, query);
-    list_add(master->workers_table->busy_list, worker);
-
-    log_debug(master->logger,
-        "[try_dispatch] Asignada Query ID=%d al Worker ID=%d",
-        query->query_id, worker->worker_id);
-
-    // Enviar mensaje al worker para iniciar la ejecución de la query
-    if (send_query_to_worker(master, worker, query) != 0) {
-        log_error(master->logger, "[try_dispatch] Error al enviar inicio de query al Worker ID=%d para Query ID=%d",
-                  worker->worker_id, query->query_id);
-
-        // Revertir cambios en caso de error
-        worker->current_query_id = -1;
-        worker->state = WORKER_STATE_IDLE;
-        query->state = QUERY_STATE_READY;
-        query->assigned_worker_id = -1;
-
-        if (!list_remove_element(master->queries_table->running_list, query)) {
-            log_warning(master->logger, "[try_dispatch] Query ID=%d no estaba en running_list al revertir.",
-                        query->query_id);
+    // Emparejar en una sola pasada todas las queries READY que se pueda con los workers IDLE:
+    // la mejor query READY (en FIFO, la primera en llegar) con el worker libre más afín
+    while (!list_is_empty(master->workers_table->idle_list) &&
+           !query_queue_is_empty(master->queries_table->ready_queue)) {
+        t_query_control_block *query = query_queue_pop_min(master->queries_table->ready_queue);
+        t_worker_control_block *worker = take_idle_worker_for(master, query);
+
+        if (query == NULL || worker == NULL) {
+            log_error(master->logger, "[try_dispatch] Error inesperado: query o worker NULL al remover de las listas.");
+            result = -1;
+            goto unlock_and_exit;
         }
 
-        if (!list_remove_element(master->workers_table->busy_list, worker)) {
-            log_warning(master->logger, "[try_dispatch] Worker ID=%d no estaba en busy_list al revertir.",
-                        worker->worker_id);
+        // Si falla el envío la query vuelve a READY: se corta la pasada para no reintentarla
+        if (dispatch_one(master, query, worker) != 0) {
+            result = -1;
+            goto unlock_and_exit;
         }
-
-        // Volver a colocarlos en sus listas originales
-        if (strcmp(master->scheduling_algorithm, "PRIORITY") == 0) {
-            insert_query_by_priority(master->queries_table->ready_queue, query);
-        } else {
-            list_add(master->queries_table->ready_queue, query);
-        }
-
-        list_add(master->workers_table->idle_list, worker);
-
-        log_debug(master->logger, "[try_dispatch] Revertidos cambios tras error en envío de query.");
-
-        result = -1;
-        goto unlock_and_exit;
+        count++;
     }
 
 unlock_and_exit:
     pthread_mutex_unlock(&master->queries_table->query_table_mutex);
     pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
+
+    // Los hilos de salida de cada worker envían los inicios en paralelo, ya sin los mutex
+    if (count > 0) {
+        log_debug(master->logger, "[try_dispatch] Queries despachadas en esta pasada: %d", count);
+    }
+    if (dispatched != NULL) {
+        *dispatched = count;
+    }
+
+    // En PRIORITY, la query que llegó o volvió a READY puede desalojar a la peor en ejecución.
+    // El hilo de aging sólo lo verifica cuando cambia alguna prioridad
+    if (strcmp(master->scheduling_algorithm, "PRIORITY") == 0) {
+        check_preemption(master);
+    }
     return result;
 }
 
@@ -179,8 +248,8 @@ int send_query_to_worker(t_master *master, t_worker_control_block *worker, t_que
         return -1;
     }
 
-    // Enviar paquete al worker
-    if (package_send(package_send_query, worker->socket_fd) != 0) {
+    // Encolar paquete para el worker (la cola pasa a ser dueña del paquete)
+    if (worker_outbox_push(worker->outbox, package_send_query) != 0) {
         log_error(master->logger, "[send_query_to_worker] Error al enviar paquete de Query ID=%d al Worker ID=%d.",
                   query->query_id, worker->worker_id);
         package_destroy(package_send_query);
@@ -190,8 +259,5 @@ int send_query_to_worker(t_master *master, t_worker_control_block *worker, t_que
     // Log de éxito
     log_info(master->logger, "## Se envía la Query id: %d (prioridad: %d) al Worker id: %d",
              query->query_id, query->priority, worker->worker_id);
-
-    // Liberar memoria
-    package_destroy(package_send_query);
     return 0;
 }
@@ -5,12 +5,25 @@
 #include "query_control_manager.h"
 
 /**
- * Intenta despachar una query READY a un worker IDLE.
+ * Despacha queries READY a workers IDLE.
+ * En una misma pasada (con los mutex tomados una sola vez) asigna tantos pares
+ * READY->IDLE como haya disponibles.
  * Retorna 0 si se despachó correctamente, -1 en caso de error.
  * Si no hay workers IDLE o queries READY, retorna 0 sin hacer nada.
  */
 int try_dispatch(t_master* master);
 
+/**
+ * Igual que try_dispatch, e informa en dispatched (si no es NULL) cuántas
+ * queries se asignaron en la pasada, aun si la pasada termina con error.
+ */
+int try_dispatch_batch(t_master* master, int *dispatched);
+
+/**
+ * Encola en la cola de salida del worker el pedido de inicio de la query.
+ * Se llama con las tablas bloqueadas: no espera a que el paquete salga por la red.
+ * Retorna -1 si no se pudo armar el paquete o la cola del worker ya no acepta envíos.
+ */
 int send_query_to_worker(t_master *master, t_worker_control_block *worker, t_query_control_block *query);
 
 #endif // SCHEDULER_H
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "scheduler.h"
 #include <commons/collections/list.h>
 #include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
 #include "disconnection_handler.h"
 
 
@@ -82,15 +84,12 @@ int manage_read_message_from_worker(t_buffer *buffer, int client_socket, t_maste
 
     log_debug(master->logger, "Recibido lectura desde worker id: %d para renviar a query id: %d. File:Tag <%s> Data= %s", worker_id, query_id, file_tag, (char*)data);
 
-    // Buscar la query correspondiente al ID
-    t_query_control_block *query = NULL;
-    for (int i = 0; i < list_size(master->queries_table->running_list); i++) {
-        t_query_control_block *aux_qcb = list_get(master->queries_table->running_list, i);
-        if (aux_qcb->query_id == query_id) {
-            query = aux_qcb;
-            break;
-        }
-    }
+    // Buscar la query correspondiente al ID. Sólo se copia su socket: la query puede
+    // liberarse apenas se suelta el mutex
+    pthread_mutex_lock(&master->queries_table->query_table_mutex);
+    t_query_control_block *query = find_running_query(master->queries_table, query_id);
+    int query_socket = query ? query->socket_fd : -1;
+    pthread_mutex_unlock(&master->queries_table->query_table_mutex);
 
     if (query == NULL) {
         log_error(master->logger, "[manage_read_message_from_worker] No se encontró query ID=%d asociada al worker ID=%d.",
@@ -116,15 +115,15 @@ int manage_read_message_from_worker(t_buffer *buffer, int client_socket, t_maste
     }
 
     // Enviar el paquete al Query Control
-    if (package_send(package_to_query, query->socket_fd) != 0) {
+    if (package_send(package_to_query, query_socket) != 0) {
         log_error(master->logger, "[manage_read_message_from_worker] Error al reenviar mensaje de Worker ID=%d hacia Query ID=%d (socket=%d).",
-                  worker_id, query->query_id, query->socket_fd);
+                  worker_id, query_id, query_socket);
         package_destroy(package_to_query);
         return -1;
     }
 
     log_debug(master->logger, "[manage_read_message_from_worker] Mensaje reenviado de Worker ID=%d → Query ID=%d correctamente.",
-              worker_id, query->query_id);
+              worker_id, query_id);
 
     // Liberar memoria
     package_destroy(package_to_query);
@@ -140,15 +139,32 @@ t_worker_control_block *create_worker(t_worker_table *table, int worker_id, int
     pthread_mutex_lock(&table->worker_table_mutex);
 
     t_worker_control_block *wcb = malloc(sizeof(t_worker_control_block));
+    if (wcb == NULL) {
+        pthread_mutex_unlock(&table->worker_table_mutex);
+        return NULL;
+    }
+    wcb->outbox = worker_outbox_create(socket_fd);
+    if (wcb->outbox == NULL) {
+        free(wcb);
+        pthread_mutex_unlock(&table->worker_table_mutex);
+        return NULL;
+    }
     wcb->worker_id = worker_id;
     wcb->ip_address = NULL; // TODO: Obtener IP del socket (entiendo que con el socket ya es suficiente)
     wcb->port = -1; // TODO: Obtener puerto del socket
     wcb->socket_fd = socket_fd; // Necesito el socket para enviar las queries
     wcb->current_query_id = -1; // No tiene query asignada inicialmente
     wcb->state = WORKER_STATE_IDLE; // Nuevo worker comienza en estado IDLE
+    wcb->resident_file_tags = list_create(); // Todavía no informó qué tiene en memoria
 
-    // Agrego el puntero a la lista de workers
+    // Agrego el puntero a la lista de workers y a los índices
     list_add(table->worker_list, wcb);
+
+    char key[INDEX_KEY_SIZE];
+    index_key(key, worker_id);
+    dictionary_put(table->workers_by_id, key, wcb);
+    index_key(key, socket_fd);
+    dictionary_put(table->workers_by_socket, key, wcb);
     table->total_workers_connected++;
     list_add(table->idle_list, wcb); // Nuevo worker comienza en estado IDLE
     pthread_mutex_unlock(&table->worker_table_mutex);
@@ -182,6 +198,8 @@ void manage_worker_evict_response(int socket_fd, t_package *package, t_master *m
               "[manage_worker_evict_response] Recibida respuesta de desalojo - Query ID=%d, PC=%d (socket=%d)",
               query_id, program_counter, socket_fd);
 
+    t_list *summary = read_resident_summary(package->buffer);
+
     // Bloquear ambas tablas en orden consistente
     if (pthread_mutex_lock(&master->workers_table->worker_table_mutex) != 0) {
         log_error(master->logger, 
@@ -197,14 +215,7 @@ void manage_worker_evict_response(int socket_fd, t_package *package, t_master *m
     }
 
     // Buscar el worker que envió la respuesta
-    t_worker_control_block *worker = NULL;
-    for (int i = 0; i < list_size(master->workers_table->worker_list); i++) {
-        t_worker_control_block *w = list_get(master->workers_table->worker_list, i);
-        if (w && w->socket_fd == socket_fd) {
-            worker = w;
-            break;
-        }
-    }
+    t_worker_control_block *worker = find_worker_by_socket(master->workers_table, socket_fd);
 
     if (!worker) {
         log_warning(master->logger, 
@@ -214,14 +225,11 @@ void manage_worker_evict_response(int socket_fd, t_package *package, t_master *m
     }
 
     // Buscar la query desalojada
-    t_query_control_block *query = NULL;
-    for (int i = 0; i < list_size(master->queries_table->running_list); i++) {
-        t_query_control_block *q = list_get(master->queries_table->running_list, i);
-        if (q && q->query_id == query_id) {
-            query = q;
-            break;
-        }
-    }
+    t_query_control_block *query = find_running_query(master->queries_table, query_id);
+
+    // Lo que el worker tiene en memoria sirve para planificar aunque no se encuentre la query
+    update_worker_affinity(master, worker, query ? query->query_file_path : NULL, summary);
+    summary = NULL;
 
     if (!query) {
         log_warning(master->logger, 
@@ -251,7 +259,7 @@ void manage_worker_evict_response(int socket_fd, t_package *package, t_master *m
         query->assigned_worker_id = -1;
         
         // Remover de running_list
-        if (!list_remove_element(master->queries_table->running_list, query)) {
+        if (!remove_running_query(master, query)) {
             log_warning(master->logger, 
                         "[manage_worker_evict_response] Query ID=%d no estaba en running_list",
                         query_id);
@@ -269,14 +277,14 @@ void manage_worker_evict_response(int socket_fd, t_package *package, t_master *m
         query->ready_timestamp = now_ms_monotonic();
 
         // Mover query de running_list a ready_queue
-        if (!list_remove_element(master->queries_table->running_list, query)) {
+        if (!remove_running_query(master, query)) {
             log_error(master->logger, 
                       "[manage_worker_evict_response] Error al remover Query ID=%d de running_list",
                       query_id);
             goto unlock_and_exit;
         }
 
-        if (insert_query_by_priority(master->queries_table->ready_queue, query) != 0) {
+        if (enqueue_ready_query(master, query) != 0) {
             log_error(master->logger, "Error al intentar insertar query (query ID: %d) en Ready Queue.", query_id);
             // Si falla el insert, hacer cleanup para no perder la query
             cleanup_query_resources(query, master);
@@ -310,6 +318,10 @@ unlock_and_exit:
     pthread_mutex_unlock(&master->queries_table->query_table_mutex);
     pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
 
+    if (summary != NULL) {
+        list_destroy_and_destroy_elements(summary, free);
+    }
+
     // Intentar despachar queries pendientes
     try_dispatch(master);
 }
@@ -324,39 +336,27 @@ int manage_worker_end_query(t_buffer *buffer, int client_socket, t_master *maste
     buffer_reset_offset(buffer);
     buffer_read_uint32(buffer, &worker_id);
     buffer_read_uint32(buffer, &query_id);
+    t_list *summary = read_resident_summary(buffer);
 
     // Bloquear AMBOS mutexes en ORDEN
     pthread_mutex_lock(&master->workers_table->worker_table_mutex);
     pthread_mutex_lock(&master->queries_table->query_table_mutex);
 
     // Buscar el worker
-    t_worker_control_block *worker = NULL;
-    for (int i = 0; i < list_size(master->workers_table->worker_list); i++) {
-        t_worker_control_block *aux = list_get(master->workers_table->worker_list, i);
-        if (aux->socket_fd == client_socket) {
-            worker = aux;
-            break;
-        }
-    }
+    t_worker_control_block *worker = find_worker_by_socket(master->workers_table, client_socket);
 
     if (worker == NULL) {
         log_error(master->logger, 
                   "[manage_worker_end_query] No se encontró worker para socket=%d (worker_id=%u).", 
                   client_socket, worker_id);
+        update_worker_affinity(master, NULL, NULL, summary); // Sólo libera el resumen
         pthread_mutex_unlock(&master->queries_table->query_table_mutex);
         pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
         return -1;
     }
 
     // Buscar la query en running_list
-    t_query_control_block *qcb = NULL;
-    for (int i = 0; i < list_size(master->queries_table->running_list); i++) {
-        t_query_control_block *aux = list_get(master->queries_table->running_list, i);
-        if (aux->query_id == (int)query_id) {
-            qcb = aux;
-            break;
-        }
-    }
+    t_query_control_block *qcb = find_running_query(master->queries_table, (int)query_id);
 
     if (qcb == NULL) {
         log_error(master->logger, 
@@ -366,6 +366,7 @@ int manage_worker_end_query(t_buffer *buffer, int client_socket, t_master *maste
         // Liberar worker por seguridad
         worker->state = WORKER_STATE_IDLE;
         worker->current_query_id = -1;
+        update_worker_affinity(master, worker, NULL, summary);
         
         pthread_mutex_unlock(&master->queries_table->query_table_mutex);
         pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
@@ -384,6 +385,7 @@ int manage_worker_end_query(t_buffer *buffer, int client_socket, t_master *maste
         
         worker->state = WORKER_STATE_IDLE;
         worker->current_query_id = -1;
+        update_worker_affinity(master, worker, NULL, summary);
         list_remove_element(master->workers_table->busy_list, worker);
         list_add(master->workers_table->idle_list, worker);
         
@@ -397,8 +399,9 @@ int manage_worker_end_query(t_buffer *buffer, int client_socket, t_master *maste
     // Actualizar estados
     qcb->state = QUERY_STATE_COMPLETED;
     qcb->assigned_worker_id = -1;
+    update_worker_affinity(master, worker, qcb->query_file_path, summary);
     
-    list_remove_element(master->queries_table->running_list, qcb);
+    remove_running_query(master, qcb);
 
     worker->state = WORKER_STATE_IDLE;
     worker->current_query_id = -1;
@@ -431,4 +434,101 @@ int manage_worker_end_query(t_buffer *buffer, int client_socket, t_master *maste
     try_dispatch(master);
 
     return 0;
-}
\ No newline at end of file
+}
+t_worker_control_block *find_worker_by_id(t_worker_table *table, int worker_id) {
+    if (!table || !table->workers_by_id) return NULL;
+
+    char key[INDEX_KEY_SIZE];
+    index_key(key, worker_id);
+    return dictionary_get(table->workers_by_id, key);
+}
+
+void remove_worker_from_indexes(t_worker_table *table, t_worker_control_block *wcb) {
+    char key[INDEX_KEY_SIZE];
+
+    index_key(key, wcb->worker_id);
+    if (dictionary_get(table->workers_by_id, key) == wcb) {
+        dictionary_remove(table->workers_by_id, key);
+    }
+
+    index_key(key, wcb->socket_fd);
+    if (dictionary_get(table->workers_by_socket, key) == wcb) {
+        dictionary_remove(table->workers_by_socket, key);
+    }
+}
+
+t_list *read_resident_summary(t_buffer *buffer) {
+    t_list *summary = list_create();
+
+    // Workers que no envían resumen: el paquete termina antes
+    if (buffer_remaining_capacity(buffer) < sizeof(uint32_t)) {
+        return summary;
+    }
+
+    uint32_t count;
+    if (!buffer_read_uint32(buffer, &count) || count > WORKER_SUMMARY_MAX_FILE_TAGS) {
+        list_destroy(summary);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        char *file_tag = buffer_read_string(buffer);
+        if (file_tag == NULL) {
+            list_destroy_and_destroy_elements(summary, free);
+            return NULL;
+        }
+        list_add(summary, file_tag);
+    }
+    return summary;
+}
+
+static t_list *copy_file_tags(t_list *file_tags) {
+    t_list *copy = list_create();
+    for (int i = 0; i < list_size(file_tags); i++) {
+        list_add(copy, strdup(list_get(file_tags, i)));
+    }
+    return copy;
+}
+
+void update_worker_affinity(t_master *master, t_worker_control_block *worker,
+                            const char *query_file_path, t_list *summary) {
+    if (summary == NULL) {
+        return;
+    }
+
+    t_dictionary *by_path = master->queries_table->file_tags_by_path;
+    if (query_file_path != NULL && by_path != NULL && !list_is_empty(summary)) {
+        // Lo que quedó en la caché al terminar es la mejor aproximación a lo que usa el script
+        t_list *previous = dictionary_remove(by_path, (char *)query_file_path);
+        if (previous != NULL) {
+            list_destroy_and_destroy_elements(previous, free);
+        }
+        dictionary_put(by_path, (char *)query_file_path, copy_file_tags(summary));
+    }
+
+    if (worker == NULL) {
+        list_destroy_and_destroy_elements(summary, free);
+        return;
+    }
+    list_destroy_and_destroy_elements(worker->resident_file_tags, free);
+    worker->resident_file_tags = summary;
+}
+
+int worker_affinity_score(t_worker_control_block *worker, t_list *file_tags) {
+    if (worker == NULL || worker->resident_file_tags == NULL || file_tags == NULL) {
+        return 0;
+    }
+
+    // Ambas listas tienen a lo sumo WORKER_SUMMARY_MAX_FILE_TAGS elementos
+    int score = 0;
+    for (int i = 0; i < list_size(file_tags); i++) {
+        char *wanted = list_get(file_tags, i);
+        for (int j = 0; j < list_size(worker->resident_file_tags); j++) {
+            if (strcmp(wanted, list_get(worker->resident_file_tags, j)) == 0) {
+                score++;
+                break;
+            }
+        }
+    }
+    return score;
+}
@@ -9,11 +9,16 @@
 #include <pthread.h>
 #include <commons/log.h>
 #include <commons/collections/list.h>
+#include <commons/collections/dictionary.h>
 #include <connection/serialization.h>
 #include <connection/protocol.h>
+#include "worker_outbox.h"
 
 typedef struct master t_master;
 
+// Tope de "FILE:TAG" aceptados en el resumen de caché de un worker
+#define WORKER_SUMMARY_MAX_FILE_TAGS 64
+
 typedef enum {
     WORKER_STATE_DISCONNECTED,
     WORKER_STATE_IDLE,
@@ -25,12 +30,16 @@ typedef struct {
     char *ip_address; // Ver si es necesasrio guardar la IP y el puerto
     int port;
     int socket_fd;
+    t_worker_outbox *outbox; // Mensajes al worker, enviados fuera de los mutex de las tablas
     int current_query_id;
     t_worker_state state;
+    t_list *resident_file_tags; // "FILE:TAG" que el worker informó tener en memoria
 } t_worker_control_block;
 
 typedef struct worker_table {
     t_list *worker_list; // Lista de t_worker_control_block
+    t_dictionary *workers_by_id;     // worker_id -> t_worker_control_block
+    t_dictionary *workers_by_socket; // socket_fd -> t_worker_control_block
     int total_workers_connected; // Define el nivel de multiprocesamiento
 
     t_list *idle_list; // Lista de workers en estado IDLE
@@ -65,11 +74,44 @@ int manage_read_message_from_worker(t_buffer *buffer, int client_socket, t_maste
  */
 t_worker_control_block *create_worker(t_worker_table *table, int worker_id, int socket_fd);
 
+/**
+ * @brief Busca un worker por ID en O(1). Debe llamarse con worker_table_mutex tomado.
+ */
+t_worker_control_block *find_worker_by_id(t_worker_table *table, int worker_id);
+
+/**
+ * @brief Lee el resumen de caché opcional al final de END_QUERY / EVICT_RES.
+ *
+ * Formato: uint32 cantidad + cantidad strings "FILE:TAG".
+ * @return Lista de strings (vacía si el worker no envió resumen), o NULL si el resumen está mal formado
+ */
+t_list *read_resident_summary(t_buffer *buffer);
+
+/**
+ * @brief Guarda el resumen como caché del worker y como archivos usados por el script de la query.
+ *
+ * Se queda con la lista (la libera en cualquier caso). Debe llamarse con ambas tablas bloqueadas.
+ * @param query_file_path Script que acaba de correr en el worker, o NULL si no se conoce
+ */
+void update_worker_affinity(t_master *master, t_worker_control_block *worker,
+                            const char *query_file_path, t_list *summary);
+
+/**
+ * @brief Cantidad de "FILE:TAG" de file_tags que el worker tiene en memoria.
+ */
+int worker_affinity_score(t_worker_control_block *worker, t_list *file_tags);
+
+/**
+ * @brief Quita el worker de los índices por ID y por socket.
+ */
+void remove_worker_from_indexes(t_worker_table *table, t_worker_control_block *wcb);
+
 /**
  * handler OP_WORKER_END_QUERY desde un Worker
  * Paquete esperado:
  *   uint32 worker_id
  *   uint32 query_id
+ *   [uint32 cantidad + strings "FILE:TAG"] resumen opcional de la caché del worker
  *
  * Comportamiento:
  *  - Verificar worker por socket
@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <commons/collections/list.h>
+#include <connection/protocol.h>
+
+#include "worker_outbox.h"
+
+struct worker_outbox {
+    int socket_fd;
+    t_list *pending;  // t_package a enviar, en orden
+    pthread_t sender;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool sending;     // Hay un package_send en curso, fuera del mutex
+    bool failed;
+    bool lost_start;  // Un OP_WORKER_START_QUERY no llegó al worker
+    bool closed;
+};
+
+static bool is_start_query(void *package) {
+    return ((t_package *)package)->operation_code == OP_WORKER_START_QUERY;
+}
+
+static void *outbox_sender_thread(void *arg) {
+    t_worker_outbox *outbox = arg;
+
+    pthread_mutex_lock(&outbox->mutex);
+    while (!outbox->closed) {
+        if (list_is_empty(outbox->pending)) {
+            pthread_cond_wait(&outbox->cond, &outbox->mutex);
+            continue;
+        }
+
+        t_package *package = list_remove(outbox->pending, 0);
+        outbox->sending = true;
+        pthread_mutex_unlock(&outbox->mutex);
+
+        uint8_t opcode = package->operation_code;
+        int result = package_send(package, outbox->socket_fd);
+        package_destroy(package);
+
+        pthread_mutex_lock(&outbox->mutex);
+        outbox->sending = false;
+        if (result != 0) {
+            outbox->failed = true;
+            outbox->lost_start = outbox->lost_start || opcode == OP_WORKER_START_QUERY ||
+                                 list_any_satisfy(outbox->pending, is_start_query);
+            list_clean_and_destroy_elements(outbox->pending, (void *)package_destroy);
+            // El hilo de conexión del worker ve la desconexión y la maneja como siempre
+            shutdown(outbox->socket_fd, SHUT_RDWR);
+        }
+    }
+    pthread_mutex_unlock(&outbox->mutex);
+
+    return NULL;
+}
+
+t_worker_outbox *worker_outbox_create(int socket_fd) {
+    t_worker_outbox *outbox = calloc(1, sizeof(t_worker_outbox));
+    if (outbox == NULL) {
+        return NULL;
+    }
+
+    outbox->socket_fd = socket_fd;
+    outbox->pending = list_create();
+    pthread_mutex_init(&outbox->mutex, NULL);
+    pthread_cond_init(&outbox->cond, NULL);
+
+    if (pthread_create(&outbox->sender, NULL, outbox_sender_thread, outbox) != 0) {
+        list_destroy(outbox->pending);
+        pthread_mutex_destroy(&outbox->mutex);
+        pthread_cond_destroy(&outbox->cond);
+        free(outbox);
+        return NULL;
+    }
+
+    return outbox;
+}
+
+int worker_outbox_push(t_worker_outbox *outbox, t_package *package) {
+    if (outbox == NULL || package == NULL) {
+        return -1;
+    }
+
+    int result = -1;
+    pthread_mutex_lock(&outbox->mutex);
+    if (!outbox->closed && !outbox->failed) {
+        list_add(outbox->pending, package);
+        pthread_cond_signal(&outbox->cond);
+        result = 0;
+    }
+    pthread_mutex_unlock(&outbox->mutex);
+    return result;
+}
+
+bool worker_outbox_failed(t_worker_outbox *outbox) {
+    if (outbox == NULL) {
+        return true;
+    }
+
+    pthread_mutex_lock(&outbox->mutex);
+    bool failed = outbox->failed || outbox->closed;
+    pthread_mutex_unlock(&outbox->mutex);
+    return failed;
+}
+
+bool worker_outbox_lost_start(t_worker_outbox *outbox) {
+    if (outbox == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&outbox->mutex);
+    bool lost_start = outbox->lost_start;
+    pthread_mutex_unlock(&outbox->mutex);
+    return lost_start;
+}
+
+void worker_outbox_close(t_worker_outbox *outbox) {
+    if (outbox == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&outbox->mutex);
+    outbox->closed = true;
+    if (outbox->sending) {
+        // Destraba un envío bloqueado por un worker que ya no lee
+        shutdown(outbox->socket_fd, SHUT_RDWR);
+    }
+    pthread_cond_signal(&outbox->cond);
+    pthread_mutex_unlock(&outbox->mutex);
+
+    pthread_join(outbox->sender, NULL);
+
+    list_destroy_and_destroy_elements(outbox->pending, (void *)package_destroy);
+    pthread_mutex_destroy(&outbox->mutex);
+    pthread_cond_destroy(&outbox->cond);
+    free(outbox);
+}
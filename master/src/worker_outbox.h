@@ -0,0 +1,61 @@
+/**
+ * @file worker_outbox.h
+ * @brief Cola de salida por worker
+ *
+ * Los mensajes al worker (inicio de query, pedido de desalojo) se arman con las
+ * tablas bloqueadas, pero el envío puede bloquearse si el worker no lee y se
+ * llena la ventana TCP. Para que un worker lento no frene la planificación,
+ * cada worker tiene un hilo propio que envía en orden los paquetes encolados:
+ * con los mutex de las tablas tomados sólo se hace un list_add.
+ *
+ * Un error de envío deja la cola marcada como fallida, descarta lo pendiente y
+ * hace shutdown del socket: el hilo de conexión del worker ve la desconexión y
+ * la maneja como siempre. Si lo que no llegó fue un inicio de query, el manejo
+ * de la desconexión la devuelve a READY en lugar de finalizarla con error.
+ */
+
+#ifndef WORKER_OUTBOX_H
+#define WORKER_OUTBOX_H
+
+#include <stdbool.h>
+#include <connection/serialization.h>
+
+typedef struct worker_outbox t_worker_outbox;
+
+/**
+ * @brief Crea la cola de salida y su hilo de envío para el socket indicado.
+ *
+ * @return Puntero a la cola, o NULL en caso de error
+ */
+t_worker_outbox *worker_outbox_create(int socket_fd);
+
+/**
+ * @brief Encola un paquete para enviar al worker. No bloquea por la red.
+ *
+ * @return 0 si se encoló (la cola pasa a ser dueña del paquete), -1 si la cola
+ *         está cerrada o falló un envío anterior (el paquete sigue siendo del caller)
+ */
+int worker_outbox_push(t_worker_outbox *outbox, t_package *package);
+
+/**
+ * @brief Indica si la cola ya no acepta envíos (falló un envío o está cerrada).
+ *        Una cola NULL se considera fallida.
+ */
+bool worker_outbox_failed(t_worker_outbox *outbox);
+
+/**
+ * @brief Indica si un OP_WORKER_START_QUERY se descartó por un error de envío,
+ *        es decir, si el worker nunca recibió la última query asignada.
+ */
+bool worker_outbox_lost_start(t_worker_outbox *outbox);
+
+/**
+ * @brief Descarta lo pendiente, espera el envío en curso y libera la cola.
+ *
+ * Debe llamarse antes de cerrar el socket, para que el hilo de envío no use
+ * un descriptor que ya pudo ser reutilizado por otra conexión, y sin los mutex
+ * de las tablas tomados: espera al hilo de envío con pthread_join.
+ */
+void worker_outbox_close(t_worker_outbox *outbox);
+
+#endif // WORKER_OUTBOX_H
@@ -5,6 +5,7 @@
 #include "../../../src/init_master.h"
 #include "../../../src/aging.h"
 #include "../../../src/query_control_manager.h"
+#include "../../../src/query_queue.h"
 
 Test(aging_concurrent, priority_decreases_after_interval, .timeout = 10) {
     // Setup inline
@@ -23,7 +24,7 @@ Test(aging_concurrent, priority_decreases_after_interval, .timeout = 10) {
     // Verificar prioridad
     pthread_mutex_lock(&master->queries_table->query_table_mutex);
     int final_priority = qcb->priority;
-    list_remove_element(master->queries_table->ready_queue, qcb);
+    query_queue_remove(master->queries_table->ready_queue, qcb);
     list_remove_element(master->queries_table->query_list, qcb);
     pthread_mutex_unlock(&master->queries_table->query_table_mutex);
     
@@ -51,7 +52,7 @@ Test(aging_concurrent, priority_never_negative, .timeout = 10) {
     
     pthread_mutex_lock(&master->queries_table->query_table_mutex);
     int final_priority = qcb->priority;
-    list_remove_element(master->queries_table->ready_queue, qcb);
+    query_queue_remove(master->queries_table->ready_queue, qcb);
     list_remove_element(master->queries_table->query_list, qcb);
     pthread_mutex_unlock(&master->queries_table->query_table_mutex);
     
@@ -89,7 +90,7 @@ Test(aging_concurrent, multiple_queries_age_correctly, .timeout = 10) {
     }
     
     for (int i = 0; i < 5; i++) {
-        list_remove_element(master->queries_table->ready_queue, queries[i]);
+        query_queue_remove(master->queries_table->ready_queue, queries[i]);
         list_remove_element(master->queries_table->query_list, queries[i]);
     }
     pthread_mutex_unlock(&master->queries_table->query_table_mutex);
@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include "../../helpers/test_helpers.h"
 #include "../../../src/init_master.h"
+#include "../../../src/query_queue.h"
 #include <linux/time.h>
 
 #define ITERATIONS 20
@@ -41,14 +42,14 @@ static void *thread_create_queries(void *arg) {
     t_master *m = (t_master *)arg;
     
     for (int i = 0; i < ITERATIONS; i++) {
-        t_query_control_block *qcb = malloc(sizeof(t_query_control_block));
+        t_query_control_block *qcb = calloc(1, sizeof(t_query_control_block));
         qcb->query_id = i;
         qcb->priority = 15 - (i % 5);
         qcb->state = QUERY_STATE_READY;
         qcb->query_file_path = strdup("dummy.qry");
         
         pthread_mutex_lock(&m->queries_table->query_table_mutex);
-        list_add(m->queries_table->ready_queue, qcb);
+        insert_query_by_priority(m->queries_table->ready_queue, qcb);
         pthread_mutex_unlock(&m->queries_table->query_table_mutex);
         
         usleep(CREATE_DELAY_US);
@@ -64,7 +65,7 @@ static void *thread_reorder_queries(void *arg) {
     
     for (int i = 0; i < ITERATIONS; i++) {
         pthread_mutex_lock(&m->queries_table->query_table_mutex);
-        list_sort(m->queries_table->ready_queue, priority_comparator);
+        query_queue_peek_min(m->queries_table->ready_queue); // la cola ya se mantiene ordenada
         pthread_mutex_unlock(&m->queries_table->query_table_mutex);
         
         usleep(REORDER_DELAY_US);
@@ -93,7 +94,7 @@ Test(deadlock_detection, concurrent_load_and_reorder_no_deadlock) {
     cr_assert(load_finished, "Create thread should finish");
     cr_assert(reorder_finished, "Reorder thread should finish");
     
-    int final_size = list_size(master->queries_table->ready_queue);
+    int final_size = query_queue_size(master->queries_table->ready_queue);
     cr_assert_eq(final_size, ITERATIONS, "All queries should be in ready queue");
 }
 
@@ -117,5 +118,5 @@ Test(deadlock_detection, stress_test_mutex_contention) {
     
     // Verificar que no se rompió nada
     cr_assert_not_null(master->queries_table->ready_queue);
-    cr_assert_geq(list_size(master->queries_table->ready_queue), 0);
+    cr_assert_geq(query_queue_size(master->queries_table->ready_queue), 0);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include "../../helpers/test_helpers.h"
 #include "../../../src/init_master.h"
+#include "../../../src/query_queue.h"
 #include "../../../src/scheduler.h"
 
 #define NUM_QUERIES 10
@@ -69,7 +70,7 @@ static void *worker_simulator(void *arg) {
             
             if (query) {
                 query->state = QUERY_STATE_COMPLETED;
-                list_remove_element(m->queries_table->running_list, query);
+                remove_running_query(m, query);
                 list_add(m->queries_table->completed_list, query);
                 __sync_fetch_and_add(&queries_completed, 1);
             }
@@ -144,6 +145,6 @@ Test(scheduler_integration, full_execution_no_deadlock) {
     cr_assert_eq(queries_completed, NUM_QUERIES, 
                  "Expected %d completed queries, got %d", NUM_QUERIES, queries_completed);
     cr_assert_eq(list_size(master->queries_table->completed_list), NUM_QUERIES);
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 0);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 0);
     cr_assert_eq(list_size(master->queries_table->running_list), 0);
 }
\ No newline at end of file
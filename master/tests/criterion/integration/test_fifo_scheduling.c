@@ -5,6 +5,7 @@
 
 #include "../../../src/init_master.h"
 #include "../../../src/query_control_manager.h"
+#include "../../../src/query_queue.h"
 #include "../../../src/worker_manager.h"
 #include "../../../src/scheduler.h"
 #include "../../helpers/test_helpers.h"
@@ -84,7 +85,7 @@ void *worker_simulator(void *raw_args) {
 
                 /* mover a completed */
                 qcb->state = QUERY_STATE_COMPLETED;
-                list_remove_element(master->queries_table->running_list, qcb);
+                remove_running_query(master, qcb);
                 list_add(master->queries_table->completed_list, qcb);
             }
 
@@ -149,7 +150,7 @@ Test(fifo_scheduling, four_queries_two_workers, .timeout = 15) {
         cr_assert_not_null(q);
     }
 
-    cr_assert_eq(list_size(master->queries_table->ready_queue), NUM_QUERIES);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), NUM_QUERIES);
 
     /* lanzar dispatcher */
     pthread_t disp;
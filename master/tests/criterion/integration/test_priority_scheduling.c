@@ -113,7 +113,7 @@ void *priority_worker_cooperative(void *raw_args) {
                     pthread_mutex_unlock(&log_mutex);
 
                     qcb->state = QUERY_STATE_COMPLETED;
-                    list_remove_element(master->queries_table->running_list, qcb);
+                    remove_running_query(master, qcb);
                     list_add(master->queries_table->completed_list, qcb);
                 }
 
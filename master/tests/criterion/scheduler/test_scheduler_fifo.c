@@ -1,6 +1,9 @@
 // test_scheduler_fifo.c
 #include <criterion/criterion.h>
 #include "scheduler.h"
+#include "query_queue.h"
+#include <sys/socket.h>
+#include <unistd.h>
 #include "../../helpers/test_helpers.h"
 
 Test(scheduler_fifo, dispatch_single_query_to_idle_worker) {
@@ -17,7 +20,7 @@ Test(scheduler_fifo, dispatch_single_query_to_idle_worker) {
     int result = try_dispatch(master);
     
     cr_assert_eq(result, 0);
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 0);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 0);
     cr_assert_eq(list_size(master->queries_table->running_list), 1);
     cr_assert_eq(list_size(master->workers_table->idle_list), 0);
     cr_assert_eq(list_size(master->workers_table->busy_list), 1);
@@ -51,7 +54,7 @@ Test(scheduler_fifo, dispatch_multiple_queries_fifo_order) {
     try_dispatch(master);
     
     cr_assert_eq(list_size(master->queries_table->running_list), 3);
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 2);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 2);
     cr_assert_eq(list_size(master->workers_table->busy_list), 3);
     
     // Verificar que q1, q2, q3 están en running (FIFO, sin importar prioridad)
@@ -75,9 +78,57 @@ Test(scheduler_fifo, no_dispatch_without_workers) {
     int result = try_dispatch(master);
     
     cr_assert_eq(result, 0); // No hay error, solo no hace nada
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 1);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 1);
     cr_assert_eq(list_size(master->queries_table->running_list), 0);
     
     destroy_fake_master(master);
     log_destroy(logger);
-}
\ No newline at end of file
+}
+
+// Worker con un socket real (el hilo de su cola de salida escribe en él); peer es el otro extremo
+static t_worker_control_block *create_worker_with_socketpair(t_master *master, int worker_id, int *peer) {
+    int fds[2];
+    cr_assert_eq(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    *peer = fds[1];
+    return create_worker(master->workers_table, worker_id, fds[0]);
+}
+
+Test(scheduler_fifo, dispatch_batch_fills_idle_workers_in_one_pass) {
+    t_log *logger = log_create("test.log", "TEST", true, LOG_LEVEL_DEBUG);
+    t_master *master = init_fake_master("FIFO", 1000);
+    
+    // Crear 3 workers
+    int worker_sockets[3];
+    int peers[3];
+    for (int i = 0; i < 3; i++) {
+        t_worker_control_block *worker = create_worker_with_socketpair(master, i + 1, &peers[i]);
+        cr_assert_not_null(worker);
+        worker_sockets[i] = worker->socket_fd;
+    }
+    
+    // Crear 5 queries (más que workers)
+    for (int i = 0; i < 5; i++) {
+        create_query(master, i, "/q.txt", 5, 10 + i);
+    }
+    
+    // Una sola pasada ocupa todos los workers IDLE
+    int dispatched = -1;
+    int result = try_dispatch_batch(master, &dispatched);
+    
+    cr_assert_eq(result, 0);
+    cr_assert_eq(dispatched, 3);
+    cr_assert_eq(list_size(master->queries_table->running_list), 3);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 2);
+    cr_assert_eq(list_size(master->workers_table->idle_list), 0);
+    
+    // Sin workers libres, la siguiente pasada no asigna nada
+    try_dispatch_batch(master, &dispatched);
+    cr_assert_eq(dispatched, 0);
+    
+    destroy_fake_master(master);
+    for (int i = 0; i < 3; i++) {
+        close(worker_sockets[i]);
+        close(peers[i]);
+    }
+    log_destroy(logger);
+}
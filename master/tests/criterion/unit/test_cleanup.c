@@ -1,6 +1,7 @@
 #include <criterion/criterion.h>
 #include "../../../src/init_master.h"
 #include "../../../src/query_control_manager.h"
+#include "../../../src/query_queue.h"
 #include "../../../src/worker_manager.h"
 #include "../../../src/disconnection_handler.h"
 #include "../../helpers/test_helpers.h"
@@ -20,7 +21,7 @@ Test(cleanup, cleanup_query_resources_frees_memory) {
     
     // Verificar que se removió de todas las listas
     cr_assert_eq(list_size(master->queries_table->query_list), 0);
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 0);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 0);
     
     // Valgrind debería confirmar que no hay leaks
     destroy_fake_master(master);
@@ -34,10 +35,12 @@ Test(cleanup, cleanup_worker_resources_frees_memory) {
     cr_assert_not_null(wcb);
     cr_assert_eq(list_size(master->workers_table->worker_list), 1);
     
-    // Cleanup debería liberar TODO
+    // Cleanup debería liberar TODO; la cola de salida se cierra sin el mutex tomado
+    t_worker_outbox *outbox = wcb->outbox;
     pthread_mutex_lock(&master->workers_table->worker_table_mutex);
     cleanup_worker_resources(wcb, master);
     pthread_mutex_unlock(&master->workers_table->worker_table_mutex);
+    worker_outbox_close(outbox);
     
     // Verificar que se removió de todas las listas
     cr_assert_eq(list_size(master->workers_table->worker_list), 0);
@@ -1,6 +1,7 @@
 #include <criterion/criterion.h>
 #include "../../../src/init_master.h"
 #include "../../../src/query_control_manager.h"
+#include "../../../src/query_queue.h"
 #include "../../helpers/test_helpers.h"
 
 // ==========================================
@@ -30,7 +31,7 @@ Test(query_management, create_query_basic) {
     
     // Verificar que está en las listas correctas
     cr_assert_eq(list_size(master->queries_table->query_list), 1);
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 1);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 1);
     cr_assert_eq(master->queries_table->total_queries, 1);
     
     destroy_fake_master(master);
@@ -49,12 +50,12 @@ Test(query_management, multiple_queries_fifo) {
     cr_assert_not_null(q3);
     
     // En FIFO, el orden en ready_queue es por llegada
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 3);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 3);
     
     // Verificar orden FIFO (primera en llegar, primera en la cola)
-    t_query_control_block *first = list_get(master->queries_table->ready_queue, 0);
-    t_query_control_block *second = list_get(master->queries_table->ready_queue, 1);
-    t_query_control_block *third = list_get(master->queries_table->ready_queue, 2);
+    t_query_control_block *first = query_queue_get(master->queries_table->ready_queue, 0);
+    t_query_control_block *second = query_queue_get(master->queries_table->ready_queue, 1);
+    t_query_control_block *third = query_queue_get(master->queries_table->ready_queue, 2);
     
     cr_assert_eq(first->query_id, 0);
     cr_assert_eq(second->query_id, 1);
@@ -72,13 +73,13 @@ Test(query_management, multiple_queries_priority_order) {
     create_query(master, 2, "/q3.qry", 8, 102);  // Prioridad baja
     create_query(master, 3, "/q4.qry", 2, 103);  // Prioridad alta (igual a q2)
     
-    cr_assert_eq(list_size(master->queries_table->ready_queue), 4);
+    cr_assert_eq(query_queue_size(master->queries_table->ready_queue), 4);
     
     // Verificar orden: q2(2), q4(2), q1(5), q3(8)
-    t_query_control_block *first = list_get(master->queries_table->ready_queue, 0);
-    t_query_control_block *second = list_get(master->queries_table->ready_queue, 1);
-    t_query_control_block *third = list_get(master->queries_table->ready_queue, 2);
-    t_query_control_block *fourth = list_get(master->queries_table->ready_queue, 3);
+    t_query_control_block *first = query_queue_get(master->queries_table->ready_queue, 0);
+    t_query_control_block *second = query_queue_get(master->queries_table->ready_queue, 1);
+    t_query_control_block *third = query_queue_get(master->queries_table->ready_queue, 2);
+    t_query_control_block *fourth = query_queue_get(master->queries_table->ready_queue, 3);
     
     cr_assert_eq(first->priority, 2);
     cr_assert_eq(second->priority, 2);
@@ -90,18 +91,18 @@ Test(query_management, multiple_queries_priority_order) {
 
 Test(query_management, insert_query_by_priority_correct_position) {
     t_master *master = init_fake_master("PRIORITY", 1000);
-    t_list *queue = master->queries_table->ready_queue;
+    t_query_queue *queue = master->queries_table->ready_queue;
     
     // Crear queries manualmente y insertar con la función
-    t_query_control_block *q1 = malloc(sizeof(t_query_control_block));
+    t_query_control_block *q1 = calloc(1, sizeof(t_query_control_block));
     q1->query_id = 0;
     q1->priority = 5;
     
-    t_query_control_block *q2 = malloc(sizeof(t_query_control_block));
+    t_query_control_block *q2 = calloc(1, sizeof(t_query_control_block));
     q2->query_id = 1;
     q2->priority = 2;
     
-    t_query_control_block *q3 = malloc(sizeof(t_query_control_block));
+    t_query_control_block *q3 = calloc(1, sizeof(t_query_control_block));
     q3->query_id = 2;
     q3->priority = 8;
     
@@ -111,11 +112,11 @@ Test(query_management, insert_query_by_priority_correct_position) {
     cr_assert_eq(insert_query_by_priority(queue, q3), 0);
     
     // Verificar orden final: q2(2), q1(5), q3(8)
-    cr_assert_eq(list_size(queue), 3);
+    cr_assert_eq(query_queue_size(queue), 3);
     
-    t_query_control_block *first = list_get(queue, 0);
-    t_query_control_block *second = list_get(queue, 1);
-    t_query_control_block *third = list_get(queue, 2);
+    t_query_control_block *first = query_queue_get(queue, 0);
+    t_query_control_block *second = query_queue_get(queue, 1);
+    t_query_control_block *third = query_queue_get(queue, 2);
     
     cr_assert_eq(first->query_id, 1);  // q2
     cr_assert_eq(second->query_id, 0); // q1
@@ -146,7 +147,7 @@ Test(query_management, insert_query_null_handling) {
     cr_assert_eq(result, -1, "Should return error for NULL query");
     
     // Intentar insertar en lista NULL
-    t_query_control_block *qcb = malloc(sizeof(t_query_control_block));
+    t_query_control_block *qcb = calloc(1, sizeof(t_query_control_block));
     qcb->priority = 5;
     result = insert_query_by_priority(NULL, qcb);
     cr_assert_eq(result, -1, "Should return error for NULL list");
@@ -4,6 +4,7 @@
 #include <commons/log.h>
 #include "../../src/init_master.h"
 #include "../../src/query_control_manager.h"
+#include "../../src/query_queue.h"
 #include "../../src/scheduler.h"
 #include "../../src/aging.h"
 
@@ -23,12 +24,12 @@ void test_aging_increases_priority_after_interval(void) {
         log_info(fake_master->logger, "Aging deshabilitado (scheduler FIFO)");
     }
 
-    t_query_control_block* qcb = malloc(sizeof(t_query_control_block));
+    t_query_control_block* qcb = calloc(1, sizeof(t_query_control_block));
     qcb->query_id = 1;
     qcb->priority = 3;
     qcb->state = QUERY_STATE_READY;
     qcb->ready_timestamp = now_ms_monotonic();
-    list_add(fake_master->queries_table->ready_queue, qcb);
+    insert_query_by_priority(fake_master->queries_table->ready_queue, qcb);
 
     usleep(600 * 1000); // esperar un poco más que el aging_interval
 
@@ -42,7 +43,7 @@ void test_aging_increases_priority_after_interval(void) {
     // Liberar memoria
     destroy_fake_master(fake_master);
 /*     pthread_mutex_destroy(&master->queries_table->query_table_mutex);
-    list_destroy(master->queries_table->ready_queue);
+    query_queue_destroy(master->queries_table->ready_queue);
     log_destroy(master.logger);
     master.logger = NULL;
 
@@ -69,18 +70,29 @@ t_master* init_fake_master() {
     // Inicializar tablas
     master->queries_table = malloc(sizeof(t_query_table));
     master->queries_table->query_list = list_create();
+    master->queries_table->queries_by_id = dictionary_create();
+    master->queries_table->queries_by_socket = dictionary_create();
+    master->queries_table->file_tags_by_path = dictionary_create();
     master->queries_table->total_queries = 0;
     master->queries_table->next_query_id = -1; // Comienza en 0, se incrementa con cada nueva query
 
     // Crear e inicializar listas de estados (utilizando las commons)
-    master->queries_table->ready_queue = list_create();
+    master->queries_table->ready_queue = query_queue_create();
     master->queries_table->running_list = list_create();
+    master->queries_table->running_by_priority = query_queue_create();
     master->queries_table->completed_list = list_create();
     master->queries_table->canceled_list = list_create();
     pthread_mutex_init(&master->queries_table->query_table_mutex, NULL);
+    pthread_condattr_t aging_cond_attr;
+    pthread_condattr_init(&aging_cond_attr);
+    pthread_condattr_setclock(&aging_cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&master->queries_table->aging_cond, &aging_cond_attr);
+    pthread_condattr_destroy(&aging_cond_attr);
 
     master->workers_table = malloc(sizeof(t_worker_table));
     master->workers_table->worker_list = list_create();
+    master->workers_table->workers_by_id = dictionary_create();
+    master->workers_table->workers_by_socket = dictionary_create();
     master->workers_table->total_workers_connected = 0;
     master->workers_table->idle_list = list_create();
     master->workers_table->busy_list = list_create();
@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include "../../src/init_master.h"
 #include "../../src/query_control_manager.h"
+#include "../../src/query_queue.h"
 #include "../../src/worker_manager.h"
 #include <commons/collections/list.h>
 
@@ -31,12 +32,12 @@ void* hilo_carga_queries(void* arg) {
     t_master* master = (t_master*)arg;
 
     for (int i = 0; i < CANTIDAD_ITERACIONES; i++) {
-        t_query_control_block* qcb = malloc(sizeof(t_query_control_block));
+        t_query_control_block* qcb = calloc(1, sizeof(t_query_control_block));
         qcb->query_id = i;
         qcb->priority = 18 - (i % 3); // prioridad variable
 
         pthread_mutex_lock(&master->queries_table->query_table_mutex);
-        list_add(master->queries_table->ready_queue, qcb);
+        insert_query_by_priority(master->queries_table->ready_queue, qcb);
         pthread_mutex_unlock(&master->queries_table->query_table_mutex);
 
         usleep(INTERVALO_CREACION_US);
@@ -51,7 +52,7 @@ void* hilo_reordenamiento(void* arg) {
 
     for (int i = 0; i < CANTIDAD_ITERACIONES; i++) {
         pthread_mutex_lock(&master->queries_table->query_table_mutex);
-        list_sort(master->queries_table->ready_queue, comparador_prioridad);
+        query_queue_peek_min(master->queries_table->ready_queue); // la cola ya se mantiene ordenada
         pthread_mutex_unlock(&master->queries_table->query_table_mutex);
 
         usleep(INTERVALO_REORDENAMIENTO_US);
@@ -78,7 +79,7 @@ void test_concurrencia_carga_y_reordenamiento() {
     if (!carga_finalizada || !reordenamiento_finalizado) {
         TEST_FAIL_MESSAGE("⚠️ Posible deadlock: los hilos no finalizaron.");
     } else {
-        printf("✅ Cola final con %d elementos\n", list_size(master->queries_table->ready_queue));
+        printf("✅ Cola final con %d elementos\n", query_queue_size(master->queries_table->ready_queue));
         TEST_PASS_MESSAGE("Ambos hilos finalizaron sin deadlock.");
     }
 
@@ -110,18 +111,24 @@ t_master* init_fake_master() {
     // Inicializar tablas
     master->queries_table = malloc(sizeof(t_query_table));
     master->queries_table->query_list = list_create();
+    master->queries_table->queries_by_id = dictionary_create();
+    master->queries_table->queries_by_socket = dictionary_create();
+    master->queries_table->file_tags_by_path = dictionary_create();
     master->queries_table->total_queries = 0;
     master->queries_table->next_query_id = -1; // Comienza en 0, se incrementa con cada nueva query
 
     // Crear e inicializar listas de estados (utilizando las commons)
-    master->queries_table->ready_queue = list_create();
+    master->queries_table->ready_queue = query_queue_create();
     master->queries_table->running_list = list_create();
+    master->queries_table->running_by_priority = query_queue_create();
     master->queries_table->completed_list = list_create();
     master->queries_table->canceled_list = list_create();
     pthread_mutex_init(&master->queries_table->query_table_mutex, NULL);
 
     master->workers_table = malloc(sizeof(t_worker_table));
     master->workers_table->worker_list = list_create();
+    master->workers_table->workers_by_id = dictionary_create();
+    master->workers_table->workers_by_socket = dictionary_create();
     master->workers_table->total_workers_connected = 0;
     master->workers_table->idle_list = list_create();
     master->workers_table->busy_list = list_create();
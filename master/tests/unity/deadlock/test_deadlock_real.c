@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "../../src/init_master.h"
 #include "../../src/query_control_manager.h"
+#include "../../src/query_queue.h"
 #include "../../src/worker_manager.h"
 #include "../../src/scheduler.h"
 #include <commons/collections/list.h>
@@ -62,7 +63,7 @@ void* hilo_worker_simulado(void* arg) {
 
             if (query) {
                 query->state = QUERY_STATE_COMPLETED;
-                list_remove_element(master->queries_table->running_list, query);
+                remove_running_query(master, query);
                 list_add(master->queries_table->completed_list, query);
                 queries_finalizadas++;
             }
@@ -165,18 +166,25 @@ t_master* init_fake_master() {
     // Inicializar tablas
     master->queries_table = malloc(sizeof(t_query_table));
     master->queries_table->query_list = list_create();
+    master->queries_table->queries_by_id = dictionary_create();
+    master->queries_table->queries_by_socket = dictionary_create();
+    master->queries_table->file_tags_by_path = dictionary_create();
     master->queries_table->total_queries = 0;
     master->queries_table->next_query_id = -1; // Comienza en 0, se incrementa con cada nueva query
 
     // Crear e inicializar listas de estados (utilizando las commons)
-    master->queries_table->ready_queue = list_create();
+    master->queries_table->ready_queue = query_queue_create();
     master->queries_table->running_list = list_create();
+    master->queries_table->running_by_priority = query_queue_create();
     master->queries_table->completed_list = list_create();
     master->queries_table->canceled_list = list_create();
     pthread_mutex_init(&master->queries_table->query_table_mutex, NULL);
+    pthread_cond_init(&master->queries_table->aging_cond, NULL);
 
     master->workers_table = malloc(sizeof(t_worker_table));
     master->workers_table->worker_list = list_create();
+    master->workers_table->workers_by_id = dictionary_create();
+    master->workers_table->workers_by_socket = dictionary_create();
     master->workers_table->total_workers_connected = 0;
     master->workers_table->idle_list = list_create();
     master->workers_table->busy_list = list_create();
@@ -0,0 +1,173 @@
+/*
+ * Benchmark del COMMIT por algoritmo de hash: arma un filesystem temporal con
+ * un file:tag grande (la mitad de los bloques repetidos) y mide el digest en
+ * memoria y el COMMIT completo (lectura, hash, índice y reasignaciones) con
+ * cada HASH_ALGORITHM. BLOCK_ACCESS_DELAY es 0 para medir sólo el costo real.
+ *
+ * Uso: make bench && ./bin/storage_bench [bloques] [tamaño_bloque] [hilos]
+ */
+#include <config/storage_config.h>
+#include <fresh_start/fresh_start.h>
+#include <operations/commit_tag.h>
+#include <utils/block_index.h>
+#include <utils/filesystem_utils.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_MOUNT_POINT "/tmp/storage_bench"
+#define BENCH_FILE "bench"
+#define BENCH_TAG "v1"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Contenido pseudoaleatorio que depende sólo de seed
+static void fill_block(char *block, int block_size, uint64_t seed) {
+  uint64_t state = seed * 0x9e3779b97f4a7c15ULL + 1;
+  for (int i = 0; i < block_size; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    block[i] = (char)state;
+  }
+}
+
+static double digest_throughput(int block_size) {
+  char *block = malloc(block_size);
+  fill_block(block, block_size, 42);
+
+  int rounds = (int)((256u << 20) / (unsigned)block_size);
+  t_block_digest digest;
+  double start = now_seconds();
+  for (int i = 0; i < rounds; i++) {
+    block[0] = (char)i;
+    block_index_digest(block, block_size, &digest);
+  }
+  double elapsed = now_seconds() - start;
+
+  free(block);
+  return (double)rounds * block_size / elapsed / 1e6;
+}
+
+/**
+ * Crea el filesystem y el file:tag en WORK_IN_PROGRESS: el bloque lógico i
+ * usa el físico i + 1 con el contenido i % (bloques / 2)
+ */
+static int setup_filesystem(int blocks, int block_size) {
+  if (system("rm -rf " BENCH_MOUNT_POINT) != 0 ||
+      mkdir(BENCH_MOUNT_POINT, 0755) != 0) {
+    return -1;
+  }
+
+  int fs_size = g_storage_config->fs_size;
+  if (init_bitmap(BENCH_MOUNT_POINT, fs_size, block_size) != 0 ||
+      init_blocks_index(BENCH_MOUNT_POINT) != 0 ||
+      init_physical_blocks(BENCH_MOUNT_POINT, fs_size, block_size) != 0 ||
+      create_file_dir_structure(BENCH_MOUNT_POINT, BENCH_FILE, BENCH_TAG) != 0) {
+    return -1;
+  }
+
+  int *physical_blocks = malloc(sizeof(int) * blocks);
+  char *block = malloc(block_size);
+  int distinct = blocks / 2 > 0 ? blocks / 2 : 1;
+
+  for (int i = 0; i < blocks; i++) {
+    physical_blocks[i] = i + 1;
+    fill_block(block, block_size, (uint64_t)(i % distinct));
+
+    char physical_path[PATH_MAX];
+    snprintf(physical_path, sizeof(physical_path),
+             "%s/physical_blocks/block%04d.dat", BENCH_MOUNT_POINT, i + 1);
+    FILE *file = fopen(physical_path, "wb");
+    fwrite(block, 1, block_size, file);
+    fclose(file);
+
+    char logical_path[PATH_MAX];
+    snprintf(logical_path, sizeof(logical_path),
+             "%s/files/%s/%s/logical_blocks/%04d.dat", BENCH_MOUNT_POINT,
+             BENCH_FILE, BENCH_TAG, i);
+    if (link(physical_path, logical_path) != 0) {
+      return -1;
+    }
+  }
+  modify_bitmap_bits(BENCH_MOUNT_POINT, 1, blocks, 1);
+
+  int retval = create_metadata_file(BENCH_MOUNT_POINT, BENCH_FILE, BENCH_TAG,
+                                    blocks * block_size, physical_blocks,
+                                    blocks, IN_PROGRESS);
+  free(block);
+  free(physical_blocks);
+  return retval;
+}
+
+static void teardown_filesystem(void) {
+  block_index_close();
+  bitmap_unmap();
+  metadata_cache_clear();
+  if (system("rm -rf " BENCH_MOUNT_POINT) != 0) {
+    fprintf(stderr, "No se pudo borrar %s\n", BENCH_MOUNT_POINT);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int blocks = argc > 1 ? atoi(argv[1]) : 4096;
+  int block_size = argc > 2 ? atoi(argv[2]) : 4096;
+  int threads = argc > 3 ? atoi(argv[3]) : DEFAULT_COMMIT_THREADS;
+
+  g_storage_logger = log_create("/tmp/storage_bench.log", "STORAGE_BENCH",
+                                false, LOG_LEVEL_ERROR);
+  g_storage_config = calloc(1, sizeof(t_storage_config));
+  g_storage_config->mount_point = strdup(BENCH_MOUNT_POINT);
+  g_storage_config->block_size = block_size;
+  g_storage_config->fs_size = (blocks + 1) * block_size;
+  g_storage_config->bitmap_size_bytes = (blocks + 1 + 7) / 8;
+  g_storage_config->commit_threads = threads;
+  g_open_files_dict = dictionary_create();
+
+  printf("%d bloques de %d bytes (%.1f MB, mitad repetidos), %d hilos\n",
+         blocks, block_size, (double)blocks * block_size / 1e6, threads);
+
+  t_block_hash_algorithm algorithms[] = {BLOCK_HASH_MD5, BLOCK_HASH_SHA256,
+                                         BLOCK_HASH_BLAKE2B, BLOCK_HASH_FAST};
+  for (size_t a = 0; a < sizeof(algorithms) / sizeof(algorithms[0]); a++) {
+    if (block_index_set_algorithm(algorithms[a]) != 0) {
+      printf("%-8s no disponible en este OpenSSL\n",
+             block_hash_algorithm_name(algorithms[a]));
+      continue;
+    }
+    for (int verify = 0; verify <= 1; verify++) {
+      g_storage_config->hash_algorithm = algorithms[a];
+      g_storage_config->verify_dedup = verify;
+
+      if (setup_filesystem(blocks, block_size) != 0) {
+        fprintf(stderr, "No se pudo armar el filesystem en %s\n",
+                BENCH_MOUNT_POINT);
+        teardown_filesystem();
+        return EXIT_FAILURE;
+      }
+
+      double start = now_seconds();
+      int result = execute_tag_commit(1, BENCH_FILE, BENCH_TAG);
+      double elapsed = now_seconds() - start;
+
+      printf("%-8s %-14s digest: %8.0f MB/s   COMMIT: %8.1f MB/s (%.3f s)%s\n",
+             block_hash_algorithm_name(algorithms[a]),
+             verify ? "VERIFY_DEDUP" : "", digest_throughput(block_size),
+             (double)blocks * block_size / elapsed / 1e6, elapsed,
+             result == 0 ? "" : "   [COMMIT falló]");
+
+      teardown_filesystem();
+    }
+  }
+
+  dictionary_destroy(g_open_files_dict);
+  free(g_storage_config->mount_point);
+  free(g_storage_config);
+  log_destroy(g_storage_logger);
+  return EXIT_SUCCESS;
+}
@@ -30,6 +30,32 @@ t_storage_config *create_storage_config(const char *config_file_path) {
       config_get_int_value(config, "OPERATION_DELAY");
   storage_config->block_access_delay =
       config_get_int_value(config, "BLOCK_ACCESS_DELAY");
+  storage_config->commit_threads =
+      config_has_property(config, "COMMIT_THREADS")
+          ? config_get_int_value(config, "COMMIT_THREADS")
+          : DEFAULT_COMMIT_THREADS;
+  if (storage_config->commit_threads < 1)
+    storage_config->commit_threads = 1;
+
+  storage_config->hash_algorithm = BLOCK_HASH_MD5;
+  if (config_has_property(config, "HASH_ALGORITHM")) {
+    storage_config->hash_algorithm = block_hash_algorithm_from_string(
+        config_get_string_value(config, "HASH_ALGORITHM"));
+    if (storage_config->hash_algorithm < 0) {
+      fprintf(stderr, "HASH_ALGORITHM inválido: %s (MD5, SHA256, BLAKE2B o "
+                      "FAST)\n",
+              config_get_string_value(config, "HASH_ALGORITHM"));
+      free(storage_config);
+      goto clean_config;
+    }
+  }
+
+  storage_config->verify_dedup = false;
+  if (config_has_property(config, "VERIFY_DEDUP")) {
+    char *verify_dedup_str = config_get_string_value(config, "VERIFY_DEDUP");
+    storage_config->verify_dedup = strcmp(verify_dedup_str, "TRUE") == 0 ||
+                                   strcmp(verify_dedup_str, "true") == 0;
+  }
 
   char *storage_ip_str = strdup(config_get_string_value(config, "STORAGE_IP"));
   if (!storage_ip_str)
@@ -119,7 +145,8 @@ static bool has_required_properties(t_config *config) {
       "STORAGE_IP",      "STORAGE_PORT",       "FRESH_START", "MOUNT_POINT",
       "OPERATION_DELAY", "BLOCK_ACCESS_DELAY", "LOG_LEVEL"};
 
-  size_t keys_amount = config_keys_amount(config);
+  // Recorre las requeridas, no las del archivo: puede tener opcionales
+  size_t keys_amount = sizeof(required_props) / sizeof(required_props[0]);
   for (size_t i = 0; i < keys_amount; ++i) {
     if (!config_has_property(config, required_props[i])) {
       fprintf(stderr, "Falta propiedad requerida: %s\n", required_props[i]);
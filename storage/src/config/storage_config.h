@@ -2,6 +2,7 @@
 #define STORAGE_CONFIG_H
 
 #include "globals/globals.h"
+#include "utils/block_index.h"
 #include <commons/config.h>
 #include <commons/log.h>
 #include <errno.h>
@@ -11,6 +12,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Hilos que leen y hashean bloques en un COMMIT si no se configura
+// COMMIT_THREADS
+#define DEFAULT_COMMIT_THREADS 4
+
 /**
  * Crea la configuración del Storage y la devuelve
  *
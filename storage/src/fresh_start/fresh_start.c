@@ -1,5 +1,6 @@
 #include "fresh_start.h"
 #include "../utils/filesystem_utils.h"
+#include "../utils/block_index.h"
 
 /**
  * Borra todo el contenido del directorio de montaje excepto superblock.config
@@ -54,6 +55,9 @@ int init_bitmap(const char *mount_point, int fs_size, int block_size) {
     return -1;
   }
 
+  // Un mapeo previo apuntaría al bitmap que se está por reemplazar
+  bitmap_unmap();
+
   char bitmap_path[PATH_MAX];
   snprintf(bitmap_path, sizeof(bitmap_path), "%s/bitmap.bin", mount_point);
 
@@ -106,19 +110,15 @@ clean_buffer:
  * @return 0 en caso de exito, -1 si se rompe
  */
 int init_blocks_index(const char *mount_point) {
-  char blocks_path[PATH_MAX];
-  snprintf(blocks_path, sizeof(blocks_path), "%s/blocks_hash_index.config",
-           mount_point);
+  // El índice cargado en memoria corresponde al contenido anterior
+  block_index_close();
 
-  FILE *blocks_ptr = fopen(blocks_path, "wb");
-  if (blocks_ptr == NULL) {
-    log_error(g_storage_logger, "No se pudo crear el archivo %s", blocks_path);
+  if (block_index_create(mount_point) != 0) {
     return -1;
   }
 
-  fclose(blocks_ptr);
-
-  log_info(g_storage_logger, "Índice de bloques creado en %s", blocks_path);
+  log_info(g_storage_logger, "Índice de bloques creado en %s/%s", mount_point,
+           BLOCK_INDEX_FILE);
   return 0;
 }
 
@@ -202,8 +202,9 @@ int init_files(const char *mount_point) {
     return -5;
   }
 
-  if (create_metadata_file(mount_point, "initial_file", "BASE",
-                           "SIZE=0\nBLOCKS=[0]\nESTADO=COMMITTED\n") != 0) {
+  const int initial_blocks[] = {0};
+  if (create_metadata_file(mount_point, "initial_file", "BASE", 0,
+                           initial_blocks, 1, COMMITTED) != 0) {
     return -6;
   }
 
@@ -223,6 +224,9 @@ int init_storage(const char *mount_point) {
   int fs_size = g_storage_config->fs_size;
   int block_size = g_storage_config->block_size;
 
+  // La caché de metadata corresponde al contenido que se borra
+  metadata_cache_clear();
+
   if (wipe_storage_content(mount_point) != 0)
     return -2;
   if (init_bitmap(mount_point, fs_size, block_size) != 0)
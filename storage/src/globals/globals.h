@@ -14,6 +14,9 @@ typedef struct {
   char *mount_point;
   int operation_delay;
   int block_access_delay;
+  int commit_threads; // Hilos que leen y hashean bloques en un COMMIT
+  int hash_algorithm; // t_block_hash_algorithm para deduplicar
+  bool verify_dedup;  // Comparar los bytes antes de reasignar un duplicado
   int fs_size;
   int block_size;
   size_t bitmap_size_bytes;
@@ -29,11 +32,13 @@ extern t_log *g_storage_logger;
 extern t_storage_config *g_storage_config;
 extern int g_worker_counter;
 extern t_dictionary *g_open_files_dict;
+extern t_dictionary *g_metadata_cache; // "name:tag" -> t_file_metadata
 
 // semáforos
 extern pthread_mutex_t g_worker_counter_mutex;
 extern pthread_mutex_t g_storage_bitmap_mutex;
 extern pthread_mutex_t g_blocks_hash_index_mutex;
 extern pthread_mutex_t g_storage_open_files_dict_mutex;
+extern pthread_mutex_t g_metadata_cache_mutex;
 
 #endif
@@ -2,6 +2,8 @@
 #include "fresh_start/fresh_start.h"
 #include "globals/globals.h"
 #include "server/server.h"
+#include "utils/block_index.h"
+#include "utils/filesystem_utils.h"
 #include <commons/bitarray.h>
 #include <commons/config.h>
 #include <commons/log.h>
@@ -72,6 +74,14 @@ int main(int argc, char *argv[]) {
             g_storage_config->block_access_delay,
             log_level_as_string(g_storage_config->log_level));
 
+  // Los digests del índice (y el que se crea en FRESH_START) usan este algoritmo
+  if (block_index_set_algorithm(g_storage_config->hash_algorithm) != 0) {
+    log_error(g_storage_logger, "HASH_ALGORITHM %s no disponible",
+              block_hash_algorithm_name(g_storage_config->hash_algorithm));
+    retval = -10;
+    goto clean_logger;
+  }
+
   // Inicializa diccionario de file locks
   g_open_files_dict = dictionary_create();
 
@@ -92,6 +102,27 @@ int main(int argc, char *argv[]) {
 
     log_info(g_storage_logger, "Filesystem inicializado exitosamente en %s",
              g_storage_config->mount_point);
+  } else if (migrate_all_metadata(g_storage_config->mount_point) < 0) {
+    log_error(g_storage_logger, "No se pudo migrar el metadata de %s",
+              g_storage_config->mount_point);
+    retval = -8;
+    goto clean_logger;
+  }
+
+  // Mapea el bitmap una sola vez; las operaciones lo modifican en memoria
+  if (bitmap_map(g_storage_config->mount_point) != 0) {
+    log_error(g_storage_logger, "No se pudo mapear el bitmap de %s",
+              g_storage_config->mount_point);
+    retval = -7;
+    goto clean_logger;
+  }
+
+  // Carga el índice de hashes una sola vez; los COMMIT sólo lo consultan
+  if (block_index_open(g_storage_config->mount_point) != 0) {
+    log_error(g_storage_logger, "No se pudo cargar el índice de bloques de %s",
+              g_storage_config->mount_point);
+    retval = -9;
+    goto clean_logger;
   }
 
   // Inicia servidor
@@ -139,12 +170,18 @@ int main(int argc, char *argv[]) {
   }
 
   close(socket);
+  bitmap_unmap();
+  block_index_close();
+  metadata_cache_clear();
   cleanup_file_sync();
   log_destroy(g_storage_logger);
   destroy_storage_config(g_storage_config);
   exit(EXIT_SUCCESS);
 
 clean_logger:
+  bitmap_unmap();
+  block_index_close();
+  metadata_cache_clear();
   cleanup_file_sync();
   log_destroy(g_storage_logger);
 clean_config:
@@ -188,17 +188,30 @@ int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag,
     goto end;
   }
 
-  // Carga el config para blocks_hash_index
-  pthread_mutex_lock(&g_blocks_hash_index_mutex);
-  char hash_index_config_path[PATH_MAX];
-  snprintf(hash_index_config_path, sizeof(hash_index_config_path),
-           "%s/blocks_hash_index.config", g_storage_config->mount_point);
-  t_config *hash_index_config = config_create(hash_index_config_path);
+  t_block_digest *digests =
+      malloc(sizeof(t_block_digest) * metadata->block_count);
+  if (digests == NULL) {
+    log_error(g_storage_logger,
+              "## Query ID: %" PRIu32
+              " - Error de asignación de memoria para los hashes de bloques",
+              query_id);
+    retval = -2;
+    goto end;
+  }
 
-  if (hash_index_config == NULL) {
+  // Primera etapa, en paralelo y sin tomar el índice: leer y hashear
+  if (hash_logical_blocks(query_id, name, tag, metadata->block_count,
+                          digests) < 0) {
+    retval = -3;
+    goto clean_digests;
+  }
+
+  // Segunda etapa, serializada: consultar el índice y reasignar en orden
+  pthread_mutex_lock(&g_blocks_hash_index_mutex);
+  if (block_index_open(g_storage_config->mount_point) != 0) {
     log_error(g_storage_logger,
               "## Query ID: %" PRIu32
-              " - No se pudo leer el archivo blocks_hash_index.config",
+              " - No se pudo cargar el índice de hashes de bloques",
               query_id);
     retval = -1;
     goto unlock_hash_index;
@@ -208,47 +221,13 @@ int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag,
   for (int logical_block = 0; logical_block < metadata->block_count;
        logical_block++) {
     int physical_block = metadata->blocks[logical_block];
+    const t_block_digest *digest = &digests[logical_block];
 
-    char *read_buffer = NULL;
-    char *hash = NULL;
-    char *physical_block_from_hash = NULL;
-
-    // Lee el contenido del bloque físico asociado al bloque lógico
     char logical_block_path[PATH_MAX];
     snprintf(logical_block_path, sizeof(logical_block_path),
              "%s/files/%s/%s/logical_blocks/%04d.dat",
              g_storage_config->mount_point, name, tag, logical_block);
 
-    read_buffer = (char *)malloc(g_storage_config->block_size);
-    if (read_buffer == NULL) {
-      log_error(g_storage_logger,
-                "## Query ID: %" PRIu32
-                " - Error de asignación de memoria para leer el bloque: %s",
-                query_id, logical_block_path);
-      retval = -2;
-      goto cleanup_all;
-    }
-
-    if (read_block_content(query_id, logical_block_path,
-                           g_storage_config->block_size, read_buffer) < 0) {
-      retval = -3;
-      goto cleanup_loop;
-    }
-
-    // Hashea el contenido del bloque leído
-    hash = crypto_md5(read_buffer, (size_t)g_storage_config->block_size);
-    if (hash == NULL) {
-      log_error(g_storage_logger,
-                "## Query ID: %" PRIu32
-                " - No se generó el hash para el bloque %s",
-                query_id, logical_block_path);
-      retval = -3;
-      goto cleanup_loop;
-    }
-
-    free(read_buffer);
-    read_buffer = NULL;
-
     // Obtiene el bloque físico vinculado al actual bloque lógico de la
     // iteración
     char physical_block_from_logical_path[PATH_MAX];
@@ -256,36 +235,50 @@ int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag,
              sizeof(physical_block_from_logical_path), "block%04d",
              physical_block);
 
-    // Verifica que blocks_hash_index contenga el hash
-    if (!config_has_property(hash_index_config, hash)) {
+    // Verifica que el índice contenga el hash
+    int64_t indexed_block = block_index_lookup(digest);
+    if (indexed_block < 0) {
       // Registro del nuevo Hash
-      config_set_value(hash_index_config, hash,
-                       physical_block_from_logical_path);
+      if (block_index_insert(digest, (uint32_t)physical_block) != 0) {
+        log_error(g_storage_logger,
+                  "## Query ID: %" PRIu32
+                  " - No se pudo registrar el hash del bloque físico %s.",
+                  query_id, physical_block_from_logical_path);
+        retval = -4;
+        goto cleanup_all;
+      }
 
       log_info(g_storage_logger,
                "## Query ID: %" PRIu32 " - Hash registrado para el bloque "
-               "físico %s en blocks hash index config.",
+               "físico %s en el índice de bloques.",
                query_id, physical_block_from_logical_path);
-
-      goto cleanup_loop;
-    }
-
-    // Obtiene el bloque físico vinculado al hash en hash index config
-    physical_block_from_hash =
-        strdup(config_get_string_value(hash_index_config, hash));
-    if (physical_block_from_hash == NULL) {
-      log_error(g_storage_logger,
-                "## Query ID: %" PRIu32
-                " - Error al duplicar cadena para bloque físico desde hash "
-                "index config.",
-                query_id);
-      retval = -4;
-      goto cleanup_loop;
+      continue;
     }
 
     // Si ambos bloques físicos son diferentes, debe deduplicar
-    if (strcmp(physical_block_from_hash, physical_block_from_logical_path) !=
-        0) {
+    if (indexed_block != physical_block) {
+      char physical_block_from_hash[PATH_MAX];
+      snprintf(physical_block_from_hash, sizeof(physical_block_from_hash),
+               "block%04d", (int)indexed_block);
+
+      // Con VERIFY_DEDUP un hash igual no alcanza: se comparan los bytes
+      if (g_storage_config->verify_dedup) {
+        int same_content = blocks_have_same_content(
+            query_id, logical_block_path, physical_block_from_hash);
+        if (same_content < 0) {
+          retval = -9;
+          goto cleanup_all;
+        }
+        if (!same_content) {
+          log_warning(g_storage_logger,
+                      "## Query ID: %" PRIu32
+                      " - Colisión de hash: %s no coincide con el bloque "
+                      "físico %s, se mantiene sin deduplicar.",
+                      query_id, logical_block_path, physical_block_from_hash);
+          continue;
+        }
+      }
+
       // El hash existe, pero apunta a otro bloque físico. Reasignamos el
       // bloque lógico.
       log_debug(g_storage_logger,
@@ -301,23 +294,12 @@ int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag,
                   " - Fallo en la reasignación del link para %s.",
                   query_id, logical_block_path);
         retval = -5;
-        goto cleanup_loop;
-      }
-
-      int32_t new_physical_id =
-          get_physical_block_number(physical_block_from_hash);
-      if (new_physical_id < 0) {
-        log_error(g_storage_logger,
-                  "## Query ID: %" PRIu32
-                  " - No se pudo obtener el ID del nuevo bloque físico %s.",
-                  query_id, physical_block_from_hash);
-        retval = -6;
-        goto cleanup_loop;
+        goto cleanup_all;
       }
 
       // Actualiza la metadata con el ID del bloque físico compartido y la
       // cantidad de bloques
-      metadata->blocks[logical_block] = new_physical_id;
+      metadata->blocks[logical_block] = (int)indexed_block;
       log_debug(g_storage_logger,
                 "## Query ID: %" PRIu32
                 " - Actualizando metadata de %s:%s - Bloque lógico %d a "
@@ -334,7 +316,7 @@ int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag,
                   "en el bitmap.",
                   query_id, physical_block_from_logical_path);
         retval = -7;
-        goto cleanup_loop;
+        goto cleanup_all;
       }
 
       log_info(g_storage_logger,
@@ -350,30 +332,169 @@ int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag,
                " - Bloque %s ya está correctamente asociado.",
                query_id, logical_block_path);
     }
-
-  cleanup_loop:
-    if (physical_block_from_hash)
-      free(physical_block_from_hash);
-    if (hash)
-      free(hash);
-    if (read_buffer)
-      free(read_buffer);
-
-    if (retval < 0)
-      goto cleanup_all;
   }
 
-  config_save(hash_index_config);
-
 cleanup_all:
-  if (hash_index_config)
-    config_destroy(hash_index_config);
+  // Como antes con el config: los hashes nuevos sólo se persisten si el
+  // commit terminó bien
+  if (retval == 0) {
+    if (block_index_commit() != 0) {
+      log_error(g_storage_logger,
+                "## Query ID: %" PRIu32
+                " - No se pudo persistir el índice de hashes de bloques",
+                query_id);
+      retval = -8;
+    }
+  } else {
+    block_index_rollback();
+  }
 unlock_hash_index:
   pthread_mutex_unlock(&g_blocks_hash_index_mutex);
+clean_digests:
+  free(digests);
 end:
   return retval;
 }
 
+typedef struct {
+  uint32_t query_id;
+  const char *name;
+  const char *tag;
+  t_block_digest *digests;
+  int block_count;
+  int next_block; // Próximo bloque lógico sin asignar a un hilo
+  bool failed;
+  pthread_mutex_t mutex;
+} t_commit_hash_job;
+
+static void *hash_blocks_worker(void *arg) {
+  t_commit_hash_job *job = arg;
+
+  char *read_buffer = malloc(g_storage_config->block_size);
+  if (read_buffer == NULL) {
+    log_error(g_storage_logger,
+              "## Query ID: %" PRIu32
+              " - Error de asignación de memoria para leer los bloques",
+              job->query_id);
+    pthread_mutex_lock(&job->mutex);
+    job->failed = true;
+    pthread_mutex_unlock(&job->mutex);
+    return NULL;
+  }
+
+  while (true) {
+    pthread_mutex_lock(&job->mutex);
+    if (job->failed || job->next_block >= job->block_count) {
+      pthread_mutex_unlock(&job->mutex);
+      break;
+    }
+    int logical_block = job->next_block++;
+    pthread_mutex_unlock(&job->mutex);
+
+    char logical_block_path[PATH_MAX];
+    snprintf(logical_block_path, sizeof(logical_block_path),
+             "%s/files/%s/%s/logical_blocks/%04d.dat",
+             g_storage_config->mount_point, job->name, job->tag,
+             logical_block);
+
+    if (read_block_content(job->query_id, logical_block_path,
+                           g_storage_config->block_size, read_buffer) < 0) {
+      pthread_mutex_lock(&job->mutex);
+      job->failed = true;
+      pthread_mutex_unlock(&job->mutex);
+      break;
+    }
+
+    block_index_digest(read_buffer, (size_t)g_storage_config->block_size,
+                       &job->digests[logical_block]);
+  }
+
+  free(read_buffer);
+  return NULL;
+}
+
+int hash_logical_blocks(uint32_t query_id, const char *name, const char *tag,
+                        int block_count, t_block_digest *digests) {
+  t_commit_hash_job job = {
+      .query_id = query_id,
+      .name = name,
+      .tag = tag,
+      .digests = digests,
+      .block_count = block_count,
+      .next_block = 0,
+      .failed = false,
+  };
+  pthread_mutex_init(&job.mutex, NULL);
+
+  int helpers = g_storage_config->commit_threads - 1;
+  if (helpers > block_count - 1)
+    helpers = block_count - 1;
+  if (helpers < 0)
+    helpers = 0;
+
+  pthread_t *threads = NULL;
+  int started = 0;
+  if (helpers > 0) {
+    threads = malloc(sizeof(pthread_t) * helpers);
+  }
+  for (int i = 0; threads && i < helpers; i++) {
+    // Si no se puede crear un hilo, los demás (y este) hacen su parte
+    if (pthread_create(&threads[started], NULL, hash_blocks_worker, &job) == 0)
+      started++;
+  }
+
+  // El hilo del cliente también lee y hashea
+  hash_blocks_worker(&job);
+
+  for (int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  free(threads);
+  pthread_mutex_destroy(&job.mutex);
+
+  log_debug(g_storage_logger,
+            "## Query ID: %" PRIu32 " - %d bloques de %s:%s hasheados con %d "
+            "hilos",
+            query_id, block_count, name, tag, started + 1);
+
+  return job.failed ? -1 : 0;
+}
+
+int blocks_have_same_content(uint32_t query_id, const char *logical_block_path,
+                             const char *physical_block_name) {
+  int retval = -1;
+  uint32_t block_size = g_storage_config->block_size;
+
+  char physical_block_path[PATH_MAX];
+  snprintf(physical_block_path, sizeof(physical_block_path),
+           "%s/physical_blocks/%s.dat", g_storage_config->mount_point,
+           physical_block_name);
+
+  char *logical_content = malloc(block_size);
+  char *physical_content = malloc(block_size);
+  if (!logical_content || !physical_content) {
+    log_error(g_storage_logger,
+              "## Query ID: %" PRIu32
+              " - Error de asignación de memoria para comparar bloques",
+              query_id);
+    goto clean_buffers;
+  }
+
+  if (read_block_content(query_id, logical_block_path, block_size,
+                         logical_content) < 0 ||
+      read_block_content(query_id, physical_block_path, block_size,
+                         physical_content) < 0) {
+    goto clean_buffers;
+  }
+
+  retval = memcmp(logical_content, physical_content, block_size) == 0;
+
+clean_buffers:
+  free(logical_content);
+  free(physical_content);
+  return retval;
+}
+
 int read_block_content(uint32_t query_id, const char *logical_block_path,
                        uint32_t block_size, char *read_buffer) {
   int retval = 0;
@@ -592,7 +713,10 @@ int free_ph_block_if_unused(uint32_t query_id, char *physical_block_name) {
     return -3;
   }
 
-  bitarray_clean_bit(bitmap, (off_t)physical_block_id);
+  // El contenido del bloque libre va a cambiar: su hash no puede seguir en el
+  // índice. El borrado se persiste junto con el resto del commit
+  block_index_forget_block_locked((uint32_t)physical_block_id);
+  free_bitmap_bit(bitmap, (off_t)physical_block_id);
 
   if (bitmap_persist(bitmap, bitmap_buffer) < 0) {
     log_error(g_storage_logger,
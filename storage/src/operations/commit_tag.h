@@ -2,13 +2,13 @@
 #define STORAGE_OPERATIONS_COMMIT_TAG_H_
 
 #include <commons/config.h>
-#include <commons/crypto.h>
 #include <dirent.h>
 #include "connection/serialization.h"
 #include "connection/protocol.h"
 #include "globals/globals.h"
 #include "server/server.h"
 #include "utils/filesystem_utils.h"
+#include "utils/block_index.h"
 
 /**
  * Maneja la solicitud de COMMIT_TAG de un cliente.
@@ -56,6 +56,33 @@ int deserialize_tag_commit_request(t_package *package, uint32_t *query_id, char
  */
 int deduplicate_blocks(uint32_t query_id, const char *name, const char *tag, t_file_metadata *metadata);
 
+/**
+ * Lee y hashea todos los bloques lógicos de un file:tag repartiéndolos entre
+ * g_storage_config->commit_threads hilos (el que llama es uno de ellos).
+ * No toca el índice de hashes ni los links.
+ *
+ * @param query_id ID de consulta.
+ * @param name Nombre del archivo.
+ * @param tag Tag del archivo.
+ * @param block_count Cantidad de bloques lógicos.
+ * @param digests Array de block_count donde queda el hash de cada bloque lógico.
+ * @return int 0 en éxito, o -1 si no se pudo leer algún bloque.
+ */
+int hash_logical_blocks(uint32_t query_id, const char *name, const char *tag,
+                        int block_count, t_block_digest *digests);
+
+/**
+ * Compara byte a byte un bloque lógico con un bloque físico, para confirmar
+ * que un hash repetido es contenido repetido (VERIFY_DEDUP).
+ *
+ * @param query_id ID de consulta.
+ * @param logical_block_path Ruta completa al bloque lógico.
+ * @param physical_block_name Nombre del bloque físico (blockXXXX).
+ * @return int 1 si son iguales, 0 si difieren, o -1 si no se pudieron leer.
+ */
+int blocks_have_same_content(uint32_t query_id, const char *logical_block_path,
+                             const char *physical_block_name);
+
 /**
  * Lee el contenido de un bloque lógico dado por su ruta.
  * Abre y lee el archivo, llenando el buffer proporcionado. Si el tamaño leído es
@@ -108,7 +135,8 @@ int update_logical_block_link(uint32_t query_id, const char *logical_block_path,
  * Actualiza el estado de un bloque físico en el bitmap si es necesario.
  * Verifica cuántos hard links (referencias) apuntan al bloque físico. Si el
  * número de links es 1 (solo la referencia del propio bloque), lo marca como
- * libre en el bitmap.
+ * libre en el bitmap y quita su hash del índice de bloques. Se llama con
+ * g_blocks_hash_index_mutex tomado.
  * 
  * @param query_id ID de consulta.
  * @param physical_block_name Nombre del bloque físico a verificar (ej: "block0042").
@@ -16,7 +16,8 @@ int _create_file(uint32_t query_id, const char *name, const char *tag,
     return result;
   }
 
-  if (create_metadata_file(mount_point, name, tag, NULL) != 0) {
+  if (create_metadata_file(mount_point, name, tag, 0, NULL, 0, IN_PROGRESS) !=
+      0) {
     log_error(g_storage_logger,
               "Error al crear el metadata del archivo %s con tag %s", name,
               tag);
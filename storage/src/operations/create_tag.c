@@ -83,10 +83,9 @@ int create_tag(uint32_t query_id, const char *file_src, const char *tag_src,
     goto cleanup_source_lock;
   }
   
-  char *block_array_str = config_get_string_value(metadata_src->config, "BLOCKS");
-  
-  if(create_metadata(file_dst, tag_dst, metadata_src->size, metadata_src->block_count, block_array_str,
-                 "WORK_IN_PROGRESS", g_storage_config->mount_point) < 0) {
+  if (create_metadata_file(g_storage_config->mount_point, file_dst, tag_dst,
+                           metadata_src->size, metadata_src->blocks,
+                           metadata_src->block_count, IN_PROGRESS) < 0) {
     log_error(g_storage_logger, "## %u - No se pudo crear el metadata para %s:%s",
               query_id, file_dst, tag_dst);
     retval = -3;
@@ -177,28 +176,3 @@ t_package *handle_create_tag_op_package(t_package *package) {
 
   return response;
 }
-
-int create_metadata(const char *name, const char *tag, int size, int numb_blocks, char *blocks_array_str, char *status, char *mount_point) {
-    int retval = 0;
-
-    char **blocks_array = string_get_string_as_array(blocks_array_str);
-    if(string_array_size(blocks_array) != numb_blocks) {
-        retval = -1;
-        goto cleanup_array;
-    }
-
-    char metadata_path[PATH_MAX];
-    snprintf(metadata_path, sizeof(metadata_path), "%s/files/%s/%s/metadata.config", mount_point, name, tag);
-    FILE* metadata_file = fopen(metadata_path, "w");
-    if (metadata_file == NULL) {
-        retval = -2;
-        goto cleanup_array;
-    }
-
-    fprintf(metadata_file, "SIZE=%d\nBLOCKS=%s\nESTADO=%s\n", size, blocks_array_str, status);
-    fclose(metadata_file);
-
-cleanup_array:
-    string_array_destroy(blocks_array);
-    return retval;
-}
\ No newline at end of file
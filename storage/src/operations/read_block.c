@@ -123,9 +123,132 @@ end:
   return retval;
 }
 
+t_package *handle_read_blocks_request(t_package *package) {
+  uint32_t query_id;
+  char *name = NULL;
+  char *tag = NULL;
+  uint32_t *block_numbers = NULL;
+  uint32_t count = 0;
+
+  if (deserialize_blocks_read_request(package, &query_id, &name, &tag, &block_numbers, &count) < 0) {
+    return NULL;
+  }
+
+  size_t data_size = (size_t)count * g_storage_config->block_size;
+  void *read_buffer = malloc(data_size + 1);
+  if (!read_buffer) {
+    log_error(g_storage_logger, "## Query ID: %" PRIu32 " - Fallo al asignar memoria para lectura de %" PRIu32 " bloques.", query_id, count);
+    free(name);
+    free(tag);
+    free(block_numbers);
+    return NULL;
+  }
+
+  int operation_result = execute_blocks_read(name, tag, query_id, block_numbers, count, read_buffer);
+
+  free(name);
+  free(tag);
+  free(block_numbers);
+
+  if (operation_result != 0) {
+    char *error_message = string_from_format("READ_BLOCK error: %s", storage_error_message(operation_result));
+    t_package *response = package_create_empty(STORAGE_OP_ERROR);
+    if (!response) {
+      log_error(g_storage_logger,
+                "## Query ID: %" PRIu32 " - Fallo al crear paquete de error.",
+                query_id);
+      free(read_buffer);
+      free(error_message);
+      return NULL;
+    }
+    package_add_uint32(response, query_id);
+    package_add_string(response, error_message);
+    free(error_message);
+    package_reset_read_offset(response);
+    free(read_buffer);
+    return response;
+  }
+
+  t_package *response = package_create_empty(STORAGE_OP_BLOCK_READV_RES);
+  if (!response ||
+      !package_add_uint32(response, (uint32_t)g_storage_config->block_size) ||
+      !package_add_uint32(response, count) ||
+      !package_add_data(response, read_buffer, data_size)) {
+    log_error(g_storage_logger,
+              "## Query ID: %" PRIu32 " - Fallo al armar la respuesta de READ BLOCKS.",
+              query_id);
+    if (response)
+      package_destroy(response);
+    free(read_buffer);
+    return NULL;
+  }
+
+  free(read_buffer);
+  package_reset_read_offset(response);
+
+  return response;
+}
+
+int deserialize_blocks_read_request(t_package *package, uint32_t *query_id, char **name, char **tag,
+                                    uint32_t **block_numbers, uint32_t *count) {
+  uint32_t block_number;
+
+  *name = NULL;
+  *tag = NULL;
+  *block_numbers = NULL;
+
+  // El encabezado (query_id, name, tag) es el mismo que el de READ_BLOCK
+  if (!package_read_uint32(package, query_id)) {
+    log_error(g_storage_logger, "## Error al deserializar query_id de READ_BLOCKS");
+    return -1;
+  }
+
+  *name = package_read_string(package);
+  *tag = *name ? package_read_string(package) : NULL;
+  if (*tag == NULL) {
+    log_error(g_storage_logger, "## Query ID: %" PRIu32 " - Error al deserializar el file:tag de READ_BLOCKS", *query_id);
+    goto error;
+  }
+
+  if (!package_read_uint32(package, count) || *count == 0 || *count > STORAGE_MAX_VECTOR_BLOCKS) {
+    log_error(g_storage_logger, "## Query ID: %" PRIu32 " - Cantidad de bloques inválida en READ_BLOCKS", *query_id);
+    goto error;
+  }
+
+  *block_numbers = malloc(*count * sizeof(uint32_t));
+  if (*block_numbers == NULL) {
+    goto error;
+  }
+
+  for (uint32_t i = 0; i < *count; i++) {
+    if (!package_read_uint32(package, &block_number)) {
+      log_error(g_storage_logger, "## Query ID: %" PRIu32 " - Error al deserializar el número bloque de READ_BLOCKS", *query_id);
+      goto error;
+    }
+    (*block_numbers)[i] = block_number;
+  }
+
+  return 0;
+
+error:
+  free(*block_numbers);
+  *block_numbers = NULL;
+  free(*tag);
+  *tag = NULL;
+  free(*name);
+  *name = NULL;
+  return -1;
+}
+
 int execute_block_read(const char *name, const char *tag, uint32_t query_id,
                         uint32_t block_number, void *read_buffer) {
+  return execute_blocks_read(name, tag, query_id, &block_number, 1, read_buffer);
+}
+
+int execute_blocks_read(const char *name, const char *tag, uint32_t query_id,
+                        const uint32_t *block_numbers, uint32_t count, void *read_buffer) {
   int retval = 0;
+  uint32_t blocks_read = 0;
 
   //lock_file(name, tag, false);
   log_debug(g_storage_logger, "/**** Query ID %" PRIu32 ": Lock de lectura adquirido.", query_id);
@@ -148,19 +271,27 @@ int execute_block_read(const char *name, const char *tag, uint32_t query_id,
     goto cleanup_unlock;
   }
 
-  if ((int)block_number >= metadata->block_count) {
-    log_error(g_storage_logger,
-              "## Query ID: %" PRIu32 " - El bloque lógico %" PRIu32 " no existe en %s:%s. Fuera "
-              "de rango [0, %d]",
-              query_id, block_number, name, tag, metadata->block_count);
-    retval = READ_OUT_OF_BOUNDS;
-    goto cleanup_metadata;
+  for (uint32_t i = 0; i < count; i++) {
+    if ((int)block_numbers[i] >= metadata->block_count) {
+      log_error(g_storage_logger,
+                "## Query ID: %" PRIu32 " - El bloque lógico %" PRIu32 " no existe en %s:%s. Fuera "
+                "de rango [0, %d]",
+                query_id, block_numbers[i], name, tag, metadata->block_count);
+      retval = READ_OUT_OF_BOUNDS;
+      goto cleanup_metadata;
+    }
   }
 
   destroy_file_metadata(metadata);
 
-  if (read_from_logical_block(query_id, name, tag, block_number, read_buffer) < 0) {
-    retval = -1;
+  // Cada bloque queda a continuación del anterior; el '\0' que agrega
+  // read_from_logical_block lo pisa la lectura del bloque siguiente
+  for (; blocks_read < count; blocks_read++) {
+    void *block_buffer = (char *)read_buffer + (size_t)blocks_read * g_storage_config->block_size;
+    if (read_from_logical_block(query_id, name, tag, block_numbers[blocks_read], block_buffer) < 0) {
+      retval = -1;
+      break;
+    }
   }
 
   goto cleanup_unlock;
@@ -171,7 +302,7 @@ cleanup_metadata:
 cleanup_unlock:
   //unlock_file(name, tag);
   log_debug(g_storage_logger, "/**** Query ID %" PRIu32 ": Lock de lectura liberado.", query_id);
-  usleep(g_storage_config->block_access_delay/2 * 1000);
+  usleep(g_storage_config->block_access_delay/2 * 1000 * (blocks_read > 0 ? blocks_read : 1));
 
   return retval;
 }
@@ -31,6 +31,27 @@ t_package *handle_read_block_request(t_package *package);
  */
 int deserialize_block_read_request(t_package *package, uint32_t *query_id, char **name, char **tag, uint32_t *block_number);
 
+/**
+ * Maneja la solicitud READ BLOCKS: lee varios bloques de un mismo File:Tag con
+ * una sola lectura de metadata y responde un único paquete con el tamaño de
+ * bloque, la cantidad y el contenido de los bloques, uno a continuación del otro
+ * y en el orden pedido.
+ *
+ * @param package El paquete serializado recibido del Worker.
+ * @return t_package* La respuesta (READV_RES o STORAGE_OP_ERROR), o NULL ante errores irrecuperables.
+ */
+t_package *handle_read_blocks_request(t_package *package);
+
+/**
+ * Deserializa una solicitud READ BLOCKS: ID, nombre, tag, cantidad y números de bloque.
+ * 'name', 'tag' y 'block_numbers' se asignan dinámicamente y deben ser liberados.
+ * La cantidad debe estar entre 1 y STORAGE_MAX_VECTOR_BLOCKS.
+ *
+ * @return int 0 si la deserialización es exitosa, -1 si falla (no queda memoria asignada).
+ */
+int deserialize_blocks_read_request(t_package *package, uint32_t *query_id, char **name, char **tag,
+                                    uint32_t **block_numbers, uint32_t *count);
+
 /**
  * Ejecuta la lógica de alto nivel para leer un bloque lógico.
  * Se encarga de: tomar el lock del archivo, validar la existencia del directorio y
@@ -46,6 +67,18 @@ int deserialize_block_read_request(t_package *package, uint32_t *query_id, char
  */
 int execute_block_read(const char *name, const char *tag, uint32_t query_id, uint32_t block_number, void *read_buffer);
 
+/**
+ * Igual que execute_block_read pero para varios bloques: valida el directorio,
+ * la metadata y el rango de todos los bloques una sola vez antes de leerlos.
+ *
+ * @param block_numbers Números de bloque lógico a leer.
+ * @param count Cantidad de bloques.
+ * @param read_buffer Buffer de al menos count * BLOCK_SIZE + 1 bytes.
+ * @return int 0 si todas las lecturas fueron exitosas, o un código de error negativo.
+ */
+int execute_blocks_read(const char *name, const char *tag, uint32_t query_id,
+                        const uint32_t *block_numbers, uint32_t count, void *read_buffer);
+
 /**
  * Realiza la lectura física del bloque de datos desde el disco.
  * Abre el archivo binario, lee exactamente el tamaño del bloque en el buffer,
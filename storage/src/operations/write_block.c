@@ -60,6 +60,123 @@ t_package *handle_write_block_request(t_package *package) {
   return response;
 }
 
+t_package *handle_write_blocks_request(t_package *package) {
+  uint32_t query_id;
+  char *name = NULL;
+  char *tag = NULL;
+  t_block_write *writes = NULL;
+  uint32_t count = 0;
+
+  if (deserialize_blocks_write_request(package, &query_id, &name, &tag,
+                                       &writes, &count) < 0) {
+    return NULL;
+  }
+
+  int operation_result = execute_blocks_write(name, tag, query_id, writes, count);
+
+  free(name);
+  free(tag);
+  destroy_block_writes(writes, count);
+
+  if (operation_result != 0) {
+    char *error_message = string_from_format("WRITE_BLOCK error: %s", storage_error_message(operation_result));
+    t_package *response = package_create_empty(STORAGE_OP_ERROR);
+    if (!response) {
+      log_error(g_storage_logger,
+                "## Query ID: %d - Fallo al crear paquete de error.",
+                query_id);
+      free(error_message);
+      return NULL;
+    }
+    package_add_uint32(response, query_id);
+    package_add_string(response, error_message);
+    free(error_message);
+    package_reset_read_offset(response);
+    return response;
+  }
+
+  t_package *response = package_create_empty(STORAGE_OP_BLOCK_WRITEV_RES);
+  if (!response || !package_add_int8(response, (int8_t)operation_result)) {
+    log_error(g_storage_logger,
+              "## Query ID: %d - Fallo al crear paquete de respuesta.",
+              query_id);
+    if (response)
+      package_destroy(response);
+    return NULL;
+  }
+
+  package_reset_read_offset(response);
+
+  return response;
+}
+
+int deserialize_blocks_write_request(t_package *package, uint32_t *query_id,
+                                     char **name, char **tag,
+                                     t_block_write **writes, uint32_t *count) {
+  *name = NULL;
+  *tag = NULL;
+  *writes = NULL;
+
+  if (!package_read_uint32(package, query_id)) {
+    log_error(g_storage_logger,
+              "## Error al deserializar query_id de WRITE_BLOCKS");
+    return -1;
+  }
+
+  *name = package_read_string(package);
+  *tag = *name ? package_read_string(package) : NULL;
+  if (*tag == NULL) {
+    log_error(g_storage_logger,
+              "## Query ID: %d - Error al deserializar el file:tag de WRITE_BLOCKS",
+              *query_id);
+    goto error;
+  }
+
+  if (!package_read_uint32(package, count) || *count == 0 || *count > STORAGE_MAX_VECTOR_BLOCKS) {
+    log_error(g_storage_logger,
+              "## Query ID: %d - Cantidad de bloques inválida en WRITE_BLOCKS",
+              *query_id);
+    goto error;
+  }
+
+  *writes = calloc(*count, sizeof(t_block_write));
+  if (*writes == NULL) {
+    goto error;
+  }
+
+  for (uint32_t i = 0; i < *count; i++) {
+    t_block_write *write = &(*writes)[i];
+    if (!package_read_uint32(package, &write->block_number) ||
+        (write->data = package_read_data(package, &write->size)) == NULL) {
+      log_error(g_storage_logger,
+                "## Query ID: %d - Error al deserializar el bloque %" PRIu32 " de WRITE_BLOCKS",
+                *query_id, i);
+      goto error;
+    }
+  }
+
+  return 0;
+
+error:
+  destroy_block_writes(*writes, *count);
+  *writes = NULL;
+  free(*tag);
+  *tag = NULL;
+  free(*name);
+  *name = NULL;
+  return -1;
+}
+
+void destroy_block_writes(t_block_write *writes, uint32_t count) {
+  if (writes == NULL)
+    return;
+
+  for (uint32_t i = 0; i < count; i++) {
+    free(writes[i].data);
+  }
+  free(writes);
+}
+
 int deserialize_block_write_request(t_package *package, uint32_t *query_id,
                                     char **name, char **tag,
                                     uint32_t *block_number,
@@ -209,8 +326,81 @@ int write_to_logical_block(uint32_t query_id, const char *file_name,
 
 int execute_block_write(const char *name, const char *tag, uint32_t query_id,
                         uint32_t block_number, const void *block_data, size_t data_size){
+  t_block_write write = {
+      .block_number = block_number,
+      .data = (void *)block_data,
+      .size = data_size,
+  };
+
+  return execute_blocks_write(name, tag, query_id, &write, 1);
+}
+
+/**
+ * Si el bloque lógico comparte su bloque físico con otro File:Tag, le reserva
+ * uno nuevo y rehace el hardlink. El bitmap se carga la primera vez que hace
+ * falta y queda cargado (con su mutex tomado) para los bloques siguientes;
+ * lo persiste quien llama.
+ *
+ * @return int 1 si cambió el bloque físico, 0 si no hacía falta o un código negativo si falla.
+ */
+static int detach_shared_block(const char *name, const char *tag, uint32_t query_id,
+                               t_file_metadata *metadata, uint32_t block_number,
+                               t_bitarray **bitmap, char **bitmap_buffer) {
+  char logical_block_path[PATH_MAX];
+  snprintf(logical_block_path, sizeof(logical_block_path),
+           "%s/files/%s/%s/logical_blocks/%04d.dat",
+           g_storage_config->mount_point, name, tag, block_number);
+  int num_hardlinks = ph_block_links(logical_block_path);
+  if (num_hardlinks < 0) {
+    return -1;
+  }
+
+  if (num_hardlinks <= 2) {
+    return 0;
+  }
+
+  if (remove(logical_block_path) != 0) {
+    log_error(g_storage_logger,
+              "## Query ID: %d - No se pudo eliminar el hardlink %s.",
+              query_id, logical_block_path);
+    return -2;
+  }
+
+  if (*bitmap == NULL && bitmap_load(bitmap, bitmap_buffer) < 0) {
+    log_error(g_storage_logger, "# Query ID: %d - Fallo al cargar el bitmap.",
+              query_id);
+    *bitmap = NULL;
+    *bitmap_buffer = NULL;
+    return -3;
+  }
+
+  ssize_t physical_block_index = get_free_bit_index(*bitmap);
+  if (physical_block_index < 0) {
+    log_error(g_storage_logger,
+              "## Query ID: %d - No hay bloques físicos libres disponibles "
+              "en el bitmap.",
+              query_id);
+    return NOT_ENOUGH_SPACE;
+  }
+
+  bitarray_set_bit(*bitmap, (off_t)physical_block_index);
+
+  log_info(g_storage_logger, "Query ID: %" PRIu32 " - Bloque físico reservado - Número de bloque: %zd", query_id, physical_block_index);
+
+  if (create_new_hardlink(query_id, name, tag, block_number, logical_block_path,
+                          physical_block_index) < 0) {
+    return -5;
+  }
+
+  metadata->blocks[block_number] = (uint32_t)physical_block_index;
+  return 1;
+}
+
+int execute_blocks_write(const char *name, const char *tag, uint32_t query_id,
+                         const t_block_write *writes, uint32_t count) {
   t_bitarray *bitmap = NULL;
   char *bitmap_buffer = NULL;
+  bool metadata_changed = false;
   int retval = 0;
 
   //lock_file(name, tag, true);
@@ -242,93 +432,62 @@ int execute_block_write(const char *name, const char *tag, uint32_t query_id,
     goto cleanup_metadata;
   }
 
-  if ((int)block_number >= metadata->block_count) {
-    log_error(g_storage_logger,
-              "## Query ID: %d - El bloque lógico %d no existe en %s:%s. Fuera "
-              "de rango [0, %d]",
-              query_id, block_number, name, tag, metadata->block_count);
-    retval = READ_OUT_OF_BOUNDS;
-    goto cleanup_metadata;
-  }
-
-  char logical_block_path[PATH_MAX];
-  snprintf(logical_block_path, sizeof(logical_block_path),
-           "%s/files/%s/%s/logical_blocks/%04d.dat",
-           g_storage_config->mount_point, name, tag, block_number);
-  int num_hardlinks = ph_block_links(logical_block_path);
-  if (num_hardlinks < 0) {
-    retval = -1;
-    goto cleanup_metadata;
-  }
-
-  if (num_hardlinks > 2) {
-    if (remove(logical_block_path) != 0) {
+  // Se valida todo el pedido antes de tocar el filesystem
+  for (uint32_t i = 0; i < count; i++) {
+    if ((int)writes[i].block_number >= metadata->block_count) {
       log_error(g_storage_logger,
-                "## Query ID: %d - No se pudo eliminar el hardlink %s.",
-                query_id, logical_block_path);
-      retval = -2;
-      goto cleanup_metadata;
-    }
-
-    if (bitmap_load(&bitmap, &bitmap_buffer) < 0) {
-      log_error(g_storage_logger, "# Query ID: %d - Fallo al cargar el bitmap.",
-                query_id);
-      retval = -3;
+                "## Query ID: %d - El bloque lógico %d no existe en %s:%s. Fuera "
+                "de rango [0, %d]",
+                query_id, writes[i].block_number, name, tag, metadata->block_count);
+      retval = READ_OUT_OF_BOUNDS;
       goto cleanup_metadata;
     }
+  }
 
-    ssize_t physical_block_index = get_free_bit_index(bitmap);
-    if (physical_block_index < 0) {
-      log_error(g_storage_logger,
-                "## Query ID: %d - No hay bloques físicos libres disponibles "
-                "en el bitmap.",
-                query_id);
-      retval = NOT_ENOUGH_SPACE;
-      goto unlock_bitmap;
+  for (uint32_t i = 0; i < count; i++) {
+    int detached = detach_shared_block(name, tag, query_id, metadata, writes[i].block_number,
+                                       &bitmap, &bitmap_buffer);
+    if (detached < 0) {
+      retval = detached;
+      break;
     }
-
-    bitarray_set_bit(bitmap, (off_t)physical_block_index);
-
-    if (bitmap_persist(bitmap, bitmap_buffer) < 0) {
-      retval = -4;
-      goto cleanup_bitmap;
+    if (detached > 0) {
+      metadata_changed = true;
     }
+  }
 
-    log_info(g_storage_logger, "Query ID: %" PRIu32 " - Bloque físico reservado - Número de bloque: %zd", query_id, physical_block_index);
-
-    if (create_new_hardlink(query_id, name, tag, block_number, logical_block_path,
-                            physical_block_index) < 0) {
-      retval = -5;
-      goto cleanup_metadata;
-    }
+  // Los bloques reservados hasta acá ya tienen su hardlink: se persisten
+  // aunque el pedido haya fallado a mitad de camino
+  if (bitmap != NULL && bitmap_persist(bitmap, bitmap_buffer) < 0 && retval == 0) {
+    retval = -4;
+  }
 
-    metadata->blocks[block_number] = (uint32_t)physical_block_index;
-    if (save_file_metadata(metadata) < 0) {
-      log_error(g_storage_logger,
-                "## No se pudo guardar el metadata de %s:%s después de "
-                "actualizar bloques.",
-                name, tag);
+  if (metadata_changed && save_file_metadata(metadata) < 0) {
+    log_error(g_storage_logger,
+              "## No se pudo guardar el metadata de %s:%s después de "
+              "actualizar bloques.",
+              name, tag);
+    if (retval == 0) {
       retval = -6;
-      goto cleanup_metadata;
     }
   }
 
+  if (retval != 0) {
+    goto cleanup_metadata;
+  }
+
   destroy_file_metadata(metadata);
 
-  if (write_to_logical_block(query_id, name, tag, block_number, block_data, data_size) < 0) {
-    retval = -7;
+  for (uint32_t i = 0; i < count; i++) {
+    if (write_to_logical_block(query_id, name, tag, writes[i].block_number,
+                               writes[i].data, writes[i].size) < 0) {
+      retval = -7;
+      break;
+    }
   }
 
-
   goto cleanup_unlock;
 
-unlock_bitmap:
-  pthread_mutex_unlock(&g_storage_bitmap_mutex);
-cleanup_bitmap:
-  if (bitmap_buffer)
-    free(bitmap_buffer);
-  if (bitmap)
-    bitarray_destroy(bitmap);
 cleanup_metadata:
   if (metadata)
     destroy_file_metadata(metadata);
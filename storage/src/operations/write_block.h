@@ -13,6 +13,15 @@
 #include "file_locks.h"
 #include "errors.h"
 
+/**
+ * Un bloque a escribir dentro de un pedido WRITE BLOCKS.
+ */
+typedef struct {
+  uint32_t block_number;
+  void *data;
+  size_t size;
+} t_block_write;
+
 /**
  * Maneja la solicitud de operación WRITE BLOCK recibida desde un Worker.
  * Deserializa los datos, invoca la lógica principal de escritura de bloque y
@@ -24,6 +33,29 @@
  */
 t_package *handle_write_block_request(t_package *package);
 
+/**
+ * Maneja la solicitud WRITE BLOCKS: escribe varios bloques de un mismo File:Tag
+ * y responde un único paquete (WRITEV_RES con código 0, o STORAGE_OP_ERROR).
+ *
+ * @param package El paquete serializado recibido del Worker.
+ * @return t_package* El paquete de respuesta, o NULL ante errores irrecuperables.
+ */
+t_package *handle_write_blocks_request(t_package *package);
+
+/**
+ * Deserializa una solicitud WRITE BLOCKS: ID, nombre, tag, cantidad y, por cada
+ * bloque, su número y su contenido. La cantidad debe estar entre 1 y
+ * STORAGE_MAX_VECTOR_BLOCKS.
+ *
+ * @param writes Se asigna con los bloques leídos; liberar con destroy_block_writes.
+ * @return int 0 si la deserialización es exitosa, -1 si falla (no queda memoria asignada).
+ */
+int deserialize_blocks_write_request(t_package *package, uint32_t *query_id,
+                                     char **name, char **tag,
+                                     t_block_write **writes, uint32_t *count);
+
+void destroy_block_writes(t_block_write *writes, uint32_t count);
+
 /**
  * Implementa la lógica principal para la operación WRITE BLOCK del Storage.
  * Valida los permisos, gestiona el espacio libre (bitmap),
@@ -40,6 +72,16 @@ t_package *handle_write_block_request(t_package *package);
 int execute_block_write(const char *name, const char *tag, uint32_t query_id,
                         uint32_t block_number, const void *block_data, size_t data_size);
 
+/**
+ * Igual que execute_block_write pero para varios bloques del mismo File:Tag:
+ * lee y valida la metadata una vez, carga el bitmap sólo si algún bloque
+ * necesita un bloque físico nuevo y persiste bitmap y metadata una sola vez.
+ *
+ * @return int 0 si la operación fue exitosa, negativo si falla (mismos códigos que execute_block_write)
+ */
+int execute_blocks_write(const char *name, const char *tag, uint32_t query_id,
+                         const t_block_write *writes, uint32_t count);
+
 /**
  * Escribe el contenido de un bloque en el disco, a través del hardlink lógico.
  * Asume que el bloque físico ya está apuntado por el hardlink lógico.
@@ -61,6 +61,12 @@ void *handle_client(void *arg) {
     case STORAGE_OP_BLOCK_READ_REQ:
       response = handle_read_block_request(request);
       break;
+    case STORAGE_OP_BLOCK_READV_REQ:
+      response = handle_read_blocks_request(request);
+      break;
+    case STORAGE_OP_BLOCK_WRITEV_REQ:
+      response = handle_write_blocks_request(request);
+      break;
     case STORAGE_OP_TAG_DELETE_REQ:
       response = handle_delete_tag_op_package(request);
       break;
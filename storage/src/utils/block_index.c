@@ -0,0 +1,885 @@
+#include "block_index.h"
+#include "../globals/globals.h"
+#include <commons/collections/dictionary.h>
+#include <commons/config.h>
+#include <commons/string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <openssl/evp.h>
+#include <stdio.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utils/logger.h>
+
+#define BLOCK_INDEX_INITIAL_CAPACITY 1024 // Potencia de 2
+#define BLOCK_INDEX_COMPACT_MIN 1024      // Registros antes de pensar en compactar
+#define BLOCK_INDEX_READ_BATCH 4096       // Registros por lectura al cargar
+
+// Constantes del hash FAST
+#define FAST_SEED_1 0xa0761d6478bd642fULL
+#define FAST_SEED_2 0xe7037ed1a0b428dbULL
+#define FAST_PRIME_1 0x8ebc6af09c88c6e3ULL
+#define FAST_PRIME_2 0x589965cc75374cc3ULL
+#define FAST_PRIME_3 0x1d8e4e27c47d124fULL
+
+typedef struct {
+  char *mount_point;
+  int fd; // Log abierto en O_APPEND
+  t_block_index_record *slots; // block == BLOCK_INDEX_NONE: slot vacío
+  size_t capacity;
+  size_t count;
+  size_t log_records; // Registros en disco, vivos y muertos
+  // Digest de cada bloque físico, para borrarlo al liberar el bloque
+  t_block_digest *block_digests;
+  bool *block_has_digest;
+  size_t block_capacity;
+  // Registros todavía no escritos en el log
+  t_block_index_record *pending;
+  size_t pending_count;
+  size_t pending_capacity;
+} t_block_index;
+
+static t_block_index block_index = {.fd = -1};
+
+// Algoritmo de block_index_digest; no se reinicia al cerrar el índice
+static t_block_hash_algorithm hash_algorithm = BLOCK_HASH_MD5;
+static EVP_MD *hash_md = NULL; // Digest de OpenSSL ya resuelto (NULL en FAST)
+
+// Indexados por t_block_hash_algorithm
+static const char *algorithm_names[] = {"MD5", "SHA256", "BLAKE2B", "FAST"};
+static const char *openssl_names[] = {"MD5", "SHA256", "BLAKE2B-512", NULL};
+
+static int table_remove(const t_block_digest *digest);
+
+static size_t digest_home(const t_block_digest *digest) {
+  // Los digests ya están bien distribuidos: alcanzan los primeros 8 bytes
+  uint64_t hash;
+  memcpy(&hash, digest->bytes, sizeof(hash));
+  return (size_t)hash & (block_index.capacity - 1);
+}
+
+static bool digest_equals(const t_block_digest *a, const t_block_digest *b) {
+  return memcmp(a->bytes, b->bytes, BLOCK_INDEX_DIGEST_SIZE) == 0;
+}
+
+// Slot del digest, o el slot vacío donde iría
+static size_t table_find(const t_block_digest *digest) {
+  size_t mask = block_index.capacity - 1;
+  size_t i = digest_home(digest);
+
+  while (block_index.slots[i].block != BLOCK_INDEX_NONE &&
+         !digest_equals(&block_index.slots[i].digest, digest)) {
+    i = (i + 1) & mask;
+  }
+
+  return i;
+}
+
+static t_block_index_record *new_slots(size_t capacity) {
+  t_block_index_record *slots = malloc(sizeof(t_block_index_record) * capacity);
+  if (!slots) {
+    return NULL;
+  }
+  for (size_t i = 0; i < capacity; i++) {
+    slots[i].block = BLOCK_INDEX_NONE;
+  }
+  return slots;
+}
+
+static int table_grow(void) {
+  size_t new_capacity = block_index.capacity
+                            ? block_index.capacity * 2
+                            : BLOCK_INDEX_INITIAL_CAPACITY;
+  t_block_index_record *new_table = new_slots(new_capacity);
+  if (!new_table) {
+    return -1;
+  }
+
+  t_block_index_record *old_slots = block_index.slots;
+  size_t old_capacity = block_index.capacity;
+  block_index.slots = new_table;
+  block_index.capacity = new_capacity;
+
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old_slots[i].block != BLOCK_INDEX_NONE) {
+      block_index.slots[table_find(&old_slots[i].digest)] = old_slots[i];
+    }
+  }
+
+  free(old_slots);
+  return 0;
+}
+
+static int reverse_reserve(uint32_t block) {
+  if (block < block_index.block_capacity) {
+    return 0;
+  }
+
+  size_t new_capacity = block_index.block_capacity ? block_index.block_capacity : 256;
+  while (new_capacity <= block) {
+    new_capacity *= 2;
+  }
+
+  t_block_digest *digests =
+      realloc(block_index.block_digests, sizeof(t_block_digest) * new_capacity);
+  if (!digests) {
+    return -1;
+  }
+  block_index.block_digests = digests;
+
+  bool *has_digest =
+      realloc(block_index.block_has_digest, sizeof(bool) * new_capacity);
+  if (!has_digest) {
+    return -1;
+  }
+  memset(has_digest + block_index.block_capacity, 0,
+         sizeof(bool) * (new_capacity - block_index.block_capacity));
+  block_index.block_has_digest = has_digest;
+  block_index.block_capacity = new_capacity;
+
+  return 0;
+}
+
+static void reverse_clear(uint32_t block, const t_block_digest *digest) {
+  if (block < block_index.block_capacity &&
+      block_index.block_has_digest[block] &&
+      digest_equals(&block_index.block_digests[block], digest)) {
+    block_index.block_has_digest[block] = false;
+  }
+}
+
+static int table_put(const t_block_digest *digest, uint32_t block) {
+  if (reverse_reserve(block) != 0) {
+    return -1;
+  }
+
+  // Un bloque tiene un solo contenido: su digest anterior ya no vale
+  if (block_index.block_has_digest[block] &&
+      !digest_equals(&block_index.block_digests[block], digest)) {
+    t_block_digest previous = block_index.block_digests[block];
+    table_remove(&previous);
+  }
+
+  if ((block_index.count + 1) * 2 > block_index.capacity &&
+      table_grow() != 0) {
+    return -1;
+  }
+
+  size_t i = table_find(digest);
+  if (block_index.slots[i].block == BLOCK_INDEX_NONE) {
+    block_index.count++;
+  } else {
+    reverse_clear(block_index.slots[i].block, digest);
+  }
+
+  block_index.slots[i].digest = *digest;
+  block_index.slots[i].block = block;
+  block_index.block_digests[block] = *digest;
+  block_index.block_has_digest[block] = true;
+
+  return 0;
+}
+
+/*
+ * Borra con corrimiento hacia atrás: las entradas siguientes del cluster que
+ * podrían ocupar el hueco se mueven, así no hacen falta lápidas en la tabla.
+ */
+static int table_remove(const t_block_digest *digest) {
+  if (block_index.capacity == 0) {
+    return 0;
+  }
+
+  size_t mask = block_index.capacity - 1;
+  size_t hole = table_find(digest);
+  if (block_index.slots[hole].block == BLOCK_INDEX_NONE) {
+    return 0;
+  }
+
+  reverse_clear(block_index.slots[hole].block, digest);
+
+  size_t j = hole;
+  while (true) {
+    j = (j + 1) & mask;
+    if (block_index.slots[j].block == BLOCK_INDEX_NONE) {
+      break;
+    }
+    size_t home = digest_home(&block_index.slots[j].digest);
+    if (((j - home) & mask) >= ((j - hole) & mask)) {
+      block_index.slots[hole] = block_index.slots[j];
+      hole = j;
+    }
+  }
+
+  block_index.slots[hole].block = BLOCK_INDEX_NONE;
+  block_index.count--;
+  return 1;
+}
+
+static void apply_record(const t_block_index_record *record) {
+  if (record->block == BLOCK_INDEX_NONE) {
+    table_remove(&record->digest);
+  } else {
+    table_put(&record->digest, record->block);
+  }
+}
+
+static int write_all(int fd, const void *data, size_t size) {
+  const char *bytes = data;
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    bytes += written;
+    size -= (size_t)written;
+  }
+  return 0;
+}
+
+static int append_records(const t_block_index_record *records, size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+
+  if (write_all(block_index.fd, records, sizeof(*records) * count) != 0 ||
+      fdatasync(block_index.fd) != 0) {
+    log_error(g_storage_logger,
+              "No se pudo agregar %zu registros al índice de bloques", count);
+    return -1;
+  }
+
+  block_index.log_records += count;
+  return 0;
+}
+
+static int pending_push(const t_block_index_record *record) {
+  if (block_index.pending_count == block_index.pending_capacity) {
+    size_t new_capacity =
+        block_index.pending_capacity ? block_index.pending_capacity * 2 : 64;
+    t_block_index_record *pending = realloc(
+        block_index.pending, sizeof(t_block_index_record) * new_capacity);
+    if (!pending) {
+      return -1;
+    }
+    block_index.pending = pending;
+    block_index.pending_capacity = new_capacity;
+  }
+
+  block_index.pending[block_index.pending_count++] = *record;
+  return 0;
+}
+
+static char *index_path(const char *mount_point, const char *file_name) {
+  return string_from_format("%s/%s", mount_point, file_name);
+}
+
+static int open_log_for_append(const char *path) {
+  block_index.fd = open(path, O_WRONLY | O_APPEND);
+  if (block_index.fd < 0) {
+    log_error(g_storage_logger, "No se pudo abrir el índice de bloques %s",
+              path);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Escribe header + entradas vivas en un temporal y lo renombra sobre el log
+ */
+static int write_snapshot(const char *path) {
+  int retval = 0;
+
+  char *tmp_path = string_from_format("%s.tmp", path);
+  FILE *file = fopen(tmp_path, "wb");
+  if (!file) {
+    log_error(g_storage_logger, "No se pudo crear el archivo %s", tmp_path);
+    retval = -1;
+    goto clean_path;
+  }
+
+  t_block_index_header header = {
+      .magic = BLOCK_INDEX_MAGIC,
+      .version = BLOCK_INDEX_VERSION,
+      .algorithm = hash_algorithm,
+  };
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    retval = -1;
+  }
+
+  for (size_t i = 0; retval == 0 && i < block_index.capacity; i++) {
+    if (block_index.slots[i].block != BLOCK_INDEX_NONE &&
+        fwrite(&block_index.slots[i], sizeof(t_block_index_record), 1, file) != 1) {
+      retval = -1;
+    }
+  }
+
+  if (fflush(file) != 0 || fsync(fileno(file)) != 0) {
+    retval = -1;
+  }
+  fclose(file);
+
+  if (retval != 0) {
+    log_error(g_storage_logger, "No se pudo escribir el índice de bloques %s",
+              tmp_path);
+    remove(tmp_path);
+    goto clean_path;
+  }
+
+  if (rename(tmp_path, path) != 0) {
+    log_error(g_storage_logger, "No se pudo reemplazar el índice de bloques %s",
+              path);
+    remove(tmp_path);
+    retval = -1;
+  }
+
+clean_path:
+  free(tmp_path);
+  return retval;
+}
+
+static bool needs_compaction(void) {
+  return block_index.log_records > BLOCK_INDEX_COMPACT_MIN &&
+         block_index.log_records > block_index.count * 2;
+}
+
+static bool parse_legacy_digest(const char *hex, t_block_digest *digest) {
+  if (strlen(hex) != BLOCK_INDEX_DIGEST_SIZE * 2) {
+    return false;
+  }
+  for (int i = 0; i < BLOCK_INDEX_DIGEST_SIZE; i++) {
+    unsigned int byte;
+    if (sscanf(hex + i * 2, "%2x", &byte) != 1) {
+      return false;
+    }
+    digest->bytes[i] = (uint8_t)byte;
+  }
+  return true;
+}
+
+static int legacy_failures;
+
+static void migrate_legacy_entry(char *hash, void *value) {
+  t_block_digest digest;
+  uint32_t block;
+
+  if (!parse_legacy_digest(hash, &digest) ||
+      sscanf((char *)value, "block%u", &block) != 1 ||
+      table_put(&digest, block) != 0) {
+    log_warning(g_storage_logger,
+                "Entrada inválida en %s: %s=%s, se descarta",
+                BLOCK_INDEX_LEGACY_FILE, hash, (char *)value);
+    legacy_failures++;
+  }
+}
+
+/**
+ * Carga en la tabla blocks_hash_index.config (MD5 hex -> "blockNNNN")
+ */
+static int load_legacy_index(const char *legacy_path) {
+  t_config *legacy = config_create((char *)legacy_path);
+  if (!legacy) {
+    log_error(g_storage_logger, "No se pudo leer %s", legacy_path);
+    return -1;
+  }
+
+  legacy_failures = 0;
+  dictionary_iterator(legacy->properties, migrate_legacy_entry);
+  config_destroy(legacy);
+
+  log_info(g_storage_logger,
+           "Migrando %s: %zu hashes (%d descartados)", legacy_path,
+           block_index.count, legacy_failures);
+  return 0;
+}
+
+/**
+ * Vuelve a calcular los digests de los bloques del índice con el algoritmo
+ * actual, leyendo los bloques físicos. Un bloque que no se puede leer sale
+ * del índice: sólo se pierde la posibilidad de deduplicar contra él.
+ */
+static int rehash_blocks(const char *mount_point,
+                         t_block_hash_algorithm previous) {
+  int retval = 0;
+  size_t block_count = 0;
+  uint32_t *blocks = malloc(sizeof(uint32_t) * (block_index.count + 1));
+  if (!blocks) {
+    return -1;
+  }
+  for (size_t i = 0; i < block_index.capacity; i++) {
+    if (block_index.slots[i].block != BLOCK_INDEX_NONE) {
+      blocks[block_count++] = block_index.slots[i].block;
+    }
+  }
+
+  free(block_index.slots);
+  block_index.slots = NULL;
+  block_index.capacity = 0;
+  block_index.count = 0;
+  if (block_index.block_has_digest) {
+    memset(block_index.block_has_digest, 0,
+           sizeof(bool) * block_index.block_capacity);
+  }
+  if (table_grow() != 0) {
+    retval = -1;
+    goto clean_blocks;
+  }
+
+  char *buffer = NULL;
+  size_t buffer_size = 0;
+  for (size_t i = 0; i < block_count; i++) {
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/physical_blocks/block%04u.dat",
+             mount_point, blocks[i]);
+
+    struct stat st;
+    FILE *file = stat(path, &st) == 0 ? fopen(path, "rb") : NULL;
+    if (!file) {
+      log_warning(g_storage_logger,
+                  "No se pudo leer %s para rehashear, sale del índice", path);
+      continue;
+    }
+
+    if ((size_t)st.st_size > buffer_size) {
+      char *bigger = realloc(buffer, st.st_size);
+      if (!bigger) {
+        fclose(file);
+        retval = -1;
+        break;
+      }
+      buffer = bigger;
+      buffer_size = st.st_size;
+    }
+
+    size_t read_bytes = fread(buffer, 1, st.st_size, file);
+    fclose(file);
+
+    t_block_digest digest;
+    block_index_digest(buffer, read_bytes, &digest);
+    if (table_put(&digest, blocks[i]) != 0) {
+      retval = -1;
+      break;
+    }
+  }
+  free(buffer);
+
+  if (retval == 0) {
+    log_info(g_storage_logger,
+             "Índice de bloques rehasheado de %s a %s: %zu bloques",
+             block_hash_algorithm_name(previous),
+             block_hash_algorithm_name(hash_algorithm), block_index.count);
+  }
+
+clean_blocks:
+  free(blocks);
+  return retval;
+}
+
+/**
+ * Aplica los registros del log a la tabla. Un registro cortado al final (un
+ * corte a mitad de un append) se descarta.
+ */
+static int load_log(const char *path, t_block_hash_algorithm *algorithm) {
+  int retval = 0;
+
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    log_error(g_storage_logger, "No se pudo abrir el índice de bloques %s",
+              path);
+    return -1;
+  }
+
+  t_block_index_header header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.magic != BLOCK_INDEX_MAGIC ||
+      header.version != BLOCK_INDEX_VERSION) {
+    log_error(g_storage_logger, "El índice de bloques %s no es válido", path);
+    retval = -1;
+    goto close_file;
+  }
+  *algorithm = header.algorithm;
+
+  t_block_index_record *batch =
+      malloc(sizeof(t_block_index_record) * BLOCK_INDEX_READ_BATCH);
+  if (!batch) {
+    retval = -1;
+    goto close_file;
+  }
+
+  size_t read_records;
+  while ((read_records = fread(batch, sizeof(t_block_index_record),
+                               BLOCK_INDEX_READ_BATCH, file)) > 0) {
+    for (size_t i = 0; i < read_records; i++) {
+      apply_record(&batch[i]);
+    }
+    block_index.log_records += read_records;
+  }
+  free(batch);
+
+  off_t valid_size = (off_t)(sizeof(header) + block_index.log_records *
+                                                  sizeof(t_block_index_record));
+  struct stat st;
+  if (fstat(fileno(file), &st) == 0 && st.st_size != valid_size) {
+    log_warning(g_storage_logger,
+                "El índice de bloques %s tenía un registro incompleto, se "
+                "descarta",
+                path);
+    if (truncate(path, valid_size) != 0) {
+      retval = -1;
+    }
+  }
+
+close_file:
+  fclose(file);
+  return retval;
+}
+
+static void reset_index(void) {
+  free(block_index.mount_point);
+  free(block_index.slots);
+  free(block_index.block_digests);
+  free(block_index.block_has_digest);
+  free(block_index.pending);
+  block_index = (t_block_index){.fd = -1};
+}
+
+int block_index_create(const char *mount_point) {
+  char *path = index_path(mount_point, BLOCK_INDEX_FILE);
+
+  FILE *file = fopen(path, "wb");
+  if (!file) {
+    log_error(g_storage_logger, "No se pudo crear el archivo %s", path);
+    free(path);
+    return -1;
+  }
+
+  t_block_index_header header = {
+      .magic = BLOCK_INDEX_MAGIC,
+      .version = BLOCK_INDEX_VERSION,
+      .algorithm = hash_algorithm,
+  };
+  int retval = fwrite(&header, sizeof(header), 1, file) == 1 ? 0 : -1;
+  fclose(file);
+
+  if (retval != 0) {
+    log_error(g_storage_logger, "No se pudo escribir el archivo %s", path);
+  }
+
+  free(path);
+  return retval;
+}
+
+int block_index_open(const char *mount_point) {
+  if (block_index.mount_point) {
+    if (strcmp(block_index.mount_point, mount_point) == 0) {
+      return 0;
+    }
+    block_index_close();
+  }
+
+  int retval = 0;
+  char *path = index_path(mount_point, BLOCK_INDEX_FILE);
+  char *legacy_path = index_path(mount_point, BLOCK_INDEX_LEGACY_FILE);
+
+  if (table_grow() != 0) {
+    retval = -1;
+    goto clean_paths;
+  }
+
+  t_block_hash_algorithm loaded_algorithm = hash_algorithm;
+  bool migrated = false;
+  if (access(path, F_OK) == 0) {
+    retval = load_log(path, &loaded_algorithm);
+  } else if (access(legacy_path, F_OK) == 0) {
+    retval = load_legacy_index(legacy_path);
+    loaded_algorithm = BLOCK_HASH_MD5;
+    migrated = true;
+  } else {
+    retval = block_index_create(mount_point);
+  }
+  if (retval != 0) {
+    goto clean_paths;
+  }
+
+  // Los digests de otro algoritmo no sirven para comparar con los nuevos
+  bool rehashed = loaded_algorithm != hash_algorithm;
+  if (rehashed && rehash_blocks(mount_point, loaded_algorithm) != 0) {
+    retval = -1;
+    goto clean_paths;
+  }
+
+  if (migrated || rehashed) {
+    if (write_snapshot(path) != 0) {
+      retval = -1;
+      goto clean_paths;
+    }
+    block_index.log_records = block_index.count;
+    if (migrated) {
+      remove(legacy_path);
+    }
+  }
+
+  if (open_log_for_append(path) != 0) {
+    retval = -1;
+    goto clean_paths;
+  }
+
+  block_index.mount_point = strdup(mount_point);
+
+  log_debug(g_storage_logger,
+            "Índice de bloques cargado: %zu hashes en %zu registros",
+            block_index.count, block_index.log_records);
+
+  if (needs_compaction()) {
+    block_index_compact();
+  }
+
+clean_paths:
+  if (retval != 0) {
+    if (block_index.fd >= 0) {
+      close(block_index.fd);
+    }
+    reset_index();
+  }
+  free(path);
+  free(legacy_path);
+  return retval;
+}
+
+void block_index_close(void) {
+  if (block_index.fd >= 0) {
+    block_index_commit();
+    close(block_index.fd);
+  }
+  reset_index();
+}
+
+int block_hash_algorithm_from_string(const char *name) {
+  for (size_t i = 0; i < sizeof(algorithm_names) / sizeof(algorithm_names[0]);
+       i++) {
+    if (strcasecmp(name, algorithm_names[i]) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+const char *block_hash_algorithm_name(t_block_hash_algorithm algorithm) {
+  return (size_t)algorithm < sizeof(algorithm_names) / sizeof(algorithm_names[0])
+             ? algorithm_names[algorithm]
+             : "?";
+}
+
+int block_index_set_algorithm(t_block_hash_algorithm algorithm) {
+  if ((size_t)algorithm >= sizeof(algorithm_names) / sizeof(algorithm_names[0])) {
+    return -1;
+  }
+
+  // Resolver el digest una vez: EVP_md5() y compañía lo buscan en cada uso
+  EVP_MD *md = NULL;
+  if (algorithm != BLOCK_HASH_FAST) {
+    md = EVP_MD_fetch(NULL, openssl_names[algorithm], NULL);
+    if (!md) {
+      log_error(g_storage_logger,
+                "OpenSSL no provee el algoritmo %s para HASH_ALGORITHM",
+                algorithm_names[algorithm]);
+      return -1;
+    }
+  }
+
+  // Los digests cargados son del algoritmo anterior: se rehashean al reabrir
+  if (block_index.mount_point && algorithm != hash_algorithm) {
+    block_index_close();
+  }
+
+  EVP_MD_free(hash_md);
+  hash_md = md;
+  hash_algorithm = algorithm;
+  return 0;
+}
+
+// 64x64 -> 128 bits, devuelve la mezcla de ambas mitades
+static inline uint64_t fast_mix(uint64_t a, uint64_t b) {
+  __uint128_t product = (__uint128_t)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+static inline uint64_t read64(const uint8_t *p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+/*
+ * Hash no criptográfico de 128 bits: dos acumuladores que consumen 16 bytes
+ * por vuelta con multiplicaciones de 64x64 -> 128 (como wyhash).
+ */
+static void fast_digest(const uint8_t *data, size_t size,
+                        t_block_digest *digest) {
+  uint64_t h1 = FAST_SEED_1 ^ size;
+  uint64_t h2 = FAST_SEED_2 ^ (size * FAST_PRIME_1);
+
+  size_t offset = 0;
+  for (; offset + 16 <= size; offset += 16) {
+    uint64_t x = read64(data + offset);
+    uint64_t y = read64(data + offset + 8);
+    h1 = fast_mix(x ^ FAST_PRIME_1, y ^ h1);
+    h2 = fast_mix(y ^ FAST_PRIME_2, x ^ h2);
+  }
+
+  if (offset < size) {
+    uint8_t tail[16] = {0};
+    memcpy(tail, data + offset, size - offset);
+    uint64_t x = read64(tail);
+    uint64_t y = read64(tail + 8);
+    h1 = fast_mix(x ^ FAST_PRIME_1, y ^ h1);
+    h2 = fast_mix(y ^ FAST_PRIME_2, x ^ h2);
+  }
+
+  h1 = fast_mix(h1 ^ FAST_PRIME_3, h2 ^ FAST_SEED_1);
+  h2 = fast_mix(h2 ^ FAST_PRIME_2, h1 ^ FAST_SEED_2);
+  memcpy(digest->bytes, &h1, sizeof(h1));
+  memcpy(digest->bytes + sizeof(h1), &h2, sizeof(h2));
+}
+
+void block_index_digest(const void *data, size_t size, t_block_digest *digest) {
+  if (hash_algorithm == BLOCK_HASH_FAST) {
+    fast_digest(data, size, digest);
+    return;
+  }
+
+  // Sin block_index_set_algorithm el algoritmo es MD5 y no hay digest resuelto
+  unsigned char full[EVP_MAX_MD_SIZE];
+  const EVP_MD *md = hash_md ? hash_md : EVP_md5();
+  EVP_Digest(data, size, full, NULL, md, NULL);
+  memcpy(digest->bytes, full, BLOCK_INDEX_DIGEST_SIZE);
+}
+
+int64_t block_index_lookup(const t_block_digest *digest) {
+  if (block_index.capacity == 0) {
+    return -1;
+  }
+
+  const t_block_index_record *slot = &block_index.slots[table_find(digest)];
+  return slot->block == BLOCK_INDEX_NONE ? -1 : (int64_t)slot->block;
+}
+
+int block_index_insert(const t_block_digest *digest, uint32_t block) {
+  t_block_index_record record = {.digest = *digest, .block = block};
+
+  if (pending_push(&record) != 0) {
+    return -1;
+  }
+  if (table_put(digest, block) != 0) {
+    block_index.pending_count--;
+    return -1;
+  }
+  return 0;
+}
+
+int block_index_commit(void) {
+  if (block_index.fd < 0) {
+    return 0;
+  }
+
+  int retval = append_records(block_index.pending, block_index.pending_count);
+  if (retval == 0) {
+    block_index.pending_count = 0;
+  }
+
+  if (needs_compaction() && block_index_compact() != 0) {
+    retval = -1;
+  }
+
+  return retval;
+}
+
+void block_index_rollback(void) {
+  size_t removals = 0;
+  for (size_t i = block_index.pending_count; i > 0; i--) {
+    const t_block_index_record *record = &block_index.pending[i - 1];
+    if (record->block == BLOCK_INDEX_NONE) {
+      removals++;
+    } else if (block_index_lookup(&record->digest) == (int64_t)record->block) {
+      table_remove(&record->digest);
+    }
+  }
+
+  // Los borrados se mantienen: corresponden a bloques que ya se liberaron en
+  // el bitmap, y si el log conservara su digest se deduplicaría contra ellos
+  size_t kept = 0;
+  for (size_t i = 0; i < block_index.pending_count && removals > 0; i++) {
+    if (block_index.pending[i].block == BLOCK_INDEX_NONE) {
+      block_index.pending[kept++] = block_index.pending[i];
+    }
+  }
+  if (block_index.fd >= 0) {
+    append_records(block_index.pending, kept);
+  }
+  block_index.pending_count = 0;
+}
+
+void block_index_forget_block_locked(uint32_t block) {
+  if (block >= block_index.block_capacity ||
+      !block_index.block_has_digest[block]) {
+    return;
+  }
+
+  t_block_index_record record = {
+      .digest = block_index.block_digests[block],
+      .block = BLOCK_INDEX_NONE,
+  };
+  table_remove(&record.digest);
+
+  if (pending_push(&record) != 0) {
+    log_error(g_storage_logger,
+              "No se pudo registrar el borrado del hash del bloque físico %04u",
+              block);
+    return;
+  }
+
+  log_debug(g_storage_logger, "Hash del bloque físico %04u quitado del índice",
+            block);
+}
+
+void block_index_forget_block(uint32_t block) {
+  pthread_mutex_lock(&g_blocks_hash_index_mutex);
+
+  if (g_storage_config &&
+      block_index_open(g_storage_config->mount_point) == 0) {
+    block_index_forget_block_locked(block);
+    block_index_commit();
+  }
+
+  pthread_mutex_unlock(&g_blocks_hash_index_mutex);
+}
+
+int block_index_compact(void) {
+  if (!block_index.mount_point) {
+    return -1;
+  }
+
+  char *path = index_path(block_index.mount_point, BLOCK_INDEX_FILE);
+  size_t previous_records = block_index.log_records;
+  int retval = write_snapshot(path);
+
+  if (retval == 0) {
+    close(block_index.fd);
+    retval = open_log_for_append(path);
+    block_index.log_records = block_index.count;
+    log_info(g_storage_logger,
+             "Índice de bloques compactado: %zu registros -> %zu",
+             previous_records, block_index.count);
+  }
+
+  free(path);
+  return retval;
+}
+
+size_t block_index_size(void) { return block_index.count; }
@@ -0,0 +1,154 @@
+#ifndef BLOCK_INDEX_H
+#define BLOCK_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Índice de deduplicación: hash del contenido de un bloque -> bloque
+ * físico. Se carga una sola vez en una tabla de direccionamiento abierto y en
+ * disco es un log append-only (blocks_hash_index.bin): un header seguido de
+ * registros { digest, bloque }. Un registro con bloque BLOCK_INDEX_NONE borra
+ * el digest. Cuando los registros muertos superan a los vivos se compacta
+ * reescribiendo el log con la tabla. El header guarda el algoritmo de hash;
+ * si al abrir no coincide con el configurado, se rehashean los bloques.
+ *
+ * Salvo block_index_forget_block, que lo toma, las funciones se llaman con
+ * g_blocks_hash_index_mutex tomado (o antes de atender clientes).
+ */
+#define BLOCK_INDEX_FILE "blocks_hash_index.bin"
+#define BLOCK_INDEX_LEGACY_FILE "blocks_hash_index.config"
+#define BLOCK_INDEX_MAGIC 0x49424F4D // "MOBI"
+#define BLOCK_INDEX_VERSION 1
+#define BLOCK_INDEX_DIGEST_SIZE 16
+#define BLOCK_INDEX_NONE UINT32_MAX
+
+/*
+ * Algoritmos para hashear bloques. Los de OpenSSL se truncan a 128 bits;
+ * FAST no es criptográfico, conviene usarlo con VERIFY_DEDUP.
+ */
+typedef enum {
+  BLOCK_HASH_MD5 = 0, // El del formato anterior
+  BLOCK_HASH_SHA256 = 1,
+  BLOCK_HASH_BLAKE2B = 2,
+  BLOCK_HASH_FAST = 3,
+} t_block_hash_algorithm;
+
+typedef struct {
+  uint8_t bytes[BLOCK_INDEX_DIGEST_SIZE];
+} t_block_digest;
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t algorithm; // t_block_hash_algorithm de los digests del log
+} t_block_index_header;
+
+typedef struct {
+  t_block_digest digest;
+  uint32_t block; // BLOCK_INDEX_NONE: borra el digest
+} t_block_index_record;
+
+/**
+ * Crea un índice vacío en el punto de montaje (pisa el que hubiera)
+ *
+ * @return 0 en caso de éxito, -1 si no se puede crear el archivo
+ */
+int block_index_create(const char *mount_point);
+
+/**
+ * Carga el índice del punto de montaje en memoria. Si sólo existe el
+ * blocks_hash_index.config del formato anterior, lo migra. No hace nada si
+ * ya está abierto para ese punto de montaje.
+ *
+ * @return 0 en caso de éxito, -1 si no se puede leer o crear el índice
+ */
+int block_index_open(const char *mount_point);
+
+/**
+ * Persiste lo pendiente y libera el índice en memoria
+ */
+void block_index_close(void);
+
+/**
+ * Convierte el nombre de HASH_ALGORITHM (MD5, SHA256, BLAKE2B, FAST)
+ *
+ * @return El algoritmo, o -1 si el nombre no es válido
+ */
+int block_hash_algorithm_from_string(const char *name);
+
+/**
+ * @return Nombre del algoritmo, como se escribe en la configuración
+ */
+const char *block_hash_algorithm_name(t_block_hash_algorithm algorithm);
+
+/**
+ * Elige el algoritmo de block_index_digest. Se llama al iniciar, antes de
+ * abrir el índice; por defecto es MD5. Si el índice estaba abierto con otro
+ * algoritmo lo cierra, y al reabrirlo se rehashea.
+ *
+ * @return 0 en caso de éxito, -1 si OpenSSL no provee el algoritmo (queda el
+ *         anterior)
+ */
+int block_index_set_algorithm(t_block_hash_algorithm algorithm);
+
+/**
+ * Calcula el digest de un bloque con el algoritmo elegido. Se puede llamar
+ * desde varios hilos a la vez y sin tomar el mutex del índice.
+ */
+void block_index_digest(const void *data, size_t size, t_block_digest *digest);
+
+/**
+ * @return Bloque físico registrado para el digest, o -1 si no está
+ */
+int64_t block_index_lookup(const t_block_digest *digest);
+
+/**
+ * Registra el digest de un bloque físico. Queda pendiente hasta
+ * block_index_commit() o se descarta con block_index_rollback().
+ *
+ * @return 0 en caso de éxito, -1 si no hay memoria
+ */
+int block_index_insert(const t_block_digest *digest, uint32_t block);
+
+/**
+ * Agrega al log los registros pendientes y compacta si hace falta
+ *
+ * @return 0 en caso de éxito, -1 si falla la escritura
+ */
+int block_index_commit(void);
+
+/**
+ * Saca de la tabla las inserciones pendientes sin escribirlas. Los borrados
+ * pendientes sí se escriben: sus bloques ya se liberaron.
+ */
+void block_index_rollback(void);
+
+/**
+ * Borra del índice el digest del bloque físico, si tenía uno. Se llama al
+ * liberar el bloque: su contenido puede cambiar y el hash dejaría de valer.
+ * Toma g_blocks_hash_index_mutex.
+ */
+void block_index_forget_block(uint32_t block);
+
+/**
+ * Como block_index_forget_block, pero con g_blocks_hash_index_mutex ya tomado
+ * y el índice abierto. El borrado queda pendiente hasta block_index_commit()
+ * (o block_index_rollback(), que también lo escribe).
+ */
+void block_index_forget_block_locked(uint32_t block);
+
+/**
+ * Reescribe el log sólo con las entradas vivas
+ *
+ * @return 0 en caso de éxito, -1 si falla
+ */
+int block_index_compact(void);
+
+/**
+ * @return Cantidad de digests registrados
+ */
+size_t block_index_size(void);
+
+#endif
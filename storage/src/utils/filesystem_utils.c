@@ -1,17 +1,37 @@
 #include "filesystem_utils.h"
 #include "../errors.h"
 #include "../globals/globals.h"
+#include "block_index.h"
 #include <commons/bitarray.h>
 #include <commons/config.h>
 #include <commons/string.h>
+#include <endian.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <utils/logger.h>
 #include <utils/utils.h>
 
+/*
+ * bitmap.bin mapeado una sola vez (MAP_SHARED): los cambios van directo a la
+ * page cache y se sincronizan con msync cada BITMAP_SYNC_BATCH persistencias.
+ * Todo el estado se accede con g_storage_bitmap_mutex tomado.
+ */
+typedef struct {
+  int fd;
+  char *bytes;
+  size_t size_bytes;
+  size_t next_fit;         // Todos los bits anteriores están ocupados
+  int pending_changes;     // Persistencias todavía sin msync
+} t_bitmap_mapping;
+
+static t_bitmap_mapping bitmap_mapping = {.fd = -1};
+
 int create_dir_recursive(const char *path) {
   char command[PATH_MAX + 20];
   snprintf(command, sizeof(command), "mkdir -p \"%s\"", path);
@@ -58,6 +78,8 @@ int delete_file_dir_structure(const char *mount_point, const char *file_name,
     return FILE_TAG_MISSING;
   }
 
+  metadata_cache_evict(file_name, tag);
+
   char command[PATH_MAX + 20];
   snprintf(command, sizeof(command), "rm -rf \"%s\"", target_path);
   if (system(command) != 0) {
@@ -69,29 +91,6 @@ int delete_file_dir_structure(const char *mount_point, const char *file_name,
   return 0;
 }
 
-int create_metadata_file(const char *mount_point, const char *file_name,
-                         const char *tag, const char *initial_content) {
-  char metadata_path[PATH_MAX];
-
-  snprintf(metadata_path, sizeof(metadata_path),
-           "%s/files/%s/%s/metadata.config", mount_point, file_name, tag);
-
-  FILE *metadata_ptr = fopen(metadata_path, "w");
-  if (metadata_ptr == NULL) {
-    log_error(g_storage_logger, "No se pudo crear el archivo %s",
-              metadata_path);
-    return -1;
-  }
-
-  const char *content = initial_content
-                            ? initial_content
-                            : "SIZE=0\nBLOCKS=[]\nESTADO=WORK_IN_PROGRESS\n";
-  fprintf(metadata_ptr, "%s", content);
-  fclose(metadata_ptr);
-
-  return 0;
-}
-
 int read_superblock(const char *mount_point, int *fs_size, int *block_size) {
   char superblock_path[PATH_MAX];
   snprintf(superblock_path, sizeof(superblock_path), "%s/superblock.config",
@@ -124,202 +123,38 @@ int read_superblock(const char *mount_point, int *fs_size, int *block_size) {
 
 int modify_bitmap_bits(const char *mount_point, int start_index, size_t count,
                        int set_bits) {
-  int retval = 0;
-  FILE *bitmap_file = NULL;
-  char *bitmap_buffer = NULL;
-  t_bitarray *bitmap = NULL;
-
   if (!g_storage_config) {
     log_error(g_storage_logger, "g_storage_config es NULL");
     return -4;
   }
 
-  size_t bitmap_size_bytes = g_storage_config->bitmap_size_bytes;
-
-  char bitmap_path[PATH_MAX];
-  snprintf(bitmap_path, sizeof(bitmap_path), "%s/bitmap.bin", mount_point);
-
-  bitmap_file = fopen(bitmap_path, "r+b");
-  if (!bitmap_file) {
-    log_error(g_storage_logger, "No se pudo abrir el archivo bitmap: %s",
-              bitmap_path);
-    retval = -1;
-    goto end;
-  }
-
-  bitmap_buffer = calloc(1, bitmap_size_bytes);
-  if (!bitmap_buffer) {
-    log_error(g_storage_logger, "No se pudo asignar memoria para el bitmap");
-    retval = -2;
-    goto clean_bitmap;
-  }
-
   pthread_mutex_lock(&g_storage_bitmap_mutex);
 
-  if (fread(bitmap_buffer, 1, bitmap_size_bytes, bitmap_file) !=
-      bitmap_size_bytes) {
-    log_error(g_storage_logger, "No se pudo leer el bitmap completo");
-    retval = -1;
-    goto unlock_mutex;
+  if (bitmap_mapping.bytes == NULL && bitmap_map(mount_point) != 0) {
+    pthread_mutex_unlock(&g_storage_bitmap_mutex);
+    return -1;
   }
 
-  bitmap =
-      bitarray_create_with_mode(bitmap_buffer, bitmap_size_bytes, MSB_FIRST);
+  t_bitarray *bitmap = bitarray_create_with_mode(
+      bitmap_mapping.bytes, bitmap_mapping.size_bytes, MSB_FIRST);
   if (!bitmap) {
     log_error(g_storage_logger, "No se pudo crear el bitmap en memoria");
-    retval = -2;
-    goto unlock_mutex;
+    pthread_mutex_unlock(&g_storage_bitmap_mutex);
+    return -2;
   }
 
   for (size_t i = 0; i < count; i++) {
     if (set_bits) {
       bitarray_set_bit(bitmap, start_index + i);
     } else {
-      bitarray_clean_bit(bitmap, start_index + i);
-    }
-  }
-
-  fseek(bitmap_file, 0, SEEK_SET);
-
-  int written_bytes = fwrite(bitmap_buffer, 1, bitmap_size_bytes, bitmap_file);
-
-  if (written_bytes != bitmap_size_bytes) {
-    log_error(g_storage_logger, "No se pudo escribir el bitmap modificado");
-    retval = -3;
-  } else {
-    log_info(g_storage_logger, "Modificados %zu bits en el bitmap (%s)", count,
-             set_bits ? "seteados" : "unseteados");
-  }
-
-  bitarray_destroy(bitmap);
-unlock_mutex:
-  pthread_mutex_unlock(&g_storage_bitmap_mutex);
-clean_bitmap:
-  free(bitmap_buffer);
-  fclose(bitmap_file);
-end:
-  return retval;
-}
-
-t_file_metadata *read_file_metadata(const char *mount_point,
-                                    const char *filename, const char *tag) {
-  char metadata_path[PATH_MAX];
-  snprintf(metadata_path, sizeof(metadata_path),
-           "%s/files/%s/%s/metadata.config", mount_point, filename, tag);
-
-  t_config *config = config_create(metadata_path);
-  if (!config) {
-    log_debug(g_storage_logger, "No se pudo abrir el metadata.config: %s",
-              metadata_path);
-    return NULL;
-  }
-
-  if (!config_has_property(config, "SIZE") ||
-      !config_has_property(config, "BLOCKS") ||
-      !config_has_property(config, "ESTADO")) {
-    log_error(g_storage_logger,
-              "El metadata.config no tiene las propiedades requeridas "
-              "(SIZE, BLOCKS, ESTADO)");
-    config_destroy(config);
-    return NULL;
-  }
-
-  t_file_metadata *metadata = malloc(sizeof(t_file_metadata));
-  if (!metadata) {
-    log_error(g_storage_logger,
-              "No se pudo asignar memoria para t_file_metadata");
-    config_destroy(config);
-    return NULL;
-  }
-
-  metadata->size = config_get_int_value(config, "SIZE");
-
-  char *state_value = config_get_string_value(config, "ESTADO");
-  metadata->state = string_duplicate(state_value);
-
-  char **blocks_str = config_get_array_value(config, "BLOCKS");
-  metadata->block_count = string_array_size(blocks_str);
-
-  if (metadata->block_count > 0) {
-    metadata->blocks = malloc(sizeof(int) * metadata->block_count);
-    if (!metadata->blocks) {
-      log_error(g_storage_logger,
-                "No se pudo asignar memoria para el array de bloques");
-      string_array_destroy(blocks_str);
-      free(metadata->state);
-      free(metadata);
-      config_destroy(config);
-      return NULL;
+      free_bitmap_bit(bitmap, start_index + i);
     }
-
-    for (int i = 0; i < metadata->block_count; i++) {
-      metadata->blocks[i] = atoi(blocks_str[i]);
-    }
-  } else {
-    metadata->blocks = NULL;
-  }
-
-  metadata->config = config;
-  string_array_destroy(blocks_str);
-
-  log_debug(g_storage_logger,
-           "Metadata leído: %s:%s - SIZE=%d, BLOCKS=%d, ESTADO=%s", filename,
-           tag, metadata->size, metadata->block_count, metadata->state);
-
-  return metadata;
-}
-
-int save_file_metadata(t_file_metadata *metadata) {
-  if (!metadata || !metadata->config) {
-    log_error(g_storage_logger, "Metadata o config es NULL");
-    return -1;
-  }
-
-  char field_str[32];
-  snprintf(field_str, sizeof(field_str), "%d", metadata->size);
-  config_set_value(metadata->config, "SIZE", field_str);
-
-  // Si no tenemos BLOCKS, escribimos `[]`
-  char *stringified_blocks;
-  if (metadata->blocks == NULL || metadata->block_count == 0) {
-    stringified_blocks = string_duplicate("[]");
-  } else {
-    char **blocks_str_array = string_array_new();
-
-    for (int i = 0; i < metadata->block_count; i++) {
-      snprintf(field_str, sizeof(field_str), "%d", metadata->blocks[i]);
-      string_array_push(&blocks_str_array, string_duplicate(field_str));
-    }
-
-    stringified_blocks = get_stringified_array(blocks_str_array);
-    string_array_destroy(blocks_str_array);
-  }
-
-  config_set_value(metadata->config, "BLOCKS", stringified_blocks);
-  free(stringified_blocks);
-
-  config_set_value(metadata->config, "ESTADO", metadata->state);
-
-  config_save(metadata->config);
-  log_debug(g_storage_logger, "Metadata guardada");
-  return 0;
-}
-
-void destroy_file_metadata(t_file_metadata *metadata) {
-  if (!metadata) {
-    return;
   }
 
-  if (metadata->blocks)
-    free(metadata->blocks);
-
-  if (metadata->state)
-    free(metadata->state);
-
-  if (metadata->config)
-    config_destroy(metadata->config);
+  log_info(g_storage_logger, "Modificados %zu bits en el bitmap (%s)", count,
+           set_bits ? "seteados" : "unseteados");
 
-  free(metadata);
+  return bitmap_persist(bitmap, NULL) == 0 ? 0 : -3;
 }
 
 int delete_logical_block(const char *mount_point, const char *name,
@@ -367,6 +202,9 @@ int delete_logical_block(const char *mount_point, const char *name,
     return -3;
   }
 
+  // Un bloque libre puede reescribirse: su hash deja de identificarlo
+  block_index_forget_block((uint32_t)physical_block_index);
+
   log_info(g_storage_logger,
            "##%u - Bloque Físico Liberado - Número de Bloque: %04d", query_id,
            physical_block_index);
@@ -435,17 +273,75 @@ int ph_block_links(char *logical_block_path) {
   return file_stat.st_nlink;
 }
 
-ssize_t get_free_bit_index(t_bitarray *bitmap) {
-  size_t max_bit = bitarray_get_max_bit(bitmap);
+/**
+ * Primer bit en 0 a partir de from_bit (MSB_FIRST). Saltea de a 64 bits las
+ * zonas llenas y ubica el bit con clz sobre la palabra en orden big-endian.
+ */
+static ssize_t bitmap_find_zero(const char *bytes, size_t size_bytes,
+                                size_t from_bit) {
+  size_t i = from_bit / 8;
+  if (i >= size_bytes) {
+    return -1;
+  }
+
+  // Primer byte: se tratan como ocupados los bits anteriores a from_bit
+  unsigned char first = (unsigned char)bytes[i] | (0xFF00 >> (from_bit % 8));
+  if (first != 0xFF) {
+    return (ssize_t)(i * 8 + __builtin_clz((unsigned char)~first) - 24);
+  }
+  i++;
 
-  for (size_t i = 0; i < max_bit; i++) {
-    if (!bitarray_test_bit(bitmap, i)) {
-      return (ssize_t)i;
+  for (; i + sizeof(uint64_t) <= size_bytes; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    if (word != UINT64_MAX) {
+      return (ssize_t)(i * 8 + __builtin_clzll(~be64toh(word)));
+    }
+  }
+
+  for (; i < size_bytes; i++) {
+    unsigned char byte = (unsigned char)bytes[i];
+    if (byte != 0xFF) {
+      return (ssize_t)(i * 8 + __builtin_clz((unsigned char)~byte) - 24);
     }
   }
   return -1;
 }
 
+static bool is_mapped_bitmap(const t_bitarray *bitmap) {
+  return bitmap_mapping.bytes != NULL && bitmap->bitarray == bitmap_mapping.bytes;
+}
+
+ssize_t get_free_bit_index(t_bitarray *bitmap) {
+  size_t size_bytes = bitarray_get_max_bit(bitmap) / 8;
+
+  if (!is_mapped_bitmap(bitmap)) {
+    return bitmap_find_zero(bitmap->bitarray, size_bytes, 0);
+  }
+
+  // Next-fit: nada antes de next_fit está libre, así que el resultado sigue
+  // siendo el primer bloque libre. Si algo se liberó por fuera de
+  // free_bitmap_bit, la vuelta desde 0 lo encuentra igual.
+  ssize_t index =
+      bitmap_find_zero(bitmap->bitarray, size_bytes, bitmap_mapping.next_fit);
+  if (index < 0 && bitmap_mapping.next_fit > 0) {
+    index = bitmap_find_zero(bitmap->bitarray, size_bytes, 0);
+  }
+
+  if (index >= 0) {
+    bitmap_mapping.next_fit = (size_t)index;
+  }
+  return index;
+}
+
+void free_bitmap_bit(t_bitarray *bitmap, off_t bit_index) {
+  bitarray_clean_bit(bitmap, bit_index);
+
+  if (is_mapped_bitmap(bitmap) && (size_t)bit_index < bitmap_mapping.next_fit) {
+    bitmap_mapping.next_fit = (size_t)bit_index;
+  }
+}
+
 FILE *open_bitmap_file(const char *modes) {
   char bitmap_path[PATH_MAX];
   snprintf(bitmap_path, sizeof(bitmap_path), "%s/bitmap.bin",
@@ -461,80 +357,114 @@ FILE *open_bitmap_file(const char *modes) {
   return bitmap_file;
 }
 
-int bitmap_load(t_bitarray **bitmap, char **bitmap_buffer) {
-  int retval = 0;
+int bitmap_map(const char *mount_point) {
+  if (bitmap_mapping.bytes != NULL) {
+    return 0;
+  }
+
+  char bitmap_path[PATH_MAX];
+  snprintf(bitmap_path, sizeof(bitmap_path), "%s/bitmap.bin", mount_point);
+
+  int fd = open(bitmap_path, O_RDWR);
+  if (fd < 0) {
+    log_error(g_storage_logger, "No se pudo abrir el archivo bitmap: %s",
+              bitmap_path);
+    return -1;
+  }
+
   size_t bitmap_size_bytes = g_storage_config->bitmap_size_bytes;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || (size_t)file_stat.st_size < bitmap_size_bytes) {
+    log_error(g_storage_logger,
+              "El bitmap %s es más chico que los %zu bytes esperados",
+              bitmap_path, bitmap_size_bytes);
+    close(fd);
+    return -2;
+  }
 
-  FILE *bitmap_file = open_bitmap_file("rb");
-  if (bitmap_file == NULL) {
-    retval = -1;
-    goto end;
+  char *bytes = mmap(NULL, bitmap_size_bytes, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+  if (bytes == MAP_FAILED) {
+    log_error(g_storage_logger, "No se pudo mapear el bitmap %s", bitmap_path);
+    close(fd);
+    return -3;
   }
 
-  *bitmap_buffer = calloc(1, bitmap_size_bytes);
-  if (!*bitmap_buffer) {
-    log_error(g_storage_logger, "No se pudo asignar memoria para el bitmap");
-    retval = -2;
-    goto clean_file;
+  bitmap_mapping = (t_bitmap_mapping){
+      .fd = fd,
+      .bytes = bytes,
+      .size_bytes = bitmap_size_bytes,
+      .next_fit = 0,
+      .pending_changes = 0,
+  };
+
+  log_debug(g_storage_logger, "Bitmap %s mapeado en memoria (%zu bytes)",
+            bitmap_path, bitmap_size_bytes);
+  return 0;
+}
+
+int bitmap_sync(void) {
+  if (bitmap_mapping.bytes == NULL || bitmap_mapping.pending_changes == 0) {
+    return 0;
+  }
+
+  if (msync(bitmap_mapping.bytes, bitmap_mapping.size_bytes, MS_SYNC) != 0) {
+    log_error(g_storage_logger, "No se pudo sincronizar el bitmap a disco");
+    return -1;
   }
 
+  bitmap_mapping.pending_changes = 0;
+  return 0;
+}
+
+void bitmap_unmap(void) {
+  pthread_mutex_lock(&g_storage_bitmap_mutex);
+  if (bitmap_mapping.bytes != NULL) {
+    bitmap_sync();
+    munmap(bitmap_mapping.bytes, bitmap_mapping.size_bytes);
+    close(bitmap_mapping.fd);
+    bitmap_mapping = (t_bitmap_mapping){.fd = -1};
+  }
+  pthread_mutex_unlock(&g_storage_bitmap_mutex);
+}
+
+int bitmap_load(t_bitarray **bitmap, char **bitmap_buffer) {
   pthread_mutex_lock(&g_storage_bitmap_mutex);
 
-  if (fread(*bitmap_buffer, 1, bitmap_size_bytes, bitmap_file) !=
-      bitmap_size_bytes) {
-    log_error(g_storage_logger, "No se pudo leer el bitmap completo");
+  if (bitmap_mapping.bytes == NULL &&
+      bitmap_map(g_storage_config->mount_point) != 0) {
     pthread_mutex_unlock(&g_storage_bitmap_mutex);
-    free(*bitmap_buffer);
-    retval = -3;
-    goto clean_file;
+    return -1;
   }
 
-  *bitmap =
-      bitarray_create_with_mode(*bitmap_buffer, bitmap_size_bytes, MSB_FIRST);
+  *bitmap = bitarray_create_with_mode(bitmap_mapping.bytes,
+                                      bitmap_mapping.size_bytes, MSB_FIRST);
   if (!*bitmap) {
     log_error(g_storage_logger, "No se pudo crear el bitmap en memoria");
     pthread_mutex_unlock(&g_storage_bitmap_mutex);
-    free(*bitmap_buffer);
-    retval = -4;
+    return -4;
   }
 
-clean_file:
-  if (bitmap_file)
-    fclose(bitmap_file);
-end:
-  return retval;
+  // El bitarray apunta al mapeo: no hay copia que liberar
+  *bitmap_buffer = NULL;
+  return 0;
 }
 
 int bitmap_persist(t_bitarray *bitmap, char *bitmap_buffer) {
   int retval = 0;
-  size_t bitmap_size_bytes = g_storage_config->bitmap_size_bytes;
 
-  FILE *bitmap_file = open_bitmap_file("r+b");
-  if (bitmap_file == NULL) {
-    retval = -1;
-    goto end;
+  if (bitmap) {
+    bitarray_destroy(bitmap);
+  }
+  if (bitmap_buffer) {
+    free(bitmap_buffer);
   }
 
-  fseek(bitmap_file, 0, SEEK_SET);
-
-  int written_bytes = fwrite(bitmap_buffer, 1, bitmap_size_bytes, bitmap_file);
-
-  if (written_bytes != (int)bitmap_size_bytes) {
-    log_error(g_storage_logger, "No se pudo escribir el bitmap modificado");
+  if (++bitmap_mapping.pending_changes >= BITMAP_SYNC_BATCH &&
+      bitmap_sync() != 0) {
     retval = -2;
-    goto clean_file;
   }
 
-  log_debug(g_storage_logger, "Bitmap persistido correctamente");
-
-clean_file:
-  if (bitmap_file)
-    fclose(bitmap_file);
-end:
-  if (bitmap)
-    bitarray_destroy(bitmap);
-  if (bitmap_buffer)
-    free(bitmap_buffer);
   pthread_mutex_unlock(&g_storage_bitmap_mutex);
   return retval;
 }
@@ -545,7 +475,7 @@ void set_bitmap_bits(t_bitarray *bitmap, int start_index, size_t count,
     if (set_bits) {
       bitarray_set_bit(bitmap, start_index + i);
     } else {
-      bitarray_clean_bit(bitmap, start_index + i);
+      free_bitmap_bit(bitmap, start_index + i);
     }
   }
 
@@ -10,12 +10,17 @@
 #include <commons/config.h>
 #include <commons/bitarray.h>
 #include "utils/utils.h"
+#include "metadata_store.h"
 
 #define DEFAULT_DIR_PERMISSIONS 0755
 #define FILES_DIR "files"
 #define LOGICAL_BLOCKS_DIR "logical_blocks"
 #define PHYSICAL_BLOCKS_DIR "physical_blocks"
-#define METADATA_CONFIG_FILE "metadata.config"
+#define METADATA_CONFIG_FILE "metadata.config" // Formato anterior, se migra
+#define METADATA_FILE "metadata.bin"
+
+// Cantidad de persistencias del bitmap entre cada msync
+#define BITMAP_SYNC_BATCH 32
 
 // Estados de metadata
 #define IN_PROGRESS "WORK_IN_PROGRESS"
@@ -53,19 +58,6 @@ int create_file_dir_structure(const char *mount_point, const char *file_name,
 int delete_file_dir_structure(const char *mount_point, const char *file_name,
                               const char *tag);
 
-/**
- * Crea un archivo metadata.config con contenido inicial
- *
- * @param mount_point Path de la carpeta donde está montado el filesystem
- * @param file_name Nombre del archivo
- * @param tag Tag del archivo
- * @param initial_content Contenido inicial del metadata (puede ser NULL para
- * contenido por defecto)
- * @return 0 en caso de éxito, -1 si no se puede crear el archivo
- */
-int create_metadata_file(const char *mount_point, const char *file_name,
-                         const char *tag, const char *initial_content);
-
 /**
  * Lee el archivo superblock.config y obtiene la configuración del filesystem
  *
@@ -91,44 +83,6 @@ int read_superblock(const char *mount_point, int *fs_size, int *block_size);
 int modify_bitmap_bits(const char *mount_point, int start_index, size_t count,
                        int set_bits);
 
-/**
- * Contiene todos los datos parseados de un archivo metadata.config
- */
-typedef struct {
-  int size;         // Tamaño del file en bytes
-  int *blocks;      // Indexes de bloques físicos asignados
-  int block_count;  // Cantidad de bloques en el array
-  char *state;      // "WORK_IN_PROGRESS" o "COMMITTED"
-  t_config *config; // Config interno (para modificar/guardar después)
-} t_file_metadata;
-
-/**
- * Lee el metadata.config de un file:tag
- *
- * @param mount_point Path de la carpeta donde está montado el filesystem
- * @param filename Nombre del archivo
- * @param tag Tag del archivo
- * @return Pointer a t_file_metadata, o NULL si hay error
- *         NOTE: Destruir con destroy_file_metadata()
- */
-t_file_metadata *read_file_metadata(const char *mount_point,
-                                    const char *filename, const char *tag);
-
-/**
- * Guarda las modificaciones al struct al disco
- *
- * @param metadata Metadata a guardar
- * @return 0 en caso de éxito, -1 si falla
- */
-int save_file_metadata(t_file_metadata *metadata);
-
-/**
- * Destruye el struct
- *
- * @param metadata Struct a liberar (puede ser NULL)
- */
-void destroy_file_metadata(t_file_metadata *metadata);
-
 /**
  * Elimina un bloque lógico y libera el bloque físico asociado si ya no es
  * referenciado
@@ -196,33 +150,67 @@ int ph_block_links(char *logical_block_path);
 FILE *open_bitmap_file(const char *modes);
 
 /**
- * Carga el bitmap desde disco a un buffer.
- * La función maneja internamente el bloqueo del mutex global g_storage_bitmap_mutex, 
- * pero lo deja desbloqueado en caso de error.
+ * Mapea bitmap.bin en memoria. Se llama una vez al iniciar; bitmap_load y
+ * modify_bitmap_bits lo hacen si todavía no está mapeado.
+ * Debe llamarse con g_storage_bitmap_mutex tomado si ya hay hilos atendiendo.
+ *
+ * @param mount_point Path de la carpeta donde está montado el filesystem
+ * @return int 0 si queda mapeado, -1 si no se puede abrir, -2 si el archivo
+ * es más chico que bitmap_size_bytes, -3 si falla mmap.
+ */
+int bitmap_map(const char *mount_point);
+
+/**
+ * Sincroniza los cambios pendientes del bitmap a disco (msync).
+ * Requiere g_storage_bitmap_mutex tomado.
+ *
+ * @return int 0 si no había cambios o se sincronizaron, -1 si falla msync.
+ */
+int bitmap_sync(void);
+
+/**
+ * Sincroniza y desmapea el bitmap. El próximo acceso lo vuelve a mapear.
+ */
+void bitmap_unmap(void);
+
+/**
+ * Toma g_storage_bitmap_mutex y devuelve un t_bitarray sobre el bitmap
+ * mapeado; no lee el archivo. Lo deja desbloqueado en caso de error.
  * 
  * @param bitmap Doble puntero a t_bitarray donde se almacenará la estructura.
- * @param bitmap_buffer Doble puntero al char donde se almacenará el buffer crudo.
+ * @param bitmap_buffer Queda en NULL: el bitarray apunta al mapeo, no a una copia.
  * @return int 0 si la carga es exitosa, un valor negativo en caso de error.
  */
 int bitmap_load(t_bitarray **bitmap, char **bitmap_buffer);
 
 /**
- * Persiste el bitmap modificado a disco.
+ * Cierra un bitmap obtenido con bitmap_load y libera el mutex. Los cambios ya
+ * están en el mapeo; cada BITMAP_SYNC_BATCH llamadas se hace msync.
  * 
- * @param bitmap La estructura t_bitarray a persistir (será destruida).
- * @param bitmap_buffer El buffer crudo del bitmap (será liberado).
+ * @param bitmap La estructura t_bitarray obtenida con bitmap_load (será destruida).
+ * @param bitmap_buffer El buffer devuelto por bitmap_load (será liberado si no es NULL).
  * @return int 0 si la persistencia es exitosa, un valor negativo en caso de error.
  */
 int bitmap_persist(t_bitarray *bitmap, char *bitmap_buffer);
 
 /**
- * Busca el índice del primer bit libre (0) en el bitmap.
+ * Busca el índice del primer bit libre (0) en el bitmap, de a 64 bits.
+ * Sobre el bitmap mapeado arranca desde el último bloque reservado (next-fit).
  * 
  * @param bitmap La estructura t_bitarray a inspeccionar.
  * @return ssize_t El índice del bit libre encontrado, o -1 si el bitmap está lleno.
  */
 ssize_t get_free_bit_index(t_bitarray *bitmap);
 
+/**
+ * Marca un bloque como libre. A diferencia de bitarray_clean_bit, deja que
+ * get_free_bit_index lo vuelva a ofrecer aunque esté antes del último reservado.
+ *
+ * @param bitmap La estructura t_bitarray a modificar.
+ * @param bit_index Índice del bloque a liberar.
+ */
+void free_bitmap_bit(t_bitarray *bitmap, off_t bit_index);
+
 /**
  * Modifica un rango contiguo de bits en el bitmap.
  * 
@@ -0,0 +1,453 @@
+#include "metadata_store.h"
+#include "filesystem_utils.h"
+#include "../globals/globals.h"
+#include <commons/collections/dictionary.h>
+#include <commons/config.h>
+#include <commons/string.h>
+#include <dirent.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utils/logger.h>
+
+static void metadata_cache_evict_key(const char *key);
+
+static const char *state_name(uint16_t state) {
+  return state == METADATA_STATE_COMMITTED ? COMMITTED : IN_PROGRESS;
+}
+
+static uint16_t state_value(const char *state) {
+  return strcmp(state, COMMITTED) == 0 ? METADATA_STATE_COMMITTED
+                                       : METADATA_STATE_WORK_IN_PROGRESS;
+}
+
+static t_file_metadata *metadata_new(const char *key, const char *path,
+                                     int size, const int *blocks,
+                                     int block_count, const char *state) {
+  t_file_metadata *metadata = calloc(1, sizeof(t_file_metadata));
+  if (!metadata) {
+    return NULL;
+  }
+
+  metadata->size = size;
+  metadata->block_count = block_count;
+  metadata->state = string_duplicate((char *)state);
+  metadata->key = string_duplicate((char *)key);
+  metadata->path = string_duplicate((char *)path);
+
+  if (block_count > 0) {
+    metadata->blocks = malloc(sizeof(int) * block_count);
+    if (metadata->blocks) {
+      memcpy(metadata->blocks, blocks, sizeof(int) * block_count);
+    }
+  }
+
+  if (!metadata->state || !metadata->key || !metadata->path ||
+      (block_count > 0 && !metadata->blocks)) {
+    destroy_file_metadata(metadata);
+    return NULL;
+  }
+
+  return metadata;
+}
+
+static t_file_metadata *metadata_copy(const t_file_metadata *metadata) {
+  return metadata_new(metadata->key, metadata->path, metadata->size,
+                      metadata->blocks, metadata->block_count,
+                      metadata->state);
+}
+
+// Reemplaza la entrada de la caché por una copia de metadata
+static void metadata_cache_put(const t_file_metadata *metadata) {
+  t_file_metadata *cached = metadata_copy(metadata);
+
+  pthread_mutex_lock(&g_metadata_cache_mutex);
+  if (!g_metadata_cache) {
+    g_metadata_cache = dictionary_create();
+  }
+  t_file_metadata *previous = dictionary_remove(g_metadata_cache, metadata->key);
+  if (cached) {
+    dictionary_put(g_metadata_cache, cached->key, cached);
+  }
+  pthread_mutex_unlock(&g_metadata_cache_mutex);
+
+  destroy_file_metadata(previous);
+}
+
+static t_file_metadata *metadata_cache_get_copy(const char *key) {
+  t_file_metadata *copy = NULL;
+
+  pthread_mutex_lock(&g_metadata_cache_mutex);
+  if (g_metadata_cache) {
+    t_file_metadata *cached = dictionary_get(g_metadata_cache, (char *)key);
+    if (cached) {
+      copy = metadata_copy(cached);
+    }
+  }
+  pthread_mutex_unlock(&g_metadata_cache_mutex);
+
+  return copy;
+}
+
+/**
+ * Escribe el metadata.bin en un archivo temporal y lo renombra, así un corte
+ * a mitad de camino deja la versión anterior entera.
+ */
+static int write_metadata_file(const char *path, int size, const int *blocks,
+                               int block_count, const char *state) {
+  int retval = 0;
+
+  char tmp_path[PATH_MAX];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+  FILE *file = fopen(tmp_path, "wb");
+  if (!file) {
+    log_error(g_storage_logger, "No se pudo crear el archivo %s", tmp_path);
+    return -1;
+  }
+
+  t_metadata_header header = {
+      .magic = METADATA_MAGIC,
+      .version = METADATA_VERSION,
+      .state = state_value(state),
+      .size = (uint32_t)size,
+      .block_count = (uint32_t)block_count,
+  };
+
+  uint32_t *disk_blocks = NULL;
+  if (block_count > 0) {
+    disk_blocks = malloc(sizeof(uint32_t) * block_count);
+    if (!disk_blocks) {
+      log_error(g_storage_logger,
+                "No se pudo asignar memoria para los bloques de %s", path);
+      retval = -1;
+      goto clean_file;
+    }
+    for (int i = 0; i < block_count; i++) {
+      disk_blocks[i] = (uint32_t)blocks[i];
+    }
+  }
+
+  if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+      (block_count > 0 &&
+       fwrite(disk_blocks, sizeof(uint32_t), block_count, file) !=
+           (size_t)block_count)) {
+    log_error(g_storage_logger, "No se pudo escribir el metadata %s", tmp_path);
+    retval = -1;
+  }
+
+  free(disk_blocks);
+clean_file:
+  if (fclose(file) != 0 && retval == 0) {
+    log_error(g_storage_logger, "No se pudo escribir el metadata %s", tmp_path);
+    retval = -1;
+  }
+
+  if (retval == 0 && rename(tmp_path, path) != 0) {
+    log_error(g_storage_logger, "No se pudo reemplazar el metadata %s", path);
+    retval = -1;
+  }
+  if (retval != 0) {
+    remove(tmp_path);
+  }
+
+  return retval;
+}
+
+static t_file_metadata *load_metadata_file(const char *key, const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return NULL;
+  }
+
+  t_file_metadata *metadata = NULL;
+  int *blocks = NULL;
+
+  t_metadata_header header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      header.magic != METADATA_MAGIC || header.version != METADATA_VERSION) {
+    log_error(g_storage_logger, "El metadata %s no tiene un header válido",
+              path);
+    goto clean_file;
+  }
+
+  if (header.block_count > 0) {
+    uint32_t *disk_blocks = malloc(sizeof(uint32_t) * header.block_count);
+    blocks = malloc(sizeof(int) * header.block_count);
+    if (!disk_blocks || !blocks ||
+        fread(disk_blocks, sizeof(uint32_t), header.block_count, file) !=
+            header.block_count) {
+      log_error(g_storage_logger, "No se pudieron leer los bloques de %s",
+                path);
+      free(disk_blocks);
+      goto clean_file;
+    }
+    for (uint32_t i = 0; i < header.block_count; i++) {
+      blocks[i] = (int)disk_blocks[i];
+    }
+    free(disk_blocks);
+  }
+
+  metadata = metadata_new(key, path, (int)header.size, blocks,
+                          (int)header.block_count, state_name(header.state));
+
+clean_file:
+  free(blocks);
+  fclose(file);
+  return metadata;
+}
+
+int migrate_metadata_config(const char *tag_dir) {
+  char config_path[PATH_MAX];
+  snprintf(config_path, sizeof(config_path), "%s/%s", tag_dir,
+           METADATA_CONFIG_FILE);
+
+  if (access(config_path, F_OK) != 0) {
+    return 0;
+  }
+
+  t_config *config = config_create(config_path);
+  if (!config) {
+    log_error(g_storage_logger, "No se pudo abrir el metadata.config: %s",
+              config_path);
+    return -1;
+  }
+
+  int retval = -1;
+  char **blocks_str = NULL;
+  int *blocks = NULL;
+
+  if (!config_has_property(config, "SIZE") ||
+      !config_has_property(config, "BLOCKS") ||
+      !config_has_property(config, "ESTADO")) {
+    log_error(g_storage_logger,
+              "El metadata.config no tiene las propiedades requeridas "
+              "(SIZE, BLOCKS, ESTADO): %s",
+              config_path);
+    goto clean_config;
+  }
+
+  blocks_str = config_get_array_value(config, "BLOCKS");
+  int block_count = string_array_size(blocks_str);
+  if (block_count > 0) {
+    blocks = malloc(sizeof(int) * block_count);
+    if (!blocks) {
+      log_error(g_storage_logger,
+                "No se pudo asignar memoria para el array de bloques");
+      goto clean_config;
+    }
+    for (int i = 0; i < block_count; i++) {
+      blocks[i] = atoi(blocks_str[i]);
+    }
+  }
+
+  char metadata_path[PATH_MAX];
+  snprintf(metadata_path, sizeof(metadata_path), "%s/%s", tag_dir,
+           METADATA_FILE);
+
+  if (write_metadata_file(metadata_path, config_get_int_value(config, "SIZE"),
+                          blocks, block_count,
+                          config_get_string_value(config, "ESTADO")) != 0) {
+    goto clean_config;
+  }
+
+  remove(config_path);
+  log_info(g_storage_logger, "Metadata migrado a formato binario: %s",
+           metadata_path);
+  retval = 1;
+
+clean_config:
+  free(blocks);
+  if (blocks_str) {
+    string_array_destroy(blocks_str);
+  }
+  config_destroy(config);
+  return retval;
+}
+
+int migrate_all_metadata(const char *mount_point) {
+  char files_dir[PATH_MAX];
+  snprintf(files_dir, sizeof(files_dir), "%s/%s", mount_point, FILES_DIR);
+
+  DIR *files = opendir(files_dir);
+  if (!files) {
+    log_error(g_storage_logger, "No se pudo abrir la carpeta %s", files_dir);
+    return -1;
+  }
+
+  int migrated = 0;
+  struct dirent *file_entry;
+  while ((file_entry = readdir(files)) != NULL) {
+    if (file_entry->d_name[0] == '.') {
+      continue;
+    }
+
+    char file_dir[PATH_MAX];
+    if (snprintf(file_dir, sizeof(file_dir), "%s/%s", files_dir,
+                 file_entry->d_name) >= (int)sizeof(file_dir)) {
+      log_warning(g_storage_logger, "Ruta demasiado larga, se omite %s/%s",
+                  files_dir, file_entry->d_name);
+      continue;
+    }
+    DIR *tags = opendir(file_dir);
+    if (!tags) {
+      continue;
+    }
+
+    struct dirent *tag_entry;
+    while ((tag_entry = readdir(tags)) != NULL) {
+      if (tag_entry->d_name[0] == '.') {
+        continue;
+      }
+
+      char tag_dir[PATH_MAX];
+      if (snprintf(tag_dir, sizeof(tag_dir), "%s/%s", file_dir,
+                   tag_entry->d_name) >= (int)sizeof(tag_dir)) {
+        log_warning(g_storage_logger, "Ruta demasiado larga, se omite %s/%s",
+                    file_dir, tag_entry->d_name);
+        continue;
+      }
+      if (migrate_metadata_config(tag_dir) > 0) {
+        migrated++;
+      }
+    }
+    closedir(tags);
+  }
+  closedir(files);
+
+  if (migrated > 0) {
+    log_info(g_storage_logger, "Se migraron %d metadata.config a %s", migrated,
+             METADATA_FILE);
+  }
+  return migrated;
+}
+
+int create_metadata_file(const char *mount_point, const char *file_name,
+                         const char *tag, int size, const int *blocks,
+                         int block_count, const char *state) {
+  char metadata_path[PATH_MAX];
+  snprintf(metadata_path, sizeof(metadata_path), "%s/%s/%s/%s/%s",
+           mount_point, FILES_DIR, file_name, tag, METADATA_FILE);
+
+  if (write_metadata_file(metadata_path, size, blocks, block_count, state) !=
+      0) {
+    return -1;
+  }
+
+  char *key = string_from_format("%s:%s", file_name, tag);
+  t_file_metadata *metadata =
+      metadata_new(key, metadata_path, size, blocks, block_count, state);
+  if (metadata) {
+    metadata_cache_put(metadata);
+    destroy_file_metadata(metadata);
+  }
+  free(key);
+
+  return 0;
+}
+
+t_file_metadata *read_file_metadata(const char *mount_point,
+                                    const char *filename, const char *tag) {
+  char *key = string_from_format("%s:%s", filename, tag);
+
+  t_file_metadata *metadata = metadata_cache_get_copy(key);
+  if (metadata) {
+    free(key);
+    return metadata;
+  }
+
+  char tag_dir[PATH_MAX];
+  char metadata_path[PATH_MAX];
+  if (snprintf(tag_dir, sizeof(tag_dir), "%s/%s/%s/%s", mount_point, FILES_DIR,
+               filename, tag) >= (int)sizeof(tag_dir) ||
+      snprintf(metadata_path, sizeof(metadata_path), "%s/%s", tag_dir,
+               METADATA_FILE) >= (int)sizeof(metadata_path)) {
+    log_error(g_storage_logger, "Ruta del metadata demasiado larga para %s",
+              key);
+    free(key);
+    return NULL;
+  }
+
+  if (access(metadata_path, F_OK) != 0 && migrate_metadata_config(tag_dir) <= 0) {
+    log_debug(g_storage_logger, "No existe el metadata de %s", key);
+    free(key);
+    return NULL;
+  }
+
+  metadata = load_metadata_file(key, metadata_path);
+  if (metadata) {
+    metadata_cache_put(metadata);
+    log_debug(g_storage_logger,
+              "Metadata leído: %s:%s - SIZE=%d, BLOCKS=%d, ESTADO=%s",
+              filename, tag, metadata->size, metadata->block_count,
+              metadata->state);
+  }
+
+  free(key);
+  return metadata;
+}
+
+int save_file_metadata(t_file_metadata *metadata) {
+  if (!metadata || !metadata->path || !metadata->key) {
+    log_error(g_storage_logger, "Metadata o path es NULL");
+    return -1;
+  }
+
+  if (write_metadata_file(metadata->path, metadata->size, metadata->blocks,
+                          metadata->block_count, metadata->state) != 0) {
+    // La caché no puede quedar adelantada respecto del disco
+    metadata_cache_evict_key(metadata->key);
+    return -1;
+  }
+
+  metadata_cache_put(metadata);
+  log_debug(g_storage_logger, "Metadata guardada");
+  return 0;
+}
+
+void destroy_file_metadata(t_file_metadata *metadata) {
+  if (!metadata) {
+    return;
+  }
+
+  free(metadata->blocks);
+  free(metadata->state);
+  free(metadata->key);
+  free(metadata->path);
+  free(metadata);
+}
+
+static void destroy_cached_metadata(void *metadata) {
+  destroy_file_metadata(metadata);
+}
+
+static void metadata_cache_evict_key(const char *key) {
+  t_file_metadata *cached = NULL;
+
+  pthread_mutex_lock(&g_metadata_cache_mutex);
+  if (g_metadata_cache) {
+    cached = dictionary_remove(g_metadata_cache, (char *)key);
+  }
+  pthread_mutex_unlock(&g_metadata_cache_mutex);
+
+  destroy_file_metadata(cached);
+}
+
+void metadata_cache_evict(const char *file_name, const char *tag) {
+  char *key = string_from_format("%s:%s", file_name, tag);
+  metadata_cache_evict_key(key);
+  free(key);
+}
+
+void metadata_cache_clear(void) {
+  pthread_mutex_lock(&g_metadata_cache_mutex);
+  if (g_metadata_cache) {
+    dictionary_destroy_and_destroy_elements(g_metadata_cache,
+                                            destroy_cached_metadata);
+    g_metadata_cache = NULL;
+  }
+  pthread_mutex_unlock(&g_metadata_cache_mutex);
+}
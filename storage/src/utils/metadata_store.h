@@ -0,0 +1,113 @@
+#ifndef METADATA_STORE_H
+#define METADATA_STORE_H
+
+#include <stdint.h>
+
+/*
+ * Metadata de cada File:Tag en files/<name>/<tag>/metadata.bin: un header fijo
+ * seguido de un uint32 por bloque lógico, en el orden de bytes del host.
+ * Se guarda también en una caché en memoria por File:Tag, así las operaciones
+ * no vuelven a leer el archivo; cada save_file_metadata escribe a disco
+ * (write-through) y actualiza la caché.
+ */
+#define METADATA_MAGIC 0x4D464F4D // "MOFM"
+#define METADATA_VERSION 1
+
+typedef enum {
+  METADATA_STATE_WORK_IN_PROGRESS = 0,
+  METADATA_STATE_COMMITTED = 1,
+} t_metadata_state;
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t state;       // t_metadata_state
+  uint32_t size;        // Tamaño del file en bytes
+  uint32_t block_count; // Cantidad de uint32 que siguen al header
+} t_metadata_header;
+
+/**
+ * Contiene todos los datos de la metadata de un File:Tag
+ */
+typedef struct {
+  int size;        // Tamaño del file en bytes
+  int *blocks;     // Indexes de bloques físicos asignados
+  int block_count; // Cantidad de bloques en el array
+  char *state;     // "WORK_IN_PROGRESS" o "COMMITTED"
+  char *key;       // "name:tag", clave en la caché
+  char *path;      // Path del metadata.bin (para guardar después)
+} t_file_metadata;
+
+/**
+ * Crea el metadata.bin de un file:tag y lo agrega a la caché
+ *
+ * @param mount_point Path de la carpeta donde está montado el filesystem
+ * @param file_name Nombre del archivo
+ * @param tag Tag del archivo
+ * @param size Tamaño inicial en bytes
+ * @param blocks Bloques físicos de cada bloque lógico (puede ser NULL si
+ * block_count es 0)
+ * @param block_count Cantidad de bloques lógicos
+ * @param state IN_PROGRESS o COMMITTED
+ * @return 0 en caso de éxito, -1 si no se puede crear el archivo
+ */
+int create_metadata_file(const char *mount_point, const char *file_name,
+                         const char *tag, int size, const int *blocks,
+                         int block_count, const char *state);
+
+/**
+ * Devuelve la metadata de un file:tag, desde la caché si ya se leyó.
+ * Si sólo existe el metadata.config del formato anterior, lo migra.
+ *
+ * @param mount_point Path de la carpeta donde está montado el filesystem
+ * @param filename Nombre del archivo
+ * @param tag Tag del archivo
+ * @return Pointer a una copia de la metadata, o NULL si hay error
+ *         NOTE: Destruir con destroy_file_metadata()
+ */
+t_file_metadata *read_file_metadata(const char *mount_point,
+                                    const char *filename, const char *tag);
+
+/**
+ * Guarda las modificaciones al struct al disco y a la caché
+ *
+ * @param metadata Metadata a guardar
+ * @return 0 en caso de éxito, -1 si falla
+ */
+int save_file_metadata(t_file_metadata *metadata);
+
+/**
+ * Destruye el struct
+ *
+ * @param metadata Struct a liberar (puede ser NULL)
+ */
+void destroy_file_metadata(t_file_metadata *metadata);
+
+/**
+ * Convierte el metadata.config de un file:tag a metadata.bin y lo elimina
+ *
+ * @param tag_dir Path de la carpeta files/<name>/<tag>
+ * @return 1 si migró, 0 si no había metadata.config, -1 si falla
+ */
+int migrate_metadata_config(const char *tag_dir);
+
+/**
+ * Migra todos los metadata.config del filesystem. Se llama al iniciar sin
+ * FRESH_START; read_file_metadata migra igual los que encuentre después.
+ *
+ * @param mount_point Path de la carpeta donde está montado el filesystem
+ * @return Cantidad de archivos migrados, o -1 si no se puede recorrer files/
+ */
+int migrate_all_metadata(const char *mount_point);
+
+/**
+ * Quita un file:tag de la caché (por ejemplo al eliminar su carpeta)
+ */
+void metadata_cache_evict(const char *file_name, const char *tag);
+
+/**
+ * Vacía la caché de metadata
+ */
+void metadata_cache_clear(void);
+
+#endif
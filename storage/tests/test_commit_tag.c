@@ -131,27 +131,12 @@ context(tests_commit_tag) {
             should_int(result) be equal to (0);
             
             // verificación del registro de hash
-            char hash_index_path[PATH_MAX];
-            get_hash_index_config_path(hash_index_path);
-            t_config *hash_config = config_create(hash_index_path);
-
-            char *read_buffer = (char *)malloc(g_storage_config->block_size);
-            memset(read_buffer, 0, g_storage_config->block_size);
-            memcpy(read_buffer, content, strlen(content));
-
-            char *hash = crypto_md5(read_buffer, g_storage_config->block_size);
-            should_bool(config_has_property(hash_config, hash)) be truthy;
-            
-            char *ph_block_name = config_get_string_value(hash_config, hash);
-            should_string(ph_block_name) be equal to ("block0003");
+            should_int((int)lookup_persisted_hash(content, strlen(content))) be equal to (3);
             
             t_file_metadata *metadata_after_commit = read_file_metadata(g_storage_config->mount_point, name, tag);
             should_string(metadata_after_commit->state) be equal to ((char*)COMMITTED);
             
             // Cleanup de verificación
-            free(hash);
-            free(read_buffer);
-            config_destroy(hash_config);
             if (metadata_after_commit) destroy_file_metadata(metadata_after_commit);
             should_bool(correct_unlock(name, tag)) be truthy;
         } end
@@ -184,21 +169,9 @@ context(tests_commit_tag) {
             should_int(result) be equal to (0);
                         
             // verificación del registro de hash
-            char hash_index_path[PATH_MAX];
-            get_hash_index_config_path(hash_index_path);
-            t_config *hash_config = config_create(hash_index_path);
-
-            char *read_buffer = (char *)malloc(g_storage_config->block_size);
-            memset(read_buffer, 0, g_storage_config->block_size);
-            memcpy(read_buffer, content, strlen(content));
-
-            char *hash = crypto_md5(read_buffer, g_storage_config->block_size);
-            should_bool(config_has_property(hash_config, hash)) be truthy;
-            
-            char *ph_block_name = config_get_string_value(hash_config, hash);
-            should_string(ph_block_name) be equal to ("block0003");            
+            should_int((int)lookup_persisted_hash(content, strlen(content))) be equal to (3);
 
-            should_int(config_keys_amount(hash_config)) be equal to (1); // Solo un bloque físico debe estar registrado
+            should_int((int)block_index_size()) be equal to (1); // Solo un bloque físico debe estar registrado
             
             t_file_metadata *metadata_after_commit = read_file_metadata(g_storage_config->mount_point, name, tag2);
             should_string(metadata_after_commit->state) be equal to ((char*)COMMITTED);
@@ -212,14 +185,62 @@ context(tests_commit_tag) {
             bitmap_close(bitmap, bitmap_buffer);
             
             // Cleanup de verificación
-            free(hash);
-            free(read_buffer);
-            config_destroy(hash_config);
             if (metadata_after_commit) destroy_file_metadata(metadata_after_commit);
             should_bool(correct_unlock(name, tag1)) be truthy;
             should_bool(correct_unlock(name, tag2)) be truthy;
         } end
 
+        it ("Debe quitar del índice el hash del bloque físico que libera") {
+            char *name = "file1";
+            char *tag1 = "tag1";
+            char *tag2 = "tag2";
+            char *content = "Contenido duplicado para commit final";
+            char *old_content = "Contenido anterior del bloque 5";
+
+            init_logical_blocks(name, tag1, 1, TEST_MOUNT_POINT);
+            write_physical_block_content(3, content, strlen(content));
+            link_logical_to_physical(name, tag1, 0, 3);
+            create_test_metadata(name, tag1, 1, "[3]", (char*)IN_PROGRESS, g_storage_config->mount_point);
+            define_bitmap_bit(3, true);
+
+            execute_tag_commit(200, name, tag1);
+
+            // El bloque 5 quedó registrado en el índice con un contenido anterior
+            char *padded = calloc(1, g_storage_config->block_size);
+            memcpy(padded, old_content, strlen(old_content));
+            t_block_digest old_digest;
+            block_index_digest(padded, g_storage_config->block_size, &old_digest);
+            free(padded);
+            block_index_open(TEST_MOUNT_POINT);
+            block_index_insert(&old_digest, 5);
+            block_index_commit();
+
+            init_logical_blocks(name, tag2, 1, TEST_MOUNT_POINT);
+            write_physical_block_content(5, content, strlen(content));
+            link_logical_to_physical(name, tag2, 0, 5);
+            create_test_metadata(name, tag2, 1, "[5]", (char*)IN_PROGRESS, g_storage_config->mount_point);
+            define_bitmap_bit(5, true);
+
+            int result = execute_tag_commit(201, name, tag2);
+
+            should_int(result) be equal to (0);
+
+            // El bloque 5 quedó libre: su hash no debe resolver ni en memoria ni al releer el log
+            should_int((int)block_index_lookup(&old_digest)) be equal to (-1);
+            should_int((int)lookup_persisted_hash(old_content, strlen(old_content))) be equal to (-1);
+            should_int((int)lookup_persisted_hash(content, strlen(content))) be equal to (3);
+            should_int((int)block_index_size()) be equal to (1);
+
+            t_bitarray *bitmap = NULL;
+            char *bitmap_buffer = NULL;
+            bitmap_load(&bitmap, &bitmap_buffer);
+            should_bool(bitarray_test_bit(bitmap, 5)) be equal to (false);
+            bitmap_close(bitmap, bitmap_buffer);
+
+            should_bool(correct_unlock(name, tag1)) be truthy;
+            should_bool(correct_unlock(name, tag2)) be truthy;
+        } end
+
         it ("Debe comitear exitosamente un archivo con bloques duplicados (liberando los bloques fisicos anteriores)") {
             char *name = "file1";
             char *tag1 = "tag1";
@@ -251,21 +272,9 @@ context(tests_commit_tag) {
             should_int(result) be equal to (0);
                         
             // verificación del registro de hash
-            char hash_index_path[PATH_MAX];
-            get_hash_index_config_path(hash_index_path);
-            t_config *hash_config = config_create(hash_index_path);
+            should_int((int)lookup_persisted_hash(content, strlen(content))) be equal to (3);            
 
-            char *read_buffer = (char *)malloc(g_storage_config->block_size);
-            memset(read_buffer, 0, g_storage_config->block_size);
-            memcpy(read_buffer, content, strlen(content));
-
-            char *hash = crypto_md5(read_buffer, g_storage_config->block_size);
-            should_bool(config_has_property(hash_config, hash)) be truthy;
-            
-            char *ph_block_name = config_get_string_value(hash_config, hash);
-            should_string(ph_block_name) be equal to ("block0003");            
-
-            should_int(config_keys_amount(hash_config)) be equal to (1); // Solo un bloque físico debe estar registrado
+            should_int((int)block_index_size()) be equal to (1); // Solo un bloque físico debe estar registrado
             
             t_file_metadata *metadata_after_commit = read_file_metadata(g_storage_config->mount_point, name, tag2);
             should_string(metadata_after_commit->state) be equal to ((char*)COMMITTED);
@@ -281,14 +290,90 @@ context(tests_commit_tag) {
             bitmap_close(bitmap, bitmap_buffer);
             
             // Cleanup de verificación
-            free(hash);
-            free(read_buffer);
-            config_destroy(hash_config);
             if (metadata_after_commit) destroy_file_metadata(metadata_after_commit);
             should_bool(correct_unlock(name, tag1)) be truthy;
             should_bool(correct_unlock(name, tag2)) be truthy;
         } end
 
+        it ("Debe deduplicar igual hasheando los bloques con varios hilos") {
+            char *name = "file1";
+            char *tag = "tag1";
+            char *contents[] = {"Bloque A", "Bloque B", "Bloque A", "Bloque C", "Bloque B", "Bloque A"};
+            g_storage_config->commit_threads = 4;
+
+            init_logical_blocks(name, tag, 6, TEST_MOUNT_POINT);
+            for (int i = 0; i < 6; i++) {
+                write_physical_block_content(3 + i, contents[i], strlen(contents[i]));
+                link_logical_to_physical(name, tag, i, 3 + i);
+                define_bitmap_bit(3 + i, true);
+            }
+            create_test_metadata(name, tag, 6, "[3, 4, 5, 6, 7, 8]", (char*)IN_PROGRESS, g_storage_config->mount_point);
+
+            int result = execute_tag_commit(202, name, tag);
+
+            should_int(result) be equal to (0);
+
+            // Mismo resultado que en serie: cada contenido queda en su primera aparición
+            int expected_blocks[] = {3, 4, 3, 6, 4, 3};
+            t_file_metadata *metadata_after_commit = read_persisted_metadata(name, tag);
+            for (int i = 0; i < 6; i++) {
+                should_int(metadata_after_commit->blocks[i]) be equal to (expected_blocks[i]);
+            }
+            should_int((int)lookup_persisted_hash(contents[3], strlen(contents[3]))) be equal to (6);
+            should_int((int)block_index_size()) be equal to (3);
+
+            t_bitarray *bitmap = NULL;
+            char *bitmap_buffer = NULL;
+            bitmap_load(&bitmap, &bitmap_buffer);
+            should_bool(bitarray_test_bit(bitmap, 5)) be equal to (false);
+            should_bool(bitarray_test_bit(bitmap, 7)) be equal to (false);
+            should_bool(bitarray_test_bit(bitmap, 8)) be equal to (false);
+            bitmap_close(bitmap, bitmap_buffer);
+
+            destroy_file_metadata(metadata_after_commit);
+        } end
+
+        it ("Con VERIFY_DEDUP no debe reasignar un bloque si el hash coincide pero el contenido no") {
+            char *name = "file1";
+            char *tag = "tag1";
+            char *content = "Contenido del bloque a comitear";
+            g_storage_config->verify_dedup = true;
+
+            init_logical_blocks(name, tag, 1, TEST_MOUNT_POINT);
+            write_physical_block_content(5, content, strlen(content));
+            link_logical_to_physical(name, tag, 0, 5);
+            create_test_metadata(name, tag, 1, "[5]", (char*)IN_PROGRESS, g_storage_config->mount_point);
+            define_bitmap_bit(5, true);
+
+            // Simula una colisión: el hash del contenido apunta a un bloque con otros bytes
+            char *other_content = "Otro contenido";
+            write_physical_block_content(3, other_content, strlen(other_content));
+            char *padded = calloc(1, g_storage_config->block_size);
+            memcpy(padded, content, strlen(content));
+            t_block_digest digest;
+            block_index_digest(padded, g_storage_config->block_size, &digest);
+            free(padded);
+            block_index_open(TEST_MOUNT_POINT);
+            block_index_insert(&digest, 3);
+            block_index_commit();
+
+            int result = execute_tag_commit(203, name, tag);
+
+            should_int(result) be equal to (0);
+
+            t_file_metadata *metadata_after_commit = read_persisted_metadata(name, tag);
+            should_string(metadata_after_commit->state) be equal to ((char*)COMMITTED);
+            should_int(metadata_after_commit->blocks[0]) be equal to (5);
+
+            t_bitarray *bitmap = NULL;
+            char *bitmap_buffer = NULL;
+            bitmap_load(&bitmap, &bitmap_buffer);
+            should_bool(bitarray_test_bit(bitmap, 5)) be equal to (true);
+            bitmap_close(bitmap, bitmap_buffer);
+
+            destroy_file_metadata(metadata_after_commit);
+        } end
+
         it ("Debe retornar SUCCESS si el archivo ya esta en estado COMMITTED (Idempotencia)") {
             char *name = "file1";
             char *tag = "tag1";
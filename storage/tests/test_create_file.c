@@ -68,15 +68,16 @@ context(test_create_file) {
 
     // Verificar archivo de metadata
     snprintf(target_path, sizeof(target_path),
-             "%s/files/test_file/v1/metadata.config", TEST_MOUNT_POINT);
+             "%s/files/test_file/v1/metadata.bin", TEST_MOUNT_POINT);
     should_bool(file_exists(target_path)) be truthy;
 
     // Verificar contenido de metadata
-    char metadata_content[256];
-    read_file_contents(target_path, metadata_content, sizeof(metadata_content));
-    should_ptr(strstr(metadata_content, "SIZE=0")) not be null;
-    should_ptr(strstr(metadata_content, "BLOCKS=[]")) not be null;
-    should_ptr(strstr(metadata_content, "ESTADO=WORK_IN_PROGRESS")) not be null;
+    t_file_metadata *metadata = read_persisted_metadata("test_file", "v1");
+    should_ptr(metadata) not be null;
+    should_int(metadata->size) be equal to(0);
+    should_int(metadata->block_count) be equal to(0);
+    should_string(metadata->state) be equal to("WORK_IN_PROGRESS");
+    destroy_file_metadata(metadata);
   }
   end
 
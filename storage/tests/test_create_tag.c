@@ -61,7 +61,7 @@ context(test_create_tag) {
 
       char metadata_path[PATH_MAX];
       snprintf(metadata_path, sizeof(metadata_path),
-               "%s/files/test_file/v2/metadata.config", TEST_MOUNT_POINT);
+               "%s/files/test_file/v2/metadata.bin", TEST_MOUNT_POINT);
       should_bool(file_exists(metadata_path)) be truthy;
     }
     end
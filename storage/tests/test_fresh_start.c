@@ -159,13 +159,13 @@ end
 end
 
     describe("funcion init_blocks_index"){
-        it("crea archivo blocks_hash_index.config"){
+        it("crea archivo blocks_hash_index.bin"){
             int result = init_blocks_index(TEST_MOUNT_POINT);
 
 should_int(result) be equal to(0);
 
 char blocks_path[PATH_MAX];
-snprintf(blocks_path, sizeof(blocks_path), "%s/blocks_hash_index.config",
+snprintf(blocks_path, sizeof(blocks_path), "%s/blocks_hash_index.bin",
          TEST_MOUNT_POINT);
 
 should_bool(file_exists(blocks_path)) be truthy;
@@ -259,15 +259,17 @@ should_bool(directory_exists(logical_blocks_dir)) be truthy;
 
 char metadata_file[PATH_MAX];
 snprintf(metadata_file, sizeof(metadata_file),
-         "%s/files/initial_file/BASE/metadata.config", TEST_MOUNT_POINT);
+         "%s/files/initial_file/BASE/metadata.bin", TEST_MOUNT_POINT);
 should_bool(file_exists(metadata_file)) be truthy;
 
 // Verificar contenido de metadata
-char metadata_content[256];
-read_file_contents(metadata_file, metadata_content, sizeof(metadata_content));
-should_ptr(strstr(metadata_content, "SIZE=0")) not be null;
-should_ptr(strstr(metadata_content, "BLOCKS=[0]")) not be null;
-should_ptr(strstr(metadata_content, "ESTADO=COMMITTED")) not be null;
+t_file_metadata *metadata = read_persisted_metadata("initial_file", "BASE");
+should_ptr(metadata) not be null;
+should_int(metadata->size) be equal to(0);
+should_int(metadata->block_count) be equal to(1);
+should_int(metadata->blocks[0]) be equal to(0);
+should_string(metadata->state) be equal to("COMMITTED");
+destroy_file_metadata(metadata);
 
 // Verificar hardlink
 char physical_block[PATH_MAX], logical_block[PATH_MAX];
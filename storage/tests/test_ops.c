@@ -59,17 +59,16 @@ context(test_ops) {
       // Verificar archivo de metadata
       char metadata_file[PATH_MAX];
       snprintf(metadata_file, sizeof(metadata_file),
-               "%s/files/test_file/v1/metadata.config", TEST_MOUNT_POINT);
+               "%s/files/test_file/v1/metadata.bin", TEST_MOUNT_POINT);
       should_bool(file_exists(metadata_file)) be truthy;
 
       // Verificar contenido de metadata
-      char metadata_content[256];
-      read_file_contents(metadata_file, metadata_content,
-                         sizeof(metadata_content));
-      should_ptr(strstr(metadata_content, "SIZE=0")) not be null;
-      should_ptr(strstr(metadata_content, "BLOCKS=[]")) not be null;
-      should_ptr(strstr(metadata_content, "ESTADO=WORK_IN_PROGRESS"))
-          not be null;
+      t_file_metadata *metadata = read_persisted_metadata("test_file", "v1");
+      should_ptr(metadata) not be null;
+      should_int(metadata->size) be equal to(0);
+      should_int(metadata->block_count) be equal to(0);
+      should_string(metadata->state) be equal to("WORK_IN_PROGRESS");
+      destroy_file_metadata(metadata);
     }
     end
 
@@ -143,12 +142,8 @@ context(test_ops) {
       _create_file(6, "test_truncate", "v1", TEST_MOUNT_POINT);
 
       // Simular archivo con 3 bloques
-      char metadata_path[PATH_MAX];
-      snprintf(metadata_path, sizeof(metadata_path),
-               "%s/files/test_truncate/v1/metadata.config", TEST_MOUNT_POINT);
-      FILE *metadata = fopen(metadata_path, "w");
-      fprintf(metadata, "SIZE=384\nBLOCKS=[1,2,3]\nESTADO=WORK_IN_PROGRESS\n");
-      fclose(metadata);
+      create_metadata_file(TEST_MOUNT_POINT, "test_truncate", "v1", 384,
+                           (int[]){1, 2, 3}, 3, IN_PROGRESS);
 
       // Truncar a 2 bloques (256 bytes)
       int result =
@@ -157,11 +152,12 @@ context(test_ops) {
       should_int(result) be equal to(0);
 
       // Verificar que la metadata se actualizó correctamente
-      char metadata_content[256];
-      read_file_contents(metadata_path, metadata_content,
-                         sizeof(metadata_content));
-      should_ptr(strstr(metadata_content, "SIZE=256")) not be null;
-      should_ptr(strstr(metadata_content, "BLOCKS=[1,2]")) not be null;
+      t_file_metadata *metadata = read_persisted_metadata("test_truncate", "v1");
+      should_int(metadata->size) be equal to(256);
+      should_int(metadata->block_count) be equal to(2);
+      should_int(metadata->blocks[0]) be equal to(1);
+      should_int(metadata->blocks[1]) be equal to(2);
+      destroy_file_metadata(metadata);
     }
     end
 
@@ -169,12 +165,8 @@ context(test_ops) {
       // Crear archivo de prueba con 1 bloque
       _create_file(8, "test_expand", "v1", TEST_MOUNT_POINT);
 
-      char metadata_path[PATH_MAX];
-      snprintf(metadata_path, sizeof(metadata_path),
-               "%s/files/test_expand/v1/metadata.config", TEST_MOUNT_POINT);
-      FILE *metadata = fopen(metadata_path, "w");
-      fprintf(metadata, "SIZE=128\nBLOCKS=[1]\nESTADO=WORK_IN_PROGRESS\n");
-      fclose(metadata);
+      create_metadata_file(TEST_MOUNT_POINT, "test_expand", "v1", 128,
+                           (int[]){1}, 1, IN_PROGRESS);
 
       // Expandir a 3 bloques (384 bytes)
       int result = truncate_file(9, "test_expand", "v1", 384, TEST_MOUNT_POINT);
@@ -182,11 +174,13 @@ context(test_ops) {
       should_int(result) be equal to(0);
 
       // Verificar que la metadata se actualizó correctamente
-      char metadata_content[256];
-      read_file_contents(metadata_path, metadata_content,
-                         sizeof(metadata_content));
-      should_ptr(strstr(metadata_content, "SIZE=384")) not be null;
-      should_ptr(strstr(metadata_content, "BLOCKS=[1,0,0]")) not be null;
+      t_file_metadata *metadata = read_persisted_metadata("test_expand", "v1");
+      should_int(metadata->size) be equal to(384);
+      should_int(metadata->block_count) be equal to(3);
+      should_int(metadata->blocks[0]) be equal to(1);
+      should_int(metadata->blocks[1]) be equal to(0);
+      should_int(metadata->blocks[2]) be equal to(0);
+      destroy_file_metadata(metadata);
     }
     end
 
@@ -203,13 +197,8 @@ context(test_ops) {
       // Crear archivo de prueba
       _create_file(12, "test_same_blocks", "v1", TEST_MOUNT_POINT);
 
-      char metadata_path[PATH_MAX];
-      snprintf(metadata_path, sizeof(metadata_path),
-               "%s/files/test_same_blocks/v1/metadata.config",
-               TEST_MOUNT_POINT);
-      FILE *metadata = fopen(metadata_path, "w");
-      fprintf(metadata, "SIZE=200\nBLOCKS=[1,2]\nESTADO=WORK_IN_PROGRESS\n");
-      fclose(metadata);
+      create_metadata_file(TEST_MOUNT_POINT, "test_same_blocks", "v1", 200,
+                           (int[]){1, 2}, 2, IN_PROGRESS);
 
       // Cambiar a un tamaño que sigue necesitando 2 bloques
       int result =
@@ -217,35 +206,31 @@ context(test_ops) {
 
       should_int(result) be equal to(0);
 
-      char metadata_content[256];
-      read_file_contents(metadata_path, metadata_content,
-                         sizeof(metadata_content));
-      should_ptr(strstr(metadata_content, "BLOCKS=[1,2]")) not be null;
+      t_file_metadata *metadata =
+          read_persisted_metadata("test_same_blocks", "v1");
+      should_int(metadata->block_count) be equal to(2);
+      should_int(metadata->blocks[0]) be equal to(1);
+      should_int(metadata->blocks[1]) be equal to(2);
+      destroy_file_metadata(metadata);
     }
     end
 
     it("trunca archivo a tamaño 0") {
       _create_file(14, "test_truncate_zero", "v1", TEST_MOUNT_POINT);
 
-      char metadata_path[PATH_MAX];
-      snprintf(metadata_path, sizeof(metadata_path),
-               "%s/files/test_truncate_zero/v1/metadata.config",
-               TEST_MOUNT_POINT);
-      FILE *metadata = fopen(metadata_path, "w");
-      fprintf(metadata,
-              "SIZE=512\nBLOCKS=[1,2,3,4]\nESTADO=WORK_IN_PROGRESS\n");
-      fclose(metadata);
+      create_metadata_file(TEST_MOUNT_POINT, "test_truncate_zero", "v1", 512,
+                           (int[]){1, 2, 3, 4}, 4, IN_PROGRESS);
 
       int result =
           truncate_file(15, "test_truncate_zero", "v1", 0, TEST_MOUNT_POINT);
 
       should_int(result) be equal to(0);
 
-      char metadata_content[256];
-      read_file_contents(metadata_path, metadata_content,
-                         sizeof(metadata_content));
-      should_ptr(strstr(metadata_content, "SIZE=0")) not be null;
-      should_ptr(strstr(metadata_content, "BLOCKS=[]")) not be null;
+      t_file_metadata *metadata =
+          read_persisted_metadata("test_truncate_zero", "v1");
+      should_int(metadata->size) be equal to(0);
+      should_int(metadata->block_count) be equal to(0);
+      destroy_file_metadata(metadata);
     }
     end
   }
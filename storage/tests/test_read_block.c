@@ -15,12 +15,17 @@
 
 // Helper para crear un archivo de bloque con contenido específico
 void create_test_block_file(const char *path, const char *content, size_t size) {
+    // El bloque ocupa 'size' bytes: empieza con el contenido y el resto son ceros
+    char *block = calloc(1, size);
+    size_t content_size = strlen(content);
+    memcpy(block, content, content_size < size ? content_size : size);
+
     FILE *file = fopen(path, "wb");
     if (file) {
-        // Escribe solo 'size' bytes para simular el contenido del bloque.
-        fwrite(content, 1, size, file); 
+        fwrite(block, 1, size, file); 
         fclose(file);
     }
+    free(block);
 }
 
 // --- Inicio del Contexto de Pruebas ---
@@ -242,6 +247,47 @@ context(tests_read_block) {
             should_bool(correct_unlock("file1", "tag1")) be truthy;
             free(read_buffer);
         } end
+
+        it ("Lectura de varios bloques en un solo pedido") {
+            init_logical_blocks("file1", "tag1", 3, TEST_MOUNT_POINT);
+            create_test_metadata("file1", "tag1", 3, "[1,2,3]", "COMMITTED", TEST_MOUNT_POINT);
+
+            char logical_block_path[PATH_MAX];
+            // Se reemplazan los hardlinks para que cada bloque tenga su propio contenido
+            snprintf(logical_block_path, sizeof(logical_block_path),
+                     "%s/files/file1/tag1/logical_blocks/%04d.dat", TEST_MOUNT_POINT, 0);
+            remove(logical_block_path);
+            create_test_block_file(logical_block_path, "BLOQUE_000", g_storage_config->block_size);
+            snprintf(logical_block_path, sizeof(logical_block_path),
+                     "%s/files/file1/tag1/logical_blocks/%04d.dat", TEST_MOUNT_POINT, 2);
+            remove(logical_block_path);
+            create_test_block_file(logical_block_path, "BLOQUE_002", g_storage_config->block_size);
+
+            uint32_t blocks[] = {2, 0};
+            char *read_buffer = malloc(2 * g_storage_config->block_size + 1);
+
+            int retval = execute_blocks_read("file1", "tag1", 12, blocks, 2, read_buffer);
+
+            should_int(retval) be equal to (0);
+            should_bool(memcmp(read_buffer, "BLOQUE_002", 10) == 0) be truthy;
+            should_bool(memcmp(read_buffer + g_storage_config->block_size, "BLOQUE_000", 10) == 0) be truthy;
+            should_bool(correct_unlock("file1", "tag1")) be truthy;
+            free(read_buffer);
+        } end
+
+        it ("Un bloque fuera de rango hace fallar todo el pedido") {
+            init_logical_blocks("file1", "tag1", 3, TEST_MOUNT_POINT);
+            create_test_metadata("file1", "tag1", 3, "[1,2,3]", "COMMITTED", TEST_MOUNT_POINT);
+
+            uint32_t blocks[] = {0, 7};
+            char *read_buffer = malloc(2 * g_storage_config->block_size + 1);
+
+            int retval = execute_blocks_read("file1", "tag1", 12, blocks, 2, read_buffer);
+
+            should_int(retval) be equal to (READ_OUT_OF_BOUNDS);
+            should_bool(correct_unlock("file1", "tag1")) be truthy;
+            free(read_buffer);
+        } end
     } end
 
 
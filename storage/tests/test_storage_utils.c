@@ -78,6 +78,331 @@ context(test_storage_utils) {
     }
     end
   }
+  end
+
+    describe("metadata binario") {
+    t_log *test_logger;
+
+    before {
+      create_test_directory();
+      test_logger = create_test_logger();
+      g_storage_logger = test_logger;
+      create_file_dir_structure(TEST_MOUNT_POINT, "legacy", "v1");
+    }
+    end
+
+        after {
+      destroy_test_logger(test_logger);
+      cleanup_test_directory();
+    }
+    end
+
+    it("migra un metadata.config al leerlo") {
+      char tag_dir[PATH_MAX];
+      snprintf(tag_dir, sizeof(tag_dir), "%s/files/legacy/v1", TEST_MOUNT_POINT);
+      char config_path[PATH_MAX];
+      snprintf(config_path, sizeof(config_path), "%s/metadata.config", tag_dir);
+      FILE *config_file = fopen(config_path, "w");
+      fprintf(config_file, "SIZE=384\nBLOCKS=[4,0,7]\nESTADO=COMMITTED\n");
+      fclose(config_file);
+
+      t_file_metadata *metadata =
+          read_file_metadata(TEST_MOUNT_POINT, "legacy", "v1");
+      should_ptr(metadata) not be null;
+      should_int(metadata->size) be equal to(384);
+      should_int(metadata->block_count) be equal to(3);
+      should_int(metadata->blocks[0]) be equal to(4);
+      should_int(metadata->blocks[2]) be equal to(7);
+      should_string(metadata->state) be equal to("COMMITTED");
+      destroy_file_metadata(metadata);
+
+      char bin_path[PATH_MAX];
+      snprintf(bin_path, sizeof(bin_path), "%s/metadata.bin", tag_dir);
+      should_bool(file_exists(bin_path)) be truthy;
+      should_bool(file_exists(config_path)) be falsey;
+    }
+    end
+
+    it("migra todos los metadata.config del filesystem") {
+      create_file_dir_structure(TEST_MOUNT_POINT, "legacy", "v2");
+      for (int i = 1; i <= 2; i++) {
+        char config_path[PATH_MAX];
+        snprintf(config_path, sizeof(config_path),
+                 "%s/files/legacy/v%d/metadata.config", TEST_MOUNT_POINT, i);
+        FILE *config_file = fopen(config_path, "w");
+        fprintf(config_file, "SIZE=0\nBLOCKS=[]\nESTADO=WORK_IN_PROGRESS\n");
+        fclose(config_file);
+      }
+
+      should_int(migrate_all_metadata(TEST_MOUNT_POINT)) be equal to(2);
+      should_int(migrate_all_metadata(TEST_MOUNT_POINT)) be equal to(0);
+    }
+    end
+
+    it("guarda a disco y actualiza la caché") {
+      create_metadata_file(TEST_MOUNT_POINT, "legacy", "v1", 0, NULL, 0,
+                           IN_PROGRESS);
+
+      t_file_metadata *metadata =
+          read_file_metadata(TEST_MOUNT_POINT, "legacy", "v1");
+      metadata->size = 256;
+      metadata->blocks = malloc(sizeof(int) * 2);
+      metadata->blocks[0] = 9;
+      metadata->blocks[1] = 0;
+      metadata->block_count = 2;
+      should_int(save_file_metadata(metadata)) be equal to(0);
+      destroy_file_metadata(metadata);
+
+      t_file_metadata *cached =
+          read_file_metadata(TEST_MOUNT_POINT, "legacy", "v1");
+      t_file_metadata *persisted = read_persisted_metadata("legacy", "v1");
+      should_int(cached->block_count) be equal to(2);
+      should_int(persisted->block_count) be equal to(2);
+      should_int(persisted->blocks[0]) be equal to(9);
+      should_int(persisted->size) be equal to(256);
+      destroy_file_metadata(cached);
+      destroy_file_metadata(persisted);
+    }
+    end
+  }
+  end
+
+    describe("índice de hashes de bloques") {
+    t_log *test_logger;
+
+    before {
+      create_test_directory();
+      test_logger = create_test_logger();
+      g_storage_logger = test_logger;
+      block_index_create(TEST_MOUNT_POINT);
+    }
+    end
+
+        after {
+      destroy_test_logger(test_logger);
+      cleanup_test_directory();
+    }
+    end
+
+    it("persiste los hashes confirmados y descarta los revertidos") {
+      t_block_digest digests[4];
+      for (int i = 0; i < 4; i++) {
+        block_index_digest(&i, sizeof(i), &digests[i]);
+      }
+
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+      for (int i = 0; i < 3; i++) {
+        block_index_insert(&digests[i], 10 + i);
+      }
+      should_int(block_index_commit()) be equal to(0);
+      block_index_insert(&digests[3], 13);
+      block_index_rollback();
+      should_int((int)block_index_lookup(&digests[3])) be equal to(-1);
+      block_index_close();
+
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+      should_int((int)block_index_size()) be equal to(3);
+      should_int((int)block_index_lookup(&digests[0])) be equal to(10);
+      should_int((int)block_index_lookup(&digests[2])) be equal to(12);
+      should_int((int)block_index_lookup(&digests[3])) be equal to(-1);
+    }
+    end
+
+    it("reemplaza el hash de un bloque reescrito y compacta el log") {
+      int blocks = 2000;
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+      for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < blocks; i++) {
+          int content[2] = {round, i};
+          t_block_digest digest;
+          block_index_digest(content, sizeof(content), &digest);
+          block_index_insert(&digest, i);
+        }
+        block_index_commit();
+      }
+      should_int((int)block_index_size()) be equal to(blocks);
+
+      char index_path[PATH_MAX];
+      snprintf(index_path, sizeof(index_path), "%s/%s", TEST_MOUNT_POINT,
+               BLOCK_INDEX_FILE);
+      size_t compacted_size = sizeof(t_block_index_header) +
+                              blocks * sizeof(t_block_index_record);
+      should_int(verify_file_size(index_path, compacted_size)) be equal to(1);
+
+      block_index_close();
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+      int mismatches = 0;
+      for (int i = 0; i < blocks; i++) {
+        int old_content[2] = {1, i};
+        int new_content[2] = {2, i};
+        t_block_digest old_digest, new_digest;
+        block_index_digest(old_content, sizeof(old_content), &old_digest);
+        block_index_digest(new_content, sizeof(new_content), &new_digest);
+        if (block_index_lookup(&old_digest) != -1 ||
+            block_index_lookup(&new_digest) != i) {
+          mismatches++;
+        }
+      }
+      should_int(mismatches) be equal to(0);
+    }
+    end
+
+    it("rehashea el índice al cambiar de algoritmo") {
+      should_int(block_hash_algorithm_from_string("sha256")) be equal to(BLOCK_HASH_SHA256);
+      should_int(block_hash_algorithm_from_string("CRC32")) be equal to(-1);
+
+      char physical_dir[PATH_MAX];
+      snprintf(physical_dir, sizeof(physical_dir), "%s/physical_blocks", TEST_MOUNT_POINT);
+      mkdir(physical_dir, 0755);
+      char block_path[PATH_MAX];
+      snprintf(block_path, sizeof(block_path), "%s/block0002.dat", physical_dir);
+      FILE *block_file = fopen(block_path, "wb");
+      fwrite("Bloque dos", 1, 10, block_file);
+      fclose(block_file);
+
+      t_block_digest md5_digest;
+      block_index_digest("Bloque dos", 10, &md5_digest);
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+      block_index_insert(&md5_digest, 2);
+      block_index_commit();
+
+      should_int(block_index_set_algorithm(BLOCK_HASH_FAST)) be equal to(0);
+      t_block_digest fast_digest;
+      block_index_digest("Bloque dos", 10, &fast_digest);
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+      should_int((int)block_index_lookup(&fast_digest)) be equal to(2);
+      should_int((int)block_index_lookup(&md5_digest)) be equal to(-1);
+
+      char index_path[PATH_MAX];
+      snprintf(index_path, sizeof(index_path), "%s/%s", TEST_MOUNT_POINT,
+               BLOCK_INDEX_FILE);
+      t_block_index_header header;
+      FILE *index_file = fopen(index_path, "rb");
+      fread(&header, sizeof(header), 1, index_file);
+      fclose(index_file);
+      should_int(header.algorithm) be equal to(BLOCK_HASH_FAST);
+
+      block_index_set_algorithm(BLOCK_HASH_MD5);
+    }
+    end
+
+    it("rechaza un algoritmo que no puede resolver") {
+      t_block_digest before_digest;
+      block_index_digest("Bloque dos", 10, &before_digest);
+
+      should_int(block_index_set_algorithm((t_block_hash_algorithm)99)) be equal to(-1);
+
+      t_block_digest after_digest;
+      block_index_digest("Bloque dos", 10, &after_digest);
+      should_int(memcmp(&before_digest, &after_digest, sizeof(t_block_digest))) be equal to(0);
+    }
+    end
+
+    it("migra un blocks_hash_index.config") {
+      char legacy_path[PATH_MAX];
+      snprintf(legacy_path, sizeof(legacy_path), "%s/%s", TEST_MOUNT_POINT,
+               BLOCK_INDEX_LEGACY_FILE);
+      char index_path[PATH_MAX];
+      snprintf(index_path, sizeof(index_path), "%s/%s", TEST_MOUNT_POINT,
+               BLOCK_INDEX_FILE);
+      remove(index_path);
+
+      FILE *legacy_file = fopen(legacy_path, "w");
+      // MD5 de "abc"
+      fprintf(legacy_file, "900150983cd24fb0d6963f7d28e17f72=block0005\n");
+      fclose(legacy_file);
+
+      should_int(block_index_open(TEST_MOUNT_POINT)) be equal to(0);
+
+      t_block_digest digest;
+      block_index_digest("abc", 3, &digest);
+      should_int((int)block_index_lookup(&digest)) be equal to(5);
+      should_bool(file_exists(index_path)) be truthy;
+      should_bool(file_exists(legacy_path)) be falsey;
+    }
+    end
+  }
+  end
+
+    describe("get_free_bit_index function") {
+    t_log *test_logger;
+    const size_t bitmap_size = 64; // Varias palabras de 64 bits
+
+    before {
+      create_test_directory();
+      test_logger = create_test_logger();
+      g_storage_logger = test_logger;
+
+      g_storage_config = malloc(sizeof(t_storage_config));
+      g_storage_config->mount_point = strdup(TEST_MOUNT_POINT);
+      g_storage_config->bitmap_size_bytes = bitmap_size;
+    }
+    end
+
+        after {
+      free(g_storage_config->mount_point);
+      free(g_storage_config);
+      g_storage_config = NULL;
+      destroy_test_logger(test_logger);
+      cleanup_test_directory();
+    }
+    end
+
+    it("encuentra el primer bloque libre después de palabras llenas") {
+      unsigned char bitmap_data[64];
+      memset(bitmap_data, 0xFF, bitmap_size);
+      bitmap_data[21] = 0xF7; // Bloque 21 * 8 + 4 libre
+
+      char bitmap_path[PATH_MAX];
+      snprintf(bitmap_path, sizeof(bitmap_path), "%s/bitmap.bin",
+               TEST_MOUNT_POINT);
+      FILE *bitmap_file = fopen(bitmap_path, "wb");
+      fwrite(bitmap_data, 1, bitmap_size, bitmap_file);
+      fclose(bitmap_file);
+
+      t_bitarray *bitmap = NULL;
+      char *bitmap_buffer = NULL;
+      should_int(bitmap_load(&bitmap, &bitmap_buffer)) be equal to(0);
+      should_int(get_free_bit_index(bitmap)) be equal to(21 * 8 + 4);
+
+      bitarray_set_bit(bitmap, 21 * 8 + 4);
+      should_int(get_free_bit_index(bitmap)) be equal to(-1);
+      bitmap_persist(bitmap, bitmap_buffer);
+    }
+    end
+
+    it("vuelve a ofrecer un bloque liberado antes del último reservado") {
+      unsigned char bitmap_data[64];
+      memset(bitmap_data, 0xFF, bitmap_size);
+      bitmap_data[bitmap_size - 1] = 0x00;
+
+      char bitmap_path[PATH_MAX];
+      snprintf(bitmap_path, sizeof(bitmap_path), "%s/bitmap.bin",
+               TEST_MOUNT_POINT);
+      FILE *bitmap_file = fopen(bitmap_path, "wb");
+      fwrite(bitmap_data, 1, bitmap_size, bitmap_file);
+      fclose(bitmap_file);
+
+      t_bitarray *bitmap = NULL;
+      char *bitmap_buffer = NULL;
+      bitmap_load(&bitmap, &bitmap_buffer);
+      ssize_t last_block = get_free_bit_index(bitmap);
+      should_int(last_block) be equal to((bitmap_size - 1) * 8);
+      bitarray_set_bit(bitmap, last_block);
+
+      free_bitmap_bit(bitmap, 3);
+      should_int(get_free_bit_index(bitmap)) be equal to(3);
+      bitmap_persist(bitmap, bitmap_buffer);
+
+      // Los cambios quedan en bitmap.bin sin reescribirlo
+      bitmap_file = fopen(bitmap_path, "rb");
+      fread(bitmap_data, 1, bitmap_size, bitmap_file);
+      fclose(bitmap_file);
+      should_int(bitmap_data[0]) be equal to(0xEF);
+      should_int(bitmap_data[bitmap_size - 1]) be equal to(0x80);
+    }
+    end
+  }
   end
 
     describe("modify_bitmap_bits function") {
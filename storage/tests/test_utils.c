@@ -11,6 +11,11 @@ int create_test_directory(void) {
 }
 
 int cleanup_test_directory(void) {
+    // El bitmap mapeado, el índice de hashes y la caché de metadata pertenecen al punto de montaje que se borra
+    bitmap_unmap();
+    block_index_close();
+    metadata_cache_clear();
+
     char command[PATH_MAX + 10];
     snprintf(command, sizeof(command), "rm -rf %s", TEST_MOUNT_POINT);
 
@@ -118,18 +123,8 @@ int create_test_superblock(const char* mount_point) {
 }
 
 int create_test_blocks_hash_index(const char* mount_point) {
-    char hash_index_path[PATH_MAX];
-    snprintf(hash_index_path, sizeof(hash_index_path), "%s/blocks_hash_index.config", mount_point);
-
-    FILE* hash_index_file = fopen(hash_index_path, "w");
-    if (hash_index_file == NULL) {
-        return -1;
-    }
-
-    // Archivo vacío para iniciar
-    fclose(hash_index_file);
-
-    return 0;
+    // Índice vacío para iniciar
+    return block_index_create(mount_point);
 }
 
 int create_test_storage_config(
@@ -207,16 +202,15 @@ int create_test_metadata(const char *name, const char *tag, int numb_blocks, cha
         goto cleanup_array;
     }
 
-    char metadata_path[PATH_MAX];
-    snprintf(metadata_path, sizeof(metadata_path), "%s/files/%s/%s/metadata.config", mount_point, name, tag);
-    FILE* metadata_file = fopen(metadata_path, "w");
-    if (metadata_file == NULL) {
-        retval = -3;
-        goto cleanup_array;
+    int *blocks = malloc(sizeof(int) * (numb_blocks > 0 ? numb_blocks : 1));
+    for (int i = 0; i < numb_blocks; i++) {
+        blocks[i] = atoi(blocks_array[i]);
     }
 
-    fprintf(metadata_file, "SIZE=%d\nBLOCKS=%s\nESTADO=%s\n", size, blocks_array_str, status);
-    fclose(metadata_file);
+    if (create_metadata_file(mount_point, name, tag, size, blocks, numb_blocks, status) != 0) {
+        retval = -3;
+    }
+    free(blocks);
 
 cleanup_array:
     string_array_destroy(blocks_array);
@@ -224,6 +218,11 @@ end:
     return retval;
 }
 
+t_file_metadata *read_persisted_metadata(const char *name, const char *tag) {
+    metadata_cache_clear();
+    return read_file_metadata(TEST_MOUNT_POINT, name, tag);
+}
+
 bool correct_unlock(const char *name, const char *tag) {
     char *key = string_from_format("%s:%s", name, tag);
 
@@ -295,9 +294,19 @@ void link_logical_to_physical(const char *name, const char *tag, int logical_id,
     }
 }
 
-char* get_hash_index_config_path(char *buffer) {
-    snprintf(buffer, PATH_MAX, "%s/blocks_hash_index.config", TEST_MOUNT_POINT);
-    return buffer;
+int64_t lookup_persisted_hash(const char *content, size_t content_size) {
+    char *block = calloc(1, g_storage_config->block_size);
+    memcpy(block, content, content_size);
+
+    t_block_digest digest;
+    block_index_digest(block, g_storage_config->block_size, &digest);
+    free(block);
+
+    block_index_close();
+    if (block_index_open(TEST_MOUNT_POINT) != 0) {
+        return -1;
+    }
+    return block_index_lookup(&digest);
 }
 
 void bitmap_close(t_bitarray *bitmap, char *buffer) {
@@ -10,6 +10,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <utils/filesystem_utils.h>
+#include <utils/block_index.h>
 #include <globals/globals.h>
 #include "file_locks.h"
 
@@ -163,10 +164,19 @@ int init_logical_blocks(const char *name, const char *tag, int numb_blocks, cons
  * @return int 0 si el archivo de metadatos se creó exitosamente.
  * @return int -1 si el número de bloques solicitado excede el tamaño del FS de prueba (TEST_FS_SIZE).
  * @return int -2 si el número de bloques solicitado no coincide con la longitud del array de bloques proporcionado.
- * @return int -3 si falla la apertura o escritura del archivo de metadatos.
+ * @return int -3 si falla la escritura del archivo de metadatos.
  */
 int create_test_metadata(const char *name, const char *tag, int numb_blocks, char *blocks_array_str, char *status, char *mount_point);
 
+/**
+ * Lee el metadata.bin de un archivo de prueba desde disco, salteando la caché.
+ *
+ * @param name Nombre del archivo.
+ * @param tag Etiqueta asociada al archivo.
+ * @return t_file_metadata* La metadata persistida, o NULL si no existe. Destruir con destroy_file_metadata().
+ */
+t_file_metadata *read_persisted_metadata(const char *name, const char *tag);
+
 /**
  * Verifica si un archivo ha sido desbloqueado correctamente en el diccionario de archivos abiertos.
  * 
@@ -217,12 +227,14 @@ void write_physical_block_content(int physical_id, const char *content, size_t c
 void link_logical_to_physical(const char *name, const char *tag, int logical_id, int physical_id);
 
 /**
- * Construye la ruta del archivo de configuración de índices hash.
+ * Vuelve a cargar el índice de hashes desde disco y busca el hash de un
+ * contenido, rellenado con ceros hasta block_size como en el commit.
  *
- * @param buffer Buffer donde se almacenará la ruta final. Debe tener tamaño ≥ PATH_MAX.
- * @return char* El mismo buffer recibido como parámetro.
+ * @param content Contenido del bloque.
+ * @param content_size Cantidad de bytes de content.
+ * @return int64_t Bloque físico registrado para el hash, o -1 si no está.
  */
-char* get_hash_index_config_path(char *buffer);
+int64_t lookup_persisted_hash(const char *content, size_t content_size);
 
 /**
  * Crea el archivo inicial de índice de hashes de bloques para pruebas.
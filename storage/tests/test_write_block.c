@@ -255,6 +255,51 @@ context(tests_write_block) {
             should_int(lock_res) be equal to (0);
             should_bool(correct_unlock("file1", "tag1")) be truthy;
         } end
+
+        it ("Escritura de varios bloques en un solo pedido") {
+            init_logical_blocks("file1", "tag1", 3, TEST_MOUNT_POINT);
+            create_test_metadata("file1", "tag1", 3, "[1,2,3]", "WORK_IN_PROGRESS", TEST_MOUNT_POINT);
+            init_bitmap(TEST_MOUNT_POINT, TEST_FS_SIZE, TEST_BLOCK_SIZE);
+
+            t_block_write writes[] = {
+                { .block_number = 0, .data = "PRIMERO", .size = 7 },
+                { .block_number = 2, .data = "TERCERO", .size = 7 },
+            };
+
+            int retval = execute_blocks_write("file1", "tag1", 12, writes, 2);
+
+            should_int(retval) be equal to (0);
+            should_int(mutex_is_free(&g_storage_bitmap_mutex)) be equal to (0);
+            should_bool(correct_unlock("file1", "tag1")) be truthy;
+
+            char logical_block_path[PATH_MAX];
+            char content[8] = {0};
+            snprintf(logical_block_path, sizeof(logical_block_path),
+                     "%s/files/file1/tag1/logical_blocks/%04d.dat", TEST_MOUNT_POINT, 2);
+            FILE *block = fopen(logical_block_path, "rb");
+            should_ptr(block) not be null;
+            if (block) {
+                fread(content, 1, 7, block);
+                fclose(block);
+            }
+            should_string(content) be equal to ("TERCERO");
+        } end
+
+        it ("Un bloque fuera de rango hace fallar todo el pedido sin escribir") {
+            init_logical_blocks("file1", "tag1", 3, TEST_MOUNT_POINT);
+            create_test_metadata("file1", "tag1", 3, "[1,2,3]", "WORK_IN_PROGRESS", TEST_MOUNT_POINT);
+            init_bitmap(TEST_MOUNT_POINT, TEST_FS_SIZE, TEST_BLOCK_SIZE);
+
+            t_block_write writes[] = {
+                { .block_number = 0, .data = "PRIMERO", .size = 7 },
+                { .block_number = 9, .data = "INVALIDO", .size = 8 },
+            };
+
+            int retval = execute_blocks_write("file1", "tag1", 12, writes, 2);
+
+            should_int(retval) be equal to (READ_OUT_OF_BOUNDS);
+            should_bool(correct_unlock("file1", "tag1")) be truthy;
+        } end
     } end
 
     describe ("Lógica que maneja la solicitud de escritura en bloque") {
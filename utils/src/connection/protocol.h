@@ -49,6 +49,14 @@ typedef enum {
   STORAGE_OP_WORKER_SEND_ID_RES,
   STORAGE_OP_ACK,
   STORAGE_OP_ERROR,
+  // Lectura y escritura de varios bloques de un File:Tag en un solo pedido
+  STORAGE_OP_BLOCK_READV_REQ,
+  STORAGE_OP_BLOCK_READV_RES,
+  STORAGE_OP_BLOCK_WRITEV_REQ,
+  STORAGE_OP_BLOCK_WRITEV_RES,
 } t_storage_op_code;
 
+// Máximo de bloques por pedido READV/WRITEV
+#define STORAGE_MAX_VECTOR_BLOCKS 256
+
 #endif
@@ -3,6 +3,86 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// Cabecera de cada paquete en el socket: [op_code][tamaño del payload]
+typedef struct __attribute__((packed))
+{
+    uint8_t operation_code;
+    uint32_t buffer_size; // En network byte order
+} t_package_header;
+
+// Buffers libres por clase de tamaño, compartidos por todos los hilos del proceso
+static t_buffer *buffer_pool[BUFFER_POOL_CLASSES][BUFFER_POOL_SLOTS];
+static int buffer_pool_count[BUFFER_POOL_CLASSES];
+static pthread_mutex_t buffer_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Devuelve la clase más chica del pool en la que entra size, o -1 si no entra en ninguna
+static int8_t buffer_pool_class_for(size_t size)
+{
+    size_t class_size = BUFFER_POOL_MIN_SIZE;
+    for (int8_t i = 0; i < BUFFER_POOL_CLASSES; i++)
+    {
+        if (size <= class_size)
+        {
+            return i;
+        }
+        class_size *= 2;
+    }
+    return -1;
+}
+
+static t_buffer *buffer_pool_acquire(int8_t pool_class)
+{
+    t_buffer *buffer = NULL;
+
+    pthread_mutex_lock(&buffer_pool_mutex);
+    if (buffer_pool_count[pool_class] > 0)
+    {
+        buffer = buffer_pool[pool_class][--buffer_pool_count[pool_class]];
+    }
+    pthread_mutex_unlock(&buffer_pool_mutex);
+
+    if (buffer)
+    {
+        return buffer;
+    }
+
+    buffer = malloc(sizeof(t_buffer));
+    if (!buffer)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    buffer->stream = malloc((size_t)BUFFER_POOL_MIN_SIZE << pool_class);
+    if (!buffer->stream)
+    {
+        free(buffer);
+        errno = ENOMEM;
+        return NULL;
+    }
+    buffer->pool_class = pool_class;
+
+    return buffer;
+}
+
+static void buffer_pool_release(t_buffer *buffer)
+{
+    pthread_mutex_lock(&buffer_pool_mutex);
+    if (buffer_pool_count[buffer->pool_class] < BUFFER_POOL_SLOTS)
+    {
+        buffer_pool[buffer->pool_class][buffer_pool_count[buffer->pool_class]++] = buffer;
+        pthread_mutex_unlock(&buffer_pool_mutex);
+        return;
+    }
+    pthread_mutex_unlock(&buffer_pool_mutex);
+
+    free(buffer->stream);
+    free(buffer);
+}
 
 t_buffer *buffer_create(size_t size){
     if (size == 0) 
@@ -26,7 +106,9 @@ t_buffer *buffer_create(size_t size){
         free(new_buffer);
         return NULL;
     }
+    new_buffer->length = size;
     new_buffer->is_dynamic = false;
+    new_buffer->pool_class = -1;
     memset(new_buffer->stream, 0, size);
     if (!new_buffer->stream)
     {
@@ -41,28 +123,40 @@ t_buffer *buffer_create(size_t size){
 // Crea un buffer dinámico con tamaño inicial pequeño
 t_buffer *buffer_create_dynamic(void)
 {
-    const size_t initial_size = 256;
-    
-    t_buffer *new_buffer = malloc(sizeof(t_buffer));
+    t_buffer *new_buffer = buffer_pool_acquire(0);
     if (!new_buffer) 
     {
-        errno = ENOMEM;
         return NULL;
     }
+    
+    // No se inicializa: sólo se envían los bytes efectivamente escritos
+    new_buffer->size = BUFFER_POOL_MIN_SIZE;
+    new_buffer->offset = 0;
+    new_buffer->length = 0;
+    new_buffer->is_dynamic = true;
+
+    return new_buffer;
+}
 
-    new_buffer->stream = malloc(initial_size);
-    if (!new_buffer->stream) 
+// Crea un buffer de tamaño fijo reutilizando memoria del pool cuando es posible
+t_buffer *buffer_create_pooled(size_t size)
+{
+    int8_t pool_class = buffer_pool_class_for(size);
+    if (pool_class < 0)
+    {
+        return buffer_create(size);
+    }
+
+    t_buffer *new_buffer = buffer_pool_acquire(pool_class);
+    if (!new_buffer)
     {
-        free(new_buffer);
-        errno = ENOMEM;
         return NULL;
     }
-    
-    new_buffer->size = initial_size;
+
+    new_buffer->size = size;
     new_buffer->offset = 0;
-    new_buffer->is_dynamic = true;
-    
-    memset(new_buffer->stream, 0, initial_size);
+    new_buffer->length = size;
+    new_buffer->is_dynamic = false;
 
     return new_buffer;
 }
@@ -91,11 +185,10 @@ bool buffer_expand(t_buffer *buffer, size_t required_size)
         return false;
     }
 
-    // Inicializar nueva área con zeros
-    memset((uint8_t*)new_stream + buffer->size, 0, new_size - buffer->size);
-    
     buffer->stream = new_stream;
     buffer->size = new_size;
+    // Al duplicar desde una clase del pool el nuevo tamaño coincide con otra clase
+    buffer->pool_class = buffer_pool_class_for(new_size);
     
     return true;
 }
@@ -106,6 +199,11 @@ void buffer_destroy(t_buffer *buffer)
     {
         return;
     }
+    if (buffer->pool_class >= 0 && buffer->stream)
+    {
+        buffer_pool_release(buffer);
+        return;
+    }
     if (buffer->stream)
     {
         free(buffer->stream);
@@ -138,6 +236,16 @@ static bool buffer_has_capacity(t_buffer *buffer, size_t required_size)
     return (buffer->size - buffer->offset) >= required_size;
 }
 
+// Avanza el offset de escritura y registra hasta dónde llega el payload lógico
+static void buffer_advance_write(t_buffer *buffer, size_t written)
+{
+    buffer->offset += written;
+    if (buffer->offset > buffer->length)
+    {
+        buffer->length = buffer->offset;
+    }
+}
+
 // Función para verificar capacidad (sólo funciones de lectura)
 static bool buffer_check_capacity(t_buffer *buffer, size_t required_size)
 {
@@ -156,7 +264,7 @@ bool buffer_write_uint8(t_buffer *buffer, uint8_t value)
     uint8_t *next_position = (uint8_t *)buffer->stream + buffer->offset;
 
     memcpy(next_position, &value, sizeof(uint8_t));
-    buffer->offset += sizeof(uint8_t);
+    buffer_advance_write(buffer, sizeof(uint8_t));
 
     return true;
 }
@@ -170,7 +278,7 @@ bool buffer_write_int8(t_buffer *buffer, int8_t value)
     uint8_t *next_position = (uint8_t *)buffer->stream + buffer->offset;
 
     memcpy(next_position, &value, sizeof(int8_t));
-    buffer->offset += sizeof(int8_t);
+    buffer_advance_write(buffer, sizeof(int8_t));
 
     return true;
 }
@@ -187,7 +295,7 @@ bool buffer_write_uint16(t_buffer *buffer, uint16_t value)
     uint8_t *next_position = (uint8_t *)buffer->stream + buffer->offset;
 
     memcpy(next_position, &net_value, sizeof(uint16_t));
-    buffer->offset += sizeof(uint16_t);
+    buffer_advance_write(buffer, sizeof(uint16_t));
 
     return true;
 }
@@ -203,7 +311,7 @@ bool buffer_write_uint32(t_buffer *buffer, uint32_t value)
     uint32_t net_value = htonl(value);
     uint8_t *next_position = (uint8_t *)buffer->stream + buffer->offset;
     memcpy(next_position, &net_value, sizeof(uint32_t));
-    buffer->offset += sizeof(uint32_t);
+    buffer_advance_write(buffer, sizeof(uint32_t));
     
     return true;
 }
@@ -229,7 +337,7 @@ bool buffer_write_string(t_buffer *buffer, const char *value)
     // Escribir string (sin null terminator en el stream)
     uint8_t *next_position = (uint8_t *)buffer->stream + buffer->offset;
     memcpy(next_position, value, str_length);
-    buffer->offset += str_length;
+    buffer_advance_write(buffer, str_length);
     
     return true;
 }
@@ -258,7 +366,7 @@ bool buffer_write_data(t_buffer *buffer, const void *data, size_t data_size)
     // Escribir datos
     uint8_t *next_position = (uint8_t *)buffer->stream + buffer->offset;
     memcpy(next_position, data, data_size);
-    buffer->offset += data_size;
+    buffer_advance_write(buffer, data_size);
     
     return true;
 }
@@ -551,45 +659,66 @@ void package_destroy(t_package *package)
     free(package);
 }
 
-int package_send(t_package *package, int socket)
+// Envía todos los iovec, reintentando si el kernel acepta sólo una parte
+static int send_all_iov(int socket, struct iovec *iov, int iovcnt)
 {
-    if (!package || !package->buffer || socket < 0) 
+    while (iovcnt > 0)
     {
-        return -1;
+        struct msghdr message = {0};
+        message.msg_iov = iov;
+        message.msg_iovlen = iovcnt;
+
+        ssize_t sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+
+        // Descartar los segmentos enviados completos y avanzar dentro del parcial
+        while (iovcnt > 0 && (size_t)sent >= iov->iov_len)
+        {
+            sent -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (uint8_t *)iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
     }
 
-    // Calcular tamaño total del paquete serializado
-    uint32_t buffer_size = (uint32_t)package->buffer->size;
-    uint32_t total_size = sizeof(uint8_t) + sizeof(uint32_t) + buffer_size;
-    
-    void *serialized_package = malloc(total_size);
-    if (!serialized_package) {
+    return 0;
+}
+
+int package_send(t_package *package, int socket)
+{
+    if (!package || !package->buffer || socket < 0) 
+    {
         return -1;
     }
 
-    size_t offset = 0;
+    // Los buffers dinámicos viajan con su largo lógico, no con la capacidad reservada
+    uint32_t buffer_size = package->buffer->is_dynamic
+                               ? (uint32_t)package->buffer->length
+                               : (uint32_t)package->buffer->size;
 
-    // Serializar op_code
-    memcpy(serialized_package + offset, &package->operation_code, sizeof(uint8_t));
-    offset += sizeof(uint8_t);
+    t_package_header header = {
+        .operation_code = package->operation_code,
+        .buffer_size = htonl(buffer_size),
+    };
 
-    // Serializar tamaño de bloque
-    uint32_t net_buffer_size = htonl(buffer_size);
-    memcpy(serialized_package + offset, &net_buffer_size, sizeof(uint32_t));
-    offset += sizeof(uint32_t);
-    
-    // Serializar buffer
-    memcpy(serialized_package + offset, package->buffer->stream, buffer_size);
+    // Cabecera y payload se envían desde su memoria original, sin copiarlos
+    struct iovec iov[2] = {
+        {.iov_base = &header, .iov_len = sizeof(header)},
+        {.iov_base = package->buffer->stream, .iov_len = buffer_size},
+    };
 
-    // Enviar todo de una vez
-    ssize_t bytes_sent = send(socket, serialized_package, total_size, MSG_NOSIGNAL);
-    free(serialized_package);
-    
-    if (bytes_sent != (ssize_t)total_size) {
-        return -1;
-    }
-    
-    return 0;
+    return send_all_iov(socket, iov, buffer_size > 0 ? 2 : 1);
 }
 
 // Funcion auxiliar para recibir datos
@@ -619,34 +748,27 @@ t_package *package_receive(int socket)
         return NULL;
     }
 
-    t_package *package = malloc(sizeof(t_package));
-    if (!package) {
-        return NULL;
-    }
-
-    // Recibir operation_code
-    if (recv_all(socket, &package->operation_code, sizeof(uint8_t)) != sizeof(uint8_t)) {
-        free(package);
-        return NULL;
-    }
-
-    // Recibir tamaño del buffer
-    uint32_t net_buffer_size;
-    if (recv_all(socket, &net_buffer_size, sizeof(uint32_t)) != sizeof(uint32_t)) {
-        free(package);
+    // Recibir operation_code y tamaño del buffer juntos
+    t_package_header header;
+    if (recv_all(socket, &header, sizeof(header)) != sizeof(header)) {
         return NULL;
     }
     
-    uint32_t buffer_size = ntohl(net_buffer_size);
+    uint32_t buffer_size = ntohl(header.buffer_size);
     
     // Validar tamaño razonable
     if (buffer_size > MAX_BUFFER_SIZE) {
-        free(package);
         return NULL;
     }
 
-    // Crear buffer
-    package->buffer = buffer_create(buffer_size);
+    t_package *package = malloc(sizeof(t_package));
+    if (!package) {
+        return NULL;
+    }
+    package->operation_code = header.operation_code;
+
+    // El payload se sobreescribe completo, no hace falta inicializarlo
+    package->buffer = buffer_create_pooled(buffer_size);
     if (!package->buffer) {
         free(package);
         return NULL;
@@ -14,7 +14,9 @@ typedef struct
     size_t size;   // Tamaño del buffer
     void *stream;  // Contenido del buffer
     size_t offset; // Desplazamiento dentro del buffer
+    size_t length; // Bytes escritos (payload lógico que se envía)
     bool is_dynamic; // Indica si el buffer es dinámico o no
+    int8_t pool_class; // Clase del pool de la que proviene el buffer, -1 si no se reutiliza
 } t_buffer;
 
 typedef struct
@@ -28,11 +30,17 @@ typedef struct
 #define MAX_DATA_SIZE (10 * 1024 * 1024)   // 10MB máximo para datos binarios
 #define MAX_BUFFER_SIZE (100 * 1024 * 1024) // 100MB máximo para buffer total
 
+// Pool de buffers reutilizables: clases de 256B a 128KB, en potencias de 2
+#define BUFFER_POOL_MIN_SIZE 256
+#define BUFFER_POOL_CLASSES 10
+#define BUFFER_POOL_SLOTS 16 // Buffers libres que se conservan por clase
+
 
 
 // Gestión del buffer
 t_buffer *buffer_create(size_t size);
 t_buffer *buffer_create_dynamic(void); // Buffer que crece automáticamente
+t_buffer *buffer_create_pooled(size_t size); // Buffer de tamaño fijo tomado del pool
 void buffer_destroy(t_buffer *buffer);
 void buffer_reset_offset(t_buffer *buffer);
 
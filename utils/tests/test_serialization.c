@@ -0,0 +1,126 @@
+#include <cspecs/cspec.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../src/connection/serialization.h"
+
+context(test_serialization) {
+    describe("package_send y package_receive") {
+        int sockets[2];
+
+        before {
+            socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+        } end
+
+        after {
+            close(sockets[0]);
+            close(sockets[1]);
+        } end
+
+        it("envía y recibe un paquete con todos sus campos") {
+            t_package *package = package_create_empty(42);
+            package_add_uint32(package, 1234);
+            package_add_string(package, "archivo");
+            package_add_data(package, "bloque", 6);
+
+            should_int(package_send(package, sockets[0])) be equal to(0);
+            package_destroy(package);
+
+            t_package *received = package_receive(sockets[1]);
+            should_ptr(received) not be null;
+            should_int(received->operation_code) be equal to(42);
+
+            uint32_t value;
+            should_bool(package_read_uint32(received, &value)) be truthy;
+            should_int(value) be equal to(1234);
+
+            char *name = package_read_string(received);
+            should_string(name) be equal to("archivo");
+            free(name);
+
+            size_t data_size;
+            char *data = package_read_data(received, &data_size);
+            should_int(data_size) be equal to(6);
+            should_bool(memcmp(data, "bloque", 6) == 0) be truthy;
+            free(data);
+
+            package_destroy(received);
+        } end
+
+        it("envía payloads que superan el tamaño inicial del buffer dinámico") {
+            size_t size = 3000;
+            char *content = malloc(size);
+            memset(content, 'x', size);
+
+            t_package *package = package_create_empty(7);
+            package_add_data(package, content, size);
+            should_int(package_send(package, sockets[0])) be equal to(0);
+            package_destroy(package);
+
+            t_package *received = package_receive(sockets[1]);
+            should_ptr(received) not be null;
+
+            size_t data_size;
+            char *data = package_read_data(received, &data_size);
+            should_int(data_size) be equal to((int)size);
+            should_bool(memcmp(data, content, size) == 0) be truthy;
+
+            free(data);
+            free(content);
+            package_destroy(received);
+        } end
+
+        it("envía sólo los bytes escritos y no la capacidad del buffer") {
+            t_package *package = package_create_empty(3);
+            package_add_uint32(package, 99);
+            package_send(package, sockets[0]);
+            package_destroy(package);
+
+            uint8_t raw[512];
+            ssize_t received = recv(sockets[1], raw, sizeof(raw), MSG_DONTWAIT);
+            should_int(received) be equal to(9);
+        } end
+
+        it("envía y recibe paquetes sin payload") {
+            t_package *package = package_create_empty(5);
+            should_int(package_send(package, sockets[0])) be equal to(0);
+            package_destroy(package);
+
+            t_package *received = package_receive(sockets[1]);
+            should_ptr(received) not be null;
+            should_int(received->operation_code) be equal to(5);
+            should_int(package_get_data_size(received)) be equal to(0);
+            package_destroy(received);
+        } end
+
+        it("devuelve NULL si el otro extremo cerró la conexión") {
+            close(sockets[0]);
+            sockets[0] = socket(AF_UNIX, SOCK_STREAM, 0);
+
+            should_ptr(package_receive(sockets[1])) be null;
+        } end
+    } end
+
+    describe("Pool de buffers") {
+        it("reutiliza el buffer liberado de la misma clase") {
+            t_buffer *first = buffer_create_pooled(100);
+            void *stream = first->stream;
+            buffer_destroy(first);
+
+            t_buffer *second = buffer_create_pooled(200);
+            should_ptr(second->stream) be equal to(stream);
+            should_int(second->size) be equal to(200);
+            should_int(second->offset) be equal to(0);
+            buffer_destroy(second);
+        } end
+
+        it("crea buffers de tamaño cero para paquetes sin payload") {
+            t_buffer *buffer = buffer_create_pooled(0);
+            should_ptr(buffer) not be null;
+            should_int(buffer->size) be equal to(0);
+            buffer_destroy(buffer);
+        } end
+    } end
+}
@@ -0,0 +1,149 @@
+/*
+ * Microbenchmark de los recorridos de la tabla de páginas: compara el formato
+ * anterior (arreglo denso de entradas de 32 bytes) con las hojas de entradas
+ * empaquetadas en 32 bits.
+ *
+ * Uso: make bench && ./bin/worker_bench [páginas] [repeticiones]
+ */
+#include <memory/page_table.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Formato anterior de pt_entry_t, tal como estaba antes de empaquetarlo
+typedef struct {
+    uint32_t page_number;
+    uint32_t frame;
+    bool dirty;
+    bool present;
+    uint64_t last_access_time;
+    bool use_bit;
+} legacy_entry_t;
+
+// Lo que devuelven los recorridos; se acumula para que el compilador no los descarte
+static volatile uint64_t sink;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, uint64_t pages, double before, double after)
+{
+    printf("%-34s antes: %8.1f Mpág/s   después: %8.1f Mpág/s   (x%.1f)\n",
+           name, pages / before / 1e6, pages / after / 1e6, before / after);
+}
+
+// Recorrido de CLOCK-M sobre todas las páginas: mira U y M de cada entrada
+static uint64_t legacy_scan(legacy_entry_t *entries, uint32_t page_count)
+{
+    uint64_t candidates = 0;
+    for (uint32_t i = 0; i < page_count; i++)
+    {
+        if (entries[i].present && !entries[i].use_bit && !entries[i].dirty)
+            candidates++;
+    }
+    return candidates;
+}
+
+static uint64_t packed_scan(page_table_t *pt)
+{
+    uint64_t candidates = 0;
+    for (uint32_t index = 0; index < pt->leaf_count; index++)
+    {
+        pt_leaf_t *leaf = pt->leaves[index];
+        if (!leaf)
+            continue;
+        for (uint32_t slot = 0; slot < PT_LEAF_SIZE; slot++)
+        {
+            pt_entry_t entry = leaf->entries[slot];
+            if (entry.present && !entry.use_bit && !entry.dirty)
+                candidates++;
+        }
+    }
+    return candidates;
+}
+
+// pt_get_dirty_entries anterior: dos pasadas sobre todas las entradas
+static uint64_t legacy_collect_dirty(legacy_entry_t *entries, uint32_t page_count)
+{
+    size_t dirty_count = 0;
+    for (uint32_t i = 0; i < page_count; i++)
+        if (entries[i].dirty)
+            dirty_count++;
+
+    legacy_entry_t *dirty = malloc(dirty_count * sizeof(legacy_entry_t) + 1);
+    size_t idx = 0;
+    for (uint32_t i = 0; i < page_count; i++)
+        if (entries[i].dirty)
+            dirty[idx++] = entries[i];
+
+    uint64_t result = idx;
+    free(dirty);
+    return result;
+}
+
+static uint64_t packed_collect_dirty(page_table_t *pt)
+{
+    size_t count = 0;
+    pt_dirty_page_t *dirty = pt_get_dirty_entries(pt, &count);
+    free(dirty);
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t page_count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : (1u << 20);
+    int rounds = argc > 2 ? atoi(argv[2]) : 50;
+
+    legacy_entry_t *legacy = calloc(page_count, sizeof(legacy_entry_t));
+    page_table_t *pt = pt_create(page_count, 4096);
+    if (!legacy || !pt)
+    {
+        fprintf(stderr, "No hay memoria para %u páginas\n", page_count);
+        return 1;
+    }
+
+    // Todas las páginas presentes, la mitad con U=1 y una de cada cien sucia
+    for (uint32_t i = 0; i < page_count; i++)
+    {
+        legacy[i] = (legacy_entry_t){ .page_number = i, .frame = i % PT_MAX_FRAMES, .present = true };
+        legacy[i].use_bit = (i % 2) == 0;
+        legacy[i].dirty = (i % 100) == 0;
+
+        pt_map(pt, i, i % PT_MAX_FRAMES);
+        pt_find_entry(pt, i)->use_bit = legacy[i].use_bit;
+        pt_set_dirty(pt, i, legacy[i].dirty);
+    }
+
+    printf("Tabla de %u páginas, %d repeticiones (entrada: %zu bytes antes, %zu después)\n",
+           page_count, rounds, sizeof(legacy_entry_t), sizeof(pt_entry_t));
+
+    uint64_t pages = (uint64_t)page_count * rounds;
+    double start = now_seconds();
+    for (int r = 0; r < rounds; r++)
+        sink += legacy_scan(legacy, page_count);
+    double legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    for (int r = 0; r < rounds; r++)
+        sink += packed_scan(pt);
+    report("Recorrido completo (CLOCK-M)", pages, legacy_time, now_seconds() - start);
+
+    start = now_seconds();
+    for (int r = 0; r < rounds; r++)
+        sink += legacy_collect_dirty(legacy, page_count);
+    legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    for (int r = 0; r < rounds; r++)
+        sink += packed_collect_dirty(pt);
+    report("Páginas sucias (1%)", pages, legacy_time, now_seconds() - start);
+
+    free(legacy);
+    pt_destroy(pt);
+    return 0;
+}
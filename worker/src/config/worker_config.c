@@ -1,6 +1,9 @@
 #include "worker_config.h"
 
 #define ARRAY_LENGTH(a) (sizeof(a) / sizeof((a)[0]))
+#define SCRIPT_CACHE_DEFAULT_SIZE (256 * 1024)
+#define FLUSH_DEFAULT_LOW_WATERMARK 25
+#define FLUSH_DEFAULT_INTERVAL 100
 
 typedef struct
 {
@@ -85,6 +88,59 @@ t_worker_config *create_worker_config(char *config_file_path)
         *int_fields[i].field = original_value;
     }
 
+    // Clave opcional: presupuesto en bytes de la caché de scripts compilados
+    worker_config->script_cache_size = SCRIPT_CACHE_DEFAULT_SIZE;
+    if (config_has_property(config, "TAM_CACHE_SCRIPTS"))
+    {
+        worker_config->script_cache_size = config_get_int_value(config, "TAM_CACHE_SCRIPTS");
+        if (worker_config->script_cache_size < 0)
+        {
+            fprintf(stderr, "Valor invalido para TAM_CACHE_SCRIPTS: %d\n", worker_config->script_cache_size);
+            goto error;
+        }
+    }
+
+    // Clave opcional: páginas extra que se piden al Storage en accesos secuenciales
+    worker_config->read_ahead_pages = 0;
+    if (config_has_property(config, "READ_AHEAD_PAGES"))
+    {
+        worker_config->read_ahead_pages = config_get_int_value(config, "READ_AHEAD_PAGES");
+        if (worker_config->read_ahead_pages < 0)
+        {
+            fprintf(stderr, "Valor invalido para READ_AHEAD_PAGES: %d\n", worker_config->read_ahead_pages);
+            goto error;
+        }
+    }
+
+    // Claves opcionales: escritura en segundo plano de páginas sucias.
+    // Las marcas son porcentajes de marcos sucios; sin FLUSH_MARCA_ALTA queda desactivada
+    t_int_valid_field flush_fields[] = {
+        {"FLUSH_MARCA_ALTA", &worker_config->flush_high_watermark},
+        {"FLUSH_MARCA_BAJA", &worker_config->flush_low_watermark},
+        {"FLUSH_INTERVALO", &worker_config->flush_interval},
+    };
+    worker_config->flush_high_watermark = 0;
+    worker_config->flush_low_watermark = FLUSH_DEFAULT_LOW_WATERMARK;
+    worker_config->flush_interval = FLUSH_DEFAULT_INTERVAL;
+
+    for (size_t i = 0; i < ARRAY_LENGTH(flush_fields); i++)
+    {
+        if (config_has_property(config, flush_fields[i].key))
+            *flush_fields[i].field = config_get_int_value(config, flush_fields[i].key);
+    }
+
+    if (worker_config->flush_high_watermark != 0 &&
+        (worker_config->flush_high_watermark < 0 || worker_config->flush_high_watermark > 100 ||
+         worker_config->flush_low_watermark < 0 ||
+         worker_config->flush_low_watermark >= worker_config->flush_high_watermark ||
+         worker_config->flush_interval <= 0))
+    {
+        fprintf(stderr, "Valores invalidos para FLUSH_MARCA_ALTA/FLUSH_MARCA_BAJA/FLUSH_INTERVALO: %d/%d/%d\n",
+                worker_config->flush_high_watermark, worker_config->flush_low_watermark,
+                worker_config->flush_interval);
+        goto error;
+    }
+
     config_destroy(config);
     return worker_config;
 
@@ -20,6 +20,11 @@ typedef struct
     char *path_scripts;
     int block_size;
     char *log_level;
+    int script_cache_size;
+    int read_ahead_pages;
+    int flush_high_watermark; // 0: sin escritura en segundo plano
+    int flush_low_watermark;
+    int flush_interval;
 } t_worker_config;
 
 
@@ -1,4 +1,6 @@
 #include "master.h"
+#include <stdio.h>
+#include <limits.h>
 
 static int send_request_and_wait_ack(int master_socket,
                                    t_package *request,
@@ -53,7 +55,27 @@ int handshake_with_master(const char *master_ip,
                                  worker_id);
 }
 
-int end_query_in_master(int socket_master, int worker_id, int query_id)
+bool package_add_resident_summary(t_package *package, memory_manager_t *mm)
+{
+    file_tag_entry_t *resident[MM_SUMMARY_MAX_FILE_TAGS];
+    bool ok = true;
+
+    // Las entradas apuntan a mm->entries: se arma el resumen con la memoria tomada
+    mm_lock(mm);
+    uint32_t count = mm_resident_file_tags(mm, resident, MM_SUMMARY_MAX_FILE_TAGS);
+    ok = package_add_uint32(package, count);
+
+    for (uint32_t i = 0; ok && i < count; i++)
+    {
+        char file_tag[PATH_MAX];
+        snprintf(file_tag, sizeof(file_tag), "%s:%s", resident[i]->file, resident[i]->tag);
+        ok = package_add_string(package, file_tag);
+    }
+    mm_unlock(mm);
+    return ok;
+}
+
+int end_query_in_master(int socket_master, int worker_id, int query_id, memory_manager_t *mm)
 {
     t_log *logger = logger_get();
     if (socket_master < 0)
@@ -66,7 +88,8 @@ int end_query_in_master(int socket_master, int worker_id, int query_id)
     
     if (request &&
         package_add_uint32(request, worker_id) &&
-        package_add_uint32(request, query_id))
+        package_add_uint32(request, query_id) &&
+        package_add_resident_summary(request, mm))
     {
 /*         int result = send_request_and_wait_ack(socket_master, request, 
                                             OP_WORKER_ACK, 
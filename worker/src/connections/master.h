@@ -6,6 +6,7 @@
 #include <utils/client_socket.h>
 #include <connection/protocol.h>
 #include "common.h"
+#include <memory/memory_manager.h>
 
 /**
  * Establece una conexión y realiza el handshake con el Master.
@@ -16,6 +17,13 @@
  */
 int handshake_with_master(const char *master_ip, const char *master_port, int worker_id);
 int send_read_content_to_master(int socket_master, int query_id, void *data, size_t data_size, char* file, char* tag, int worker_id);
-int end_query_in_master(int socket_master, int query_id, int worker_id);
+int end_query_in_master(int socket_master, int worker_id, int query_id, memory_manager_t *mm);
+
+/**
+ * Agrega al paquete el resumen de la caché del Worker: cantidad (uint32) y los
+ * "FILE:TAG" con más páginas presentes. Viaja al final de END_QUERY y EVICT_RES
+ * para que el Master prefiera este Worker para queries sobre esos archivos.
+ */
+bool package_add_resident_summary(t_package *package, memory_manager_t *mm);
 
 #endif
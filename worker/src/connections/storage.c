@@ -152,6 +152,14 @@ int get_block_size(int storage_socket, uint16_t *block_size, int worker_id)
 }
 
 int read_block_from_storage(int storage_socket, int master_socket, char *file, char *tag, uint32_t block_number, void **data, size_t *size, int query_id)
+{
+    if (send_block_read_request(storage_socket, file, tag, block_number, query_id) != 0)
+        return -1;
+
+    return receive_block_read_response(storage_socket, master_socket, file, tag, block_number, data, size, query_id);
+}
+
+int send_block_read_request(int storage_socket, char *file, char *tag, uint32_t block_number, int query_id)
 {
     t_log *logger = logger_get();
     t_package *request = package_create_empty(STORAGE_OP_BLOCK_READ_REQ);
@@ -180,7 +188,12 @@ int read_block_from_storage(int storage_socket, int master_socket, char *file, c
     }
 
     package_destroy(request);
+    return 0;
+}
 
+int receive_block_read_response(int storage_socket, int master_socket, char *file, char *tag, uint32_t block_number, void **data, size_t *size, int query_id)
+{
+    t_log *logger = logger_get();
     t_package *storage_response = package_receive(storage_socket);
     if (!storage_response) {
         log_error(logger, "Error al recibir la respuesta de creación de archivo del Storage");
@@ -395,6 +408,149 @@ int write_block_to_storage(int storage_socket, int master_socket, char *file, ch
     return 0;
 }
 
+int send_blocks_read_request(int storage_socket, char *file, char *tag, const uint32_t *block_numbers, uint32_t count, int query_id)
+{
+    t_log *logger = logger_get();
+    t_package *request = package_create_empty(STORAGE_OP_BLOCK_READV_REQ);
+
+    bool ok = request &&
+              package_add_uint32(request, query_id) &&
+              package_add_string(request, file) &&
+              package_add_string(request, tag) &&
+              package_add_uint32(request, count);
+    for (uint32_t i = 0; ok && i < count; i++)
+        ok = package_add_uint32(request, block_numbers[i]);
+
+    if (!ok)
+    {
+        log_error(logger, "Error al armar el paquete para lectura de %u bloques", count);
+        if (request)
+            package_destroy(request);
+        return -1;
+    }
+
+    if (package_send(request, storage_socket) != 0)
+    {
+        log_error(logger, "Error al enviar la solicitud de lectura de %u bloques al Storage", count);
+        package_destroy(request);
+        return -1;
+    }
+
+    package_destroy(request);
+    return 0;
+}
+
+int receive_blocks_read_response(int storage_socket, int master_socket, uint32_t count, void **data, size_t *block_size, int query_id, bool notify_master)
+{
+    t_log *logger = logger_get();
+    *data = NULL;
+
+    t_package *response = package_receive(storage_socket);
+    if (!response)
+    {
+        log_error(logger, "Error al recibir la respuesta de lectura de bloques del Storage");
+        return -1;
+    }
+
+    if (response->operation_code == STORAGE_OP_ERROR)
+    {
+        if (notify_master)
+        {
+            log_error(logger, "Storage reportó error: lectura de bloques");
+            handler_error_from_storage(response, master_socket, query_id);
+        }
+        else
+        {
+            // Lectura anticipada: el acceso no la necesitaba, la Query sigue normalmente
+            log_debug(logger, "Query %d: Storage rechazó una lectura anticipada de %u bloques, se descarta",
+                      query_id, count);
+        }
+        package_destroy(response);
+        return -1;
+    }
+
+    uint32_t response_block_size = 0;
+    uint32_t response_count = 0;
+    size_t data_size = 0;
+    if (response->operation_code != STORAGE_OP_BLOCK_READV_RES ||
+        !package_read_uint32(response, &response_block_size) ||
+        !package_read_uint32(response, &response_count) ||
+        response_count != count ||
+        !(*data = package_read_data(response, &data_size)) ||
+        data_size != (size_t)count * response_block_size)
+    {
+        log_error(logger, "Respuesta inválida del Storage para la lectura de %u bloques", count);
+        free(*data);
+        *data = NULL;
+        package_destroy(response);
+        return -1;
+    }
+
+    *block_size = response_block_size;
+    package_destroy(response);
+    return 0;
+}
+
+int write_blocks_to_storage(int storage_socket, int master_socket, char *file, char *tag, const uint32_t *block_numbers, void *const *blocks, uint32_t count, size_t size, int query_id, bool notify_master)
+{
+    t_log *logger = logger_get();
+    t_package *request = package_create_empty(STORAGE_OP_BLOCK_WRITEV_REQ);
+
+    bool ok = request &&
+              package_add_uint32(request, query_id) &&
+              package_add_string(request, file) &&
+              package_add_string(request, tag) &&
+              package_add_uint32(request, count);
+    for (uint32_t i = 0; ok && i < count; i++)
+        ok = package_add_uint32(request, block_numbers[i]) && package_add_data(request, blocks[i], size);
+
+    if (!ok)
+    {
+        log_error(logger, "Error al armar el paquete para escritura de %u bloques", count);
+        if (request)
+            package_destroy(request);
+        return -1;
+    }
+
+    if (package_send(request, storage_socket) != 0)
+    {
+        log_error(logger, "Error al enviar la solicitud de escritura de %u bloques al Storage", count);
+        package_destroy(request);
+        return -1;
+    }
+    package_destroy(request);
+
+    t_package *response = package_receive(storage_socket);
+    if (!response)
+    {
+        log_error(logger, "Error al recibir la respuesta de escritura de bloques del Storage");
+        return -1;
+    }
+
+    if (response->operation_code == STORAGE_OP_ERROR)
+    {
+        log_error(logger, "Storage reportó error en escritura de bloques del archivo %s:%s", file, tag);
+        if (notify_master)
+            handler_error_from_storage(response, master_socket, query_id);
+        package_destroy(response);
+        return -1;
+    }
+
+    if (response->operation_code != STORAGE_OP_BLOCK_WRITEV_RES)
+    {
+        log_error(logger, "Tipo de paquete inesperado para la respuesta de escritura de bloques (esperado=%u, recibido=%u)",
+                  (unsigned)STORAGE_OP_BLOCK_WRITEV_RES, (unsigned)response->operation_code);
+        package_destroy(response);
+        return -1;
+    }
+
+    package_destroy(response);
+
+    log_debug(logger, "Escritura de %u bloques del archivo %s:%s realizada con éxito", count, file, tag);
+
+    return 0;
+}
+
 int delete_file_in_storage(int storage_socket, int master_socket, char *file, char *tag, int worker_id)
 {
     t_log *logger = logger_get();
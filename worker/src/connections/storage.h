@@ -26,6 +26,22 @@ int handshake_with_storage(const char *storage_ip, const char *storage_port, int
 int get_block_size(int storage_socket, uint16_t *block_size, int worker_id);
 
 int read_block_from_storage(int storage_socket, int master_socket, char *file, char *tag, uint32_t block_number, void **data, size_t *size, int worker_id);
+
+/**
+ * Envía la solicitud de lectura de un bloque sin esperar la respuesta.
+ * El Storage atiende cada conexión en orden, así que se pueden encolar varias
+ * solicitudes y luego leer sus respuestas con receive_block_read_response en
+ * el mismo orden en que se enviaron.
+ * @return 0 si se envió la solicitud, -1 en caso de error.
+ */
+int send_block_read_request(int storage_socket, char *file, char *tag, uint32_t block_number, int query_id);
+
+/**
+ * Recibe la respuesta de una lectura enviada con send_block_read_request.
+ * @param data Se aloca con el contenido del bloque; lo libera el caller.
+ * @return 0 si la lectura fue exitosa, -1 en caso de error (los errores del Storage se notifican al Master).
+ */
+int receive_block_read_response(int storage_socket, int master_socket, char *file, char *tag, uint32_t block_number, void **data, size_t *size, int query_id);
 int create_file_in_storage(int storage_socket, int master_socket, int worker_id, char *file, char *tag);
 int truncate_file_in_storage(int storage_socket, int master_socket, char *file, char *tag, size_t size, int worker_id);
 
@@ -44,5 +60,30 @@ int commit_file_in_storage(int storage_socket, int master_socket, char *file, ch
 int delete_file_in_storage(int storage_socket, int master_socket, char *file, char *tag, int worker_id);
 int write_block_to_storage(int storage_socket, int master_socket, char *file, char *tag, uint32_t block_number, void *data, size_t size, int worker_id);
 
+/**
+ * Envía una lectura de varios bloques de un File:Tag (hasta STORAGE_MAX_VECTOR_BLOCKS)
+ * sin esperar la respuesta. Igual que con send_block_read_request, se pueden
+ * encolar varios pedidos y recibir las respuestas en el mismo orden.
+ * @return 0 si se envió la solicitud, -1 en caso de error.
+ */
+int send_blocks_read_request(int storage_socket, char *file, char *tag, const uint32_t *block_numbers, uint32_t count, int query_id);
+
+/**
+ * Recibe la respuesta de send_blocks_read_request.
+ * @param data Se aloca con los count bloques uno a continuación del otro; lo libera el caller.
+ * @param block_size Tamaño de cada bloque dentro de data.
+ * @param notify_master Si es false (lectura anticipada), un error del Storage sólo se loguea.
+ * @return 0 si la lectura fue exitosa, -1 en caso de error (si notify_master, los errores del Storage se notifican al Master).
+ */
+int receive_blocks_read_response(int storage_socket, int master_socket, uint32_t count, void **data, size_t *block_size, int query_id, bool notify_master);
+
+/**
+ * Escribe varios bloques de un File:Tag (hasta STORAGE_MAX_VECTOR_BLOCKS) en un solo pedido.
+ * @param blocks Contenido de cada bloque, de size bytes.
+ * @param notify_master Si es false (escritura en segundo plano), un error del Storage sólo se loguea.
+ * @return 0 si la operación fue exitosa, -1 en caso de error.
+ */
+int write_blocks_to_storage(int storage_socket, int master_socket, char *file, char *tag, const uint32_t *block_numbers, void *const *blocks, uint32_t count, size_t size, int query_id, bool notify_master);
+
 void handler_error_from_storage(t_package *result, int master_socket, int worker_id);
 #endif
@@ -8,6 +8,7 @@
 #include <utils/logger.h>
 #include <connections/master.h>
 #include <connections/storage.h>
+#include <memory/replacement_policy.h>
 #include "worker_listener.h"
 #include "query_executor.h"
 #include "worker.h"
@@ -33,6 +34,7 @@ int main(int argc, char *argv[])
     int socket_storage = -1;
     int socket_master = -1;
     memory_manager_t *mm = NULL;
+    script_cache_t *script_cache = NULL;
 
     socket_storage = handshake_with_storage(config->storage_ip, config->storage_port, worker_id);
     if (socket_storage < 0)
@@ -65,6 +67,14 @@ int main(int argc, char *argv[])
              config->memory_size, config->block_size, config->replacement_algorithm);
 
     mm_set_storage_connection(mm, socket_storage, worker_id);
+    mm_set_read_ahead(mm, (uint32_t)config->read_ahead_pages);
+
+    script_cache = script_cache_create((size_t)config->script_cache_size);
+    if (!script_cache)
+    {
+        log_error(logger, "## No se pudo inicializar la caché de scripts");
+        goto cleanup;
+    }
 
     socket_master = handshake_with_master(config->master_ip, config->master_port, worker_id);
     if (socket_master < 0)
@@ -72,6 +82,18 @@ int main(int argc, char *argv[])
     
     /* Informar al memory manager cuál es el master socket para notificar errores de Storage */
     mm_set_master_connection(mm, socket_master);
+
+    if (config->flush_high_watermark > 0)
+    {
+        if (mm_start_flusher(mm, config->flush_high_watermark, config->flush_low_watermark,
+                             config->flush_interval) != 0)
+        {
+            log_error(logger, "## No se pudo iniciar la escritura en segundo plano de páginas sucias");
+            goto cleanup;
+        }
+        log_info(logger, "## Escritura en segundo plano de páginas sucias - marcas: %d%% / %d%%",
+                 config->flush_high_watermark, config->flush_low_watermark);
+    }
         
     /* Crear estado global */
     worker_state_t state = {
@@ -85,10 +107,12 @@ int main(int argc, char *argv[])
         .config = config,
         .logger = logger,
         .memory_manager = mm,
+        .script_cache = script_cache,
         .worker_id = worker_id};
 
     pthread_mutex_init(&state.mux, NULL);
     pthread_cond_init(&state.new_query_cond, NULL);
+    pthread_cond_init(&state.preempt_cond, NULL);
 
     /* Crear hilos */
     pthread_t listener_tid, executor_tid;
@@ -109,12 +133,25 @@ int main(int argc, char *argv[])
     pthread_join(executor_tid, NULL);
 
 cleanup:
+    // El flusher usa el socket de Storage: se frena antes de cerrarlo
+    if (mm)
+        mm_stop_flusher(mm);
     if (socket_master >= 0)
         close(socket_master);
     if (socket_storage >= 0)
         close(socket_storage);
     if (mm)
+    {
+        mm_policy_log_stats(mm);
         mm_destroy(mm);
+    }
+    if (script_cache)
+    {
+        log_debug(logger, "## Caché de scripts - hits: %lu - misses: %lu - desalojos: %lu",
+                  (unsigned long)script_cache->hits, (unsigned long)script_cache->misses,
+                  (unsigned long)script_cache->evictions);
+        script_cache_destroy(script_cache);
+    }
     if (config)
         destroy_worker_config(config);
     logger_destroy();
@@ -164,17 +201,10 @@ static void initialize_logger(const t_worker_config *config, int worker_id)
 
 static pt_replacement_t parse_replacement_algorithm(const char *algorithm)
 {
-    if (strcasecmp(algorithm, "LRU") == 0)
-    {
-        return LRU;
-    }
-    else if (strcasecmp(algorithm, "CLOCK_M") == 0 || strcasecmp(algorithm, "CLOCK-M") == 0)
-    {
-        return CLOCK_M;
-    }
-    else
+    pt_replacement_t policy = LRU;
+    if (!mm_policy_from_name(algorithm, &policy))
     {
         fprintf(stderr, "Error: Algoritmo de reemplazo desconocido '%s'. Usando LRU por defecto.\n", algorithm);
-        return LRU;
     }
+    return policy;
 }
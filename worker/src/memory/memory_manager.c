@@ -1,11 +1,16 @@
 #include "memory_manager.h"
+#include "replacement_policy.h"
 #include "../connections/storage.h"
 #include <utils/logger.h>
-#include <stdatomic.h>
+#include <stdio.h>
+#include <sched.h>
+#include <time.h>
 
-static _Atomic uint64_t global_timestamp = 0;
+// Páginas que escribe el flusher por cada vez que toma el lock
+#define MM_FLUSHER_BATCH 16
 
 //--Helper--
+// O(1): cada marco guarda su dueño en la tabla invertida
 bool mm_find_page_for_frame(
     memory_manager_t *mm,
     uint32_t frame_idx,
@@ -13,30 +18,177 @@ bool mm_find_page_for_frame(
     page_table_t **out_pt,
     uint32_t *out_page_idx)
 {
-    for (uint32_t i = 0; i < mm->count; i++)
+    if (!mm || frame_idx >= mm->frame_table.frame_count)
+        return false;
+
+    frame_t *frame = &mm->frame_table.frames[frame_idx];
+    if (frame->owner == MM_NO_FRAME || frame->owner >= mm->count)
+        return false;
+
+    file_tag_entry_t *entry = &mm->entries[frame->owner];
+    if (out_entry)
+        *out_entry = entry;
+    if (out_pt)
+        *out_pt = entry->page_table;
+    if (out_page_idx)
+        *out_page_idx = frame->page;
+    return true;
+}
+
+static void lru_unlink(frame_table_t *ft, uint32_t idx)
+{
+    frame_t *frame = &ft->frames[idx];
+
+    if (frame->lru_prev != MM_NO_FRAME)
+        ft->frames[frame->lru_prev].lru_next = frame->lru_next;
+    else if (ft->lru_head == idx)
+        ft->lru_head = frame->lru_next;
+    else
+        return; // No estaba en la lista
+
+    if (frame->lru_next != MM_NO_FRAME)
+        ft->frames[frame->lru_next].lru_prev = frame->lru_prev;
+    else
+        ft->lru_tail = frame->lru_prev;
+
+    frame->lru_prev = MM_NO_FRAME;
+    frame->lru_next = MM_NO_FRAME;
+}
+
+static void lru_push_mru(frame_table_t *ft, uint32_t idx)
+{
+    frame_t *frame = &ft->frames[idx];
+
+    frame->lru_prev = ft->lru_tail;
+    frame->lru_next = MM_NO_FRAME;
+    if (ft->lru_tail != MM_NO_FRAME)
+        ft->frames[ft->lru_tail].lru_next = idx;
+    else
+        ft->lru_head = idx;
+    ft->lru_tail = idx;
+}
+
+static void free_stack_push(frame_table_t *ft, uint32_t idx)
+{
+    if (ft->frames[idx].free_slot != MM_NO_FRAME)
+        return;
+
+    ft->frames[idx].free_slot = ft->free_count;
+    ft->free_stack[ft->free_count++] = idx;
+}
+
+// Saca un marco cualquiera de la pila: lo reemplaza el del tope
+static void free_stack_remove(frame_table_t *ft, uint32_t idx)
+{
+    uint32_t slot = ft->frames[idx].free_slot;
+    if (slot == MM_NO_FRAME)
+        return;
+
+    uint32_t last = ft->free_stack[--ft->free_count];
+    ft->free_stack[slot] = last;
+    ft->frames[last].free_slot = slot;
+    ft->frames[idx].free_slot = MM_NO_FRAME;
+}
+
+static int mm_evict_frame(memory_manager_t *mm, uint32_t victim_frame);
+
+// Marca el marco como usado y lo saca de los libres
+static int mm_take_frame(memory_manager_t *mm, uint32_t idx)
+{
+    free_stack_remove(&mm->frame_table, idx);
+    mm->frame_table.frames[idx].used = true;
+    return (int)idx;
+}
+
+// Desmapea la página que ocupa el marco (sin escribirla en Storage) y lo deja libre.
+// evicted indica a la política si la página salió por un reemplazo.
+static void mm_release_frame(memory_manager_t *mm, uint32_t idx, bool evicted)
+{
+    frame_t *frame = &mm->frame_table.frames[idx];
+
+    if (frame->owner != MM_NO_FRAME)
     {
-        file_tag_entry_t *entry = &mm->entries[i];
-        page_table_t *pt = entry->page_table;
+        if (mm->policy_ops->on_remove)
+            mm->policy_ops->on_remove(mm, idx, evicted);
+        if (frame->owner < mm->count)
+            pt_unmap(mm->entries[frame->owner].page_table, frame->page);
+        lru_unlink(&mm->frame_table, idx);
+        frame->owner = MM_NO_FRAME;
+        frame->entry = NULL;
+    }
+    frame->used = false;
+    free_stack_push(&mm->frame_table, idx);
+}
 
-        for (uint32_t j = 0; j < pt->page_count; j++)
-        {
-            pt_entry_t *page = &pt->entries[j];
-            if (page->present && page->frame == frame_idx)
-            {
-                if (out_entry)
-                    *out_entry = entry;
-                if (out_pt)
-                    *out_pt = pt;
-                if (out_page_idx)
-                    *out_page_idx = j;
-                return true;
-            }
-        }
+// Libera los marcos de las páginas presentes de pt a partir de from_page
+static void mm_release_pages_from(memory_manager_t *mm, page_table_t *pt, uint32_t from_page)
+{
+    uint32_t page = from_page;
+    pt_entry_t *entry;
+    while ((entry = pt_next_present(pt, &page)) != NULL)
+    {
+        // Liberar el marco puede liberar la hoja de la entrada: no se la vuelve a tocar
+        mm_release_frame(mm, entry->frame, false);
+        page++;
     }
-    return false;
 }
 //--Helper--
 
+#define MM_DIRECTORY_KEY_SIZE 256
+#define MM_INDEX_TO_VALUE(i) ((void *)(uintptr_t)((i) + 1))
+#define MM_VALUE_TO_INDEX(v) ((uint32_t)((uintptr_t)(v) - 1))
+
+// Arma la clave "FILE:TAG" en buffer; si no entra, la aloca (el caller la libera si != buffer)
+static char *mm_directory_key(const char *file, const char *tag, char *buffer, size_t size)
+{
+    int length = snprintf(buffer, size, "%s:%s", file, tag);
+    if (length < 0 || (size_t)length < size)
+        return buffer;
+
+    char *key = malloc(length + 1);
+    if (key)
+        snprintf(key, length + 1, "%s:%s", file, tag);
+    return key;
+}
+
+static void mm_directory_put(memory_manager_t *mm, file_tag_entry_t *entry, uint32_t index)
+{
+    char buffer[MM_DIRECTORY_KEY_SIZE];
+    char *key = mm_directory_key(entry->file, entry->tag, buffer, sizeof(buffer));
+    if (!key)
+        return;
+
+    dictionary_put(mm->directory, key, MM_INDEX_TO_VALUE(index));
+    if (key != buffer)
+        free(key);
+}
+
+static void mm_directory_remove(memory_manager_t *mm, file_tag_entry_t *entry)
+{
+    char buffer[MM_DIRECTORY_KEY_SIZE];
+    char *key = mm_directory_key(entry->file, entry->tag, buffer, sizeof(buffer));
+    if (!key)
+        return;
+
+    dictionary_remove(mm->directory, key);
+    if (key != buffer)
+        free(key);
+}
+
+// Índice del File:Tag en entries, o -1 si no tiene tabla de páginas
+static int64_t mm_directory_find(memory_manager_t *mm, const char *file, const char *tag)
+{
+    char buffer[MM_DIRECTORY_KEY_SIZE];
+    char *key = mm_directory_key(file, tag, buffer, sizeof(buffer));
+    if (!key)
+        return -1;
+
+    void *value = dictionary_get(mm->directory, key);
+    if (key != buffer)
+        free(key);
+    return value ? (int64_t)MM_VALUE_TO_INDEX(value) : -1;
+}
+
 static void mm_resize_entries(memory_manager_t *mm)
 {
     if (mm->count < mm->capacity)
@@ -62,10 +214,18 @@ memory_manager_t *mm_create(size_t memory_size, size_t page_size, pt_replacement
 
     mm->page_size = page_size;
     mm->policy = policy;
+    mm->policy_ops = mm_policy_get(policy);
+    if (!mm->policy_ops)
+    {
+        free(mm);
+        return NULL;
+    }
     mm->memory_retardation = retardation_ms;
     mm->capacity = 0;
     mm->count = 0;
     mm->entries = NULL;
+    mm->directory = dictionary_create();
+    mm->read_ahead_pages = 0;
     mm->storage_socket = -1;
     mm->worker_id = -1;
     mm->master_socket = -1;
@@ -75,19 +235,67 @@ memory_manager_t *mm_create(size_t memory_size, size_t page_size, pt_replacement
     mm->last_victim_page = 0;
     mm->last_victim_valid = false;
     mm->frame_table.clock_pointer = 0;
+    mm->flusher_running = false;
+
+    pthread_mutexattr_t lock_attr;
+    pthread_mutexattr_init(&lock_attr);
+    pthread_mutexattr_settype(&lock_attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mm->lock, &lock_attr);
+    pthread_mutexattr_destroy(&lock_attr);
+    pthread_cond_init(&mm->flusher_cond, NULL);
 
     mm->physical_memory = malloc(memory_size);
     if (!mm->physical_memory)
     {
+        pthread_mutex_destroy(&mm->lock);
+        pthread_cond_destroy(&mm->flusher_cond);
         free(mm);
         return NULL;
     }
 
     mm->frame_table.frame_count = memory_size / page_size;
+    if (mm->frame_table.frame_count >= PT_MAX_FRAMES)
+    {
+        free(mm->physical_memory);
+        pthread_mutex_destroy(&mm->lock);
+        pthread_cond_destroy(&mm->flusher_cond);
+        free(mm);
+        return NULL;
+    }
     mm->frame_table.frames = calloc(mm->frame_table.frame_count, sizeof(frame_t));
-    if (!mm->frame_table.frames)
+    mm->frame_table.free_stack = malloc(mm->frame_table.frame_count * sizeof(uint32_t));
+    if (!mm->frame_table.frames || !mm->frame_table.free_stack)
+    {
+        free(mm->frame_table.frames);
+        free(mm->frame_table.free_stack);
+        free(mm->physical_memory);
+        pthread_mutex_destroy(&mm->lock);
+        pthread_cond_destroy(&mm->flusher_cond);
+        free(mm);
+        return NULL;
+    }
+
+    // Se apilan al revés para que, como antes, se asignen primero los marcos más bajos
+    mm->frame_table.free_count = 0;
+    for (uint32_t i = mm->frame_table.frame_count; i-- > 0;)
+    {
+        mm->frame_table.frames[i].owner = MM_NO_FRAME;
+        mm->frame_table.frames[i].lru_prev = MM_NO_FRAME;
+        mm->frame_table.frames[i].lru_next = MM_NO_FRAME;
+        mm->frame_table.frames[i].free_slot = MM_NO_FRAME;
+        free_stack_push(&mm->frame_table, i);
+    }
+    mm->frame_table.lru_head = MM_NO_FRAME;
+    mm->frame_table.lru_tail = MM_NO_FRAME;
+
+    if (mm->policy_ops->init && mm->policy_ops->init(mm) != 0)
     {
+        dictionary_destroy(mm->directory);
+        free(mm->frame_table.frames);
+        free(mm->frame_table.free_stack);
         free(mm->physical_memory);
+        pthread_mutex_destroy(&mm->lock);
+        pthread_cond_destroy(&mm->flusher_cond);
         free(mm);
         return NULL;
     }
@@ -104,6 +312,26 @@ void mm_set_storage_connection(memory_manager_t *mm, int storage_socket, int wor
     mm->worker_id = worker_id;
 }
 
+void mm_set_read_ahead(memory_manager_t *mm, uint32_t pages)
+{
+    if (!mm)
+        return;
+
+    mm->read_ahead_pages = pages;
+}
+
+void mm_lock(memory_manager_t *mm)
+{
+    if (mm)
+        pthread_mutex_lock(&mm->lock);
+}
+
+void mm_unlock(memory_manager_t *mm)
+{
+    if (mm)
+        pthread_mutex_unlock(&mm->lock);
+}
+
 void mm_set_master_connection(memory_manager_t *mm, int master_socket)
 {
     if (!mm)
@@ -120,11 +348,28 @@ void mm_set_query_id(memory_manager_t *mm, int query_id)
     mm->query_id = query_id;
 }
 
+bool mm_take_memory_deadline(memory_manager_t *mm, struct timespec *deadline)
+{
+    if (!mm || !deadline)
+        return false;
+
+    mm_lock(mm);
+    bool pending = mm->memory_delay_pending;
+    if (pending)
+        *deadline = mm->memory_deadline;
+    mm->memory_delay_pending = false;
+    mm_unlock(mm);
+
+    return pending;
+}
+
 void mm_destroy(memory_manager_t *mm)
 {
     if (!mm)
         return;
 
+    mm_stop_flusher(mm);
+
     for (uint32_t i = 0; i < mm->count; i++)
     {
         file_tag_entry_t *entry = &mm->entries[i];
@@ -136,9 +381,16 @@ void mm_destroy(memory_manager_t *mm)
             pt_destroy(entry->page_table);
     }
 
+    if (mm->policy_ops->destroy)
+        mm->policy_ops->destroy(mm);
+
     free(mm->entries);
+    dictionary_destroy(mm->directory);
     free(mm->frame_table.frames);
+    free(mm->frame_table.free_stack);
     free(mm->physical_memory);
+    pthread_mutex_destroy(&mm->lock);
+    pthread_cond_destroy(&mm->flusher_cond);
     free(mm);
 }
 
@@ -147,13 +399,8 @@ page_table_t *mm_find_page_table(memory_manager_t *mm, char *file, char *tag)
     if (!mm || !file || !tag)
         return NULL;
 
-    for (uint32_t i = 0; i < mm->count; i++)
-    {
-        file_tag_entry_t *entry = &mm->entries[i];
-        if (strcmp(entry->file, file) == 0 && strcmp(entry->tag, tag) == 0)
-            return entry->page_table;
-    }
-    return NULL;
+    int64_t index = mm_directory_find(mm, file, tag);
+    return index >= 0 ? mm->entries[index].page_table : NULL;
 }
 
 page_table_t *mm_create_page_table(memory_manager_t *mm, char *file, char *tag)
@@ -182,6 +429,8 @@ page_table_t *mm_create_page_table(memory_manager_t *mm, char *file, char *tag)
         return NULL;
     }
 
+    entry->page_table->owner_index = mm->count - 1;
+    mm_directory_put(mm, entry, mm->count - 1);
     return entry->page_table;
 }
 
@@ -190,18 +439,33 @@ void mm_remove_page_table(memory_manager_t *mm, char *file, char *tag)
     if (!mm || !file || !tag)
         return;
 
-    for (uint32_t i = 0; i < mm->count; i++)
+    int64_t found = mm_directory_find(mm, file, tag);
+    if (found < 0)
+        return;
+
+    uint32_t i = (uint32_t)found;
+    file_tag_entry_t *entry = &mm->entries[i];
+
+    // Los marcos del File:Tag borrado quedan libres
+    mm_release_pages_from(mm, entry->page_table, 0);
+
+    mm_directory_remove(mm, entry);
+    free(entry->file);
+    free(entry->tag);
+    pt_destroy(entry->page_table);
+    mm->entries[i] = mm->entries[mm->count - 1];
+    mm->count--;
+
+    // La última entrada pasó a la posición i: actualizar el directorio y la tabla invertida
+    if (i < mm->count)
     {
-        file_tag_entry_t *entry = &mm->entries[i];
-        if (strcmp(entry->file, file) == 0 && strcmp(entry->tag, tag) == 0)
-        {
-            free(entry->file);
-            free(entry->tag);
-            pt_destroy(entry->page_table);
-            mm->entries[i] = mm->entries[mm->count - 1];
-            mm->count--;
-            return;
-        }
+        mm_directory_put(mm, &mm->entries[i], i);
+
+        page_table_t *moved = mm->entries[i].page_table;
+        moved->owner_index = i;
+        pt_entry_t *present;
+        for (uint32_t page = 0; (present = pt_next_present(moved, &page)) != NULL; page++)
+            mm->frame_table.frames[present->frame].owner = i;
     }
 }
 
@@ -214,6 +478,10 @@ int mm_resize_page_table(memory_manager_t *mm, char *file, char *tag, uint32_t n
     if (!pt)
         return -1;
 
+    // Al achicar, las páginas que quedan afuera liberan su marco
+    if (new_page_count > 0 && new_page_count < pt->page_count)
+        mm_release_pages_from(mm, pt, new_page_count);
+
     return pt_resize(pt, new_page_count);
 }
 
@@ -222,6 +490,90 @@ bool mm_has_page_table(memory_manager_t *mm, char *file, char *tag)
     return mm_find_page_table(mm, file, tag) != NULL;
 }
 
+/*
+ * Resumen de la caché para el Master: los File:Tag con más páginas presentes,
+ * de mayor a menor. Retorna cuántos se cargaron en out (a lo sumo max).
+ */
+uint32_t mm_resident_file_tags(memory_manager_t *mm, file_tag_entry_t **out, uint32_t max)
+{
+    if (!mm || !out || max == 0)
+        return 0;
+
+    uint32_t present_of[max];
+    uint32_t filled = 0;
+
+    for (uint32_t i = 0; i < mm->count; i++)
+    {
+        file_tag_entry_t *entry = &mm->entries[i];
+        uint32_t present = entry->page_table ? entry->page_table->present_count : 0;
+        if (present == 0 || (filled == max && present <= present_of[max - 1]))
+            continue;
+
+        // Inserción ordenada: max es chico, alcanza con correr los menores
+        uint32_t pos = filled < max ? filled++ : max - 1;
+        while (pos > 0 && present_of[pos - 1] < present)
+        {
+            out[pos] = out[pos - 1];
+            present_of[pos] = present_of[pos - 1];
+            pos--;
+        }
+        out[pos] = entry;
+        present_of[pos] = present;
+    }
+    return filled;
+}
+
+// Copia el bloque leído al marco y completa con ceros lo que falte de la página
+static void mm_fill_frame(memory_manager_t *mm, void *frame_addr, void *data, size_t size)
+{
+    size_t copy_size = 0;
+    if (data != NULL)
+    {
+        copy_size = (size < mm->page_size) ? size : mm->page_size;
+        memcpy(frame_addr, data, copy_size);
+    }
+
+    if (copy_size < mm->page_size)
+        memset((uint8_t *)frame_addr + copy_size, 0, mm->page_size - copy_size);
+}
+
+static void mm_log_page_added(memory_manager_t *mm, char *file, char *tag, uint32_t page_number, int frame)
+{
+    t_log *logger = logger_get();
+    if (!logger)
+        return;
+
+    log_info(logger,
+             "Query %d: Se asigna el Marco: %d a la Página: %d perteneciente al File: %s Tag: %s",
+             mm->query_id, frame, page_number, file, tag);
+
+    log_info(logger,
+             "Query %d: Memoria Add - File: %s - Tag: %s - Pagina: %d - Marco: %d",
+             mm->query_id, file, tag, page_number, frame);
+}
+
+// Informa el reemplazo si la última asignación de marco desalojó una página
+static void mm_log_replacement(memory_manager_t *mm, char *file, char *tag, uint32_t page_number)
+{
+    if (!mm->last_victim_valid)
+        return;
+
+    t_log *logger = logger_get();
+    if (logger)
+    {
+        log_info(logger,
+                 "## Query %d: Se reemplaza la página %s:%s/%d por la %s:%s/%d",
+                 mm->query_id,
+                 mm->last_victim_file,
+                 mm->last_victim_tag,
+                 mm->last_victim_page,
+                 file,
+                 tag,
+                 page_number);
+    }
+    mm->last_victim_valid = false;
+}
+
 int mm_handle_page_fault(memory_manager_t *mm, page_table_t *pt, char *file, char *tag, uint32_t page_number)
 {
     if (!mm || !pt || !file || !tag)
@@ -242,6 +594,7 @@ int mm_handle_page_fault(memory_manager_t *mm, page_table_t *pt, char *file, cha
         log_info(logger, "Query %d: Memoria Miss - File: %s - Tag: %s - Pagina: %d",
                  mm->query_id, file, tag, page_number);
     }
+    mm->misses++;
 
     int frame = mm_allocate_frame(mm);
     if (frame == -1)
@@ -262,15 +615,8 @@ int mm_handle_page_fault(memory_manager_t *mm, page_table_t *pt, char *file, cha
 
     if (result == 0 && data != NULL && size > 0)
     {
-        // Bloque existe en Storage - copiar datos
-        size_t copy_size = (size < mm->page_size) ? size : mm->page_size;
-        memcpy(frame_addr, data, copy_size);
-        
-        // Si el bloque es más pequeño que la página, rellenar con ceros el resto
-        if (copy_size < mm->page_size)
-        {
-            memset((uint8_t *)frame_addr + copy_size, 0, mm->page_size - copy_size);
-        }
+        // Bloque existe en Storage - copiar datos (si es más chico que la página, el resto queda en ceros)
+        mm_fill_frame(mm, frame_addr, data, size);
         free(data);
     }
     else if (result != 0 && result != -2)
@@ -294,49 +640,203 @@ int mm_handle_page_fault(memory_manager_t *mm, page_table_t *pt, char *file, cha
             log_debug(logger, "Query %d: Bloque %d del archivo %s:%s no existe en Storage, inicializando con ceros",
                      mm->query_id, block_number, file, tag);
         }
-        memset(frame_addr, 0, mm->page_size);
+        mm_fill_frame(mm, frame_addr, NULL, 0);
         
         if (data)
             free(data);
     }
 
-    if (pt_map(pt, page_number, frame) != 0)
+    if (mm_map_page(mm, pt, page_number, frame) != 0)
     {
         mm_free_frame(mm, frame);
         return -1;
     }
 
-    mm_update_page_access(mm, pt, page_number);
+    mm_log_page_added(mm, file, tag, page_number, frame);
+    mm_log_replacement(mm, file, tag, page_number);
 
-    if (logger)
+    return 0;
+}
+
+// Fin del pedido READV que empieza en start: no mezcla páginas pedidas con anticipadas
+static uint32_t mm_read_group_end(uint32_t start, uint32_t count, uint32_t requested_count)
+{
+    uint32_t limit = (start < requested_count) ? requested_count : count;
+    return (limit - start > STORAGE_MAX_VECTOR_BLOCKS) ? start + STORAGE_MAX_VECTOR_BLOCKS : limit;
+}
+
+/**
+ * Trae de una vez las páginas ausentes de [first_page, last_page]: primero
+ * reserva todos los marcos (los desalojos escriben en Storage por el mismo
+ * socket), después envía las lecturas agrupadas en pedidos READV y recién ahí
+ * recibe las respuestas, que llegan en orden. Así un acceso de N páginas paga
+ * un solo viaje de ida y vuelta en lugar de N.
+ *
+ * Si el acceso continúa al anterior sobre el mismo File:Tag y le faltaba alguna
+ * página, también pide hasta read_ahead_pages páginas siguientes, así los
+ * accesos que siguen las encuentran en memoria. Sólo usa marcos libres: la
+ * lectura anticipada nunca desaloja. Puede pasarse del tamaño conocido de la
+ * tabla (que sólo crece hasta la última página accedida); la tabla crece
+ * únicamente por las páginas que Storage devuelve, y si las rechaza (por
+ * ejemplo, fuera del archivo) se descartan sin avisar al Master.
+ *
+ * Retorna -1 sólo si falló una página del rango pedido; las que no se
+ * pudieron traer acá las resuelve después mm_handle_page_fault.
+ */
+static int mm_read_ahead(memory_manager_t *mm, page_table_t *pt, char *file, char *tag,
+                         uint32_t first_page, uint32_t last_page)
+{
+    if (mm->storage_socket == -1 || mm->worker_id == -1)
+        return 0;
+
+    if (last_page >= pt->page_count && pt_resize(pt, last_page + 1) != 0)
+        return -1;
+
+    bool sequential = pt->sequential_next != 0 &&
+                      (first_page == pt->sequential_next || first_page + 1 == pt->sequential_next);
+    pt->sequential_next = last_page + 1;
+
+    // Sólo un acceso con fallos anticipa: si todo estaba en memoria no se habla con Storage
+    bool missing = false;
+    for (uint32_t page = first_page; page <= last_page && !missing; page++)
+        missing = !pt_is_present(pt, page);
+    if (!missing)
+        return 0;
+
+    uint32_t end_page = last_page;
+    if (sequential && mm->read_ahead_pages > 0)
     {
-        log_info(logger,
-                 "Query %d: Se asigna el Marco: %d a la Página: %d perteneciente al File: %s Tag: %s",
-                 mm->query_id, frame, page_number, file, tag);
+        uint32_t available = UINT32_MAX - last_page;
+        end_page += (mm->read_ahead_pages < available) ? mm->read_ahead_pages : available;
+    }
 
-        log_info(logger,
-                 "Query %d: Memoria Add - File: %s - Tag: %s - Pagina: %d - Marco: %d",
-                 mm->query_id, file, tag, page_number, frame);
+    uint32_t max_pages = end_page - first_page + 1;
+    if (max_pages > mm->frame_table.frame_count)
+        max_pages = mm->frame_table.frame_count;
+
+    uint32_t *pages = malloc(max_pages * sizeof(uint32_t));
+    int *frames = malloc(max_pages * sizeof(int));
+    if (!pages || !frames)
+    {
+        free(pages);
+        free(frames);
+        return 0; // Sin lectura anticipada: cada página se resuelve con su page fault
     }
 
-    if (mm->last_victim_valid)
+    t_log *logger = logger_get();
+    uint32_t count = 0;
+    uint32_t ahead = 0;
+    for (uint32_t page = first_page; page <= end_page && count < max_pages; page++)
     {
-        if (logger)
+        if (pt_is_present(pt, page))
+            continue;
+
+        bool requested = page <= last_page;
+        if (!requested && mm->frame_table.free_count == 0)
+            break;
+
+        // Las páginas anticipadas no las pidió la Query: no son misses
+        if (requested)
         {
-            log_info(logger,
-                     "## Query %d: Se reemplaza la página %s:%s/%d por la %s:%s/%d",
-                     mm->query_id,
-                     mm->last_victim_file,
-                     mm->last_victim_tag,
-                     mm->last_victim_page,
-                     file,
-                     tag,
-                     page_number);
+            if (logger)
+            {
+                log_info(logger, "Query %d: Memoria Miss - File: %s - Tag: %s - Pagina: %d",
+                         mm->query_id, file, tag, page);
+            }
+            mm->misses++;
         }
-        mm->last_victim_valid = false;
+        else if (logger)
+        {
+            log_debug(logger, "Query %d: Lectura anticipada - File: %s - Tag: %s - Pagina: %d",
+                      mm->query_id, file, tag, page);
+        }
+
+        int frame = mm_allocate_frame(mm);
+        if (frame == -1)
+            break;
+        if (requested)
+            mm_log_replacement(mm, file, tag, page);
+
+        pages[count] = page;
+        frames[count] = frame;
+        count++;
+        if (!requested)
+            ahead++;
     }
 
-    return 0;
+    // Un pedido READV para las páginas del rango y otro para las anticipadas,
+    // así un error en la lectura anticipada no hace fallar al acceso
+    uint32_t requested_count = count - ahead;
+    uint32_t sent = 0;
+    while (sent < count)
+    {
+        uint32_t group_end = mm_read_group_end(sent, count, requested_count);
+        if (send_blocks_read_request(mm->storage_socket, file, tag, &pages[sent],
+                                     group_end - sent, mm->query_id) != 0)
+            break;
+        sent = group_end;
+    }
+
+    int result = 0;
+    for (uint32_t start = 0; start < count;)
+    {
+        uint32_t group_end = mm_read_group_end(start, count, requested_count);
+        void *data = NULL;
+        size_t block_size = 0;
+
+        // Sólo los errores de las páginas pedidas llegan al Master
+        bool loaded = start < sent &&
+                      receive_blocks_read_response(mm->storage_socket, mm->master_socket, group_end - start,
+                                                   &data, &block_size, mm->query_id, start < requested_count) == 0;
+
+        for (uint32_t i = start; i < group_end; i++)
+        {
+            bool mapped = loaded;
+            if (mapped)
+            {
+                mm_fill_frame(mm, mm_get_frame_address(mm, frames[i]),
+                              (uint8_t *)data + (size_t)(i - start) * block_size, block_size);
+                // Una página anticipada puede estar más allá de la tabla: crece al llegar
+                mapped = (pages[i] < pt->page_count || pt_resize(pt, pages[i] + 1) == 0) &&
+                         mm_map_page(mm, pt, pages[i], frames[i]) == 0;
+            }
+
+            if (!mapped)
+            {
+                mm_free_frame(mm, frames[i]);
+                if (pages[i] <= last_page)
+                {
+                    result = -1;
+                    if (logger)
+                    {
+                        log_error(logger, "Query %d: Error al leer bloque %d del archivo %s:%s desde Storage",
+                                  mm->query_id, pages[i], file, tag);
+                    }
+                }
+                else if (logger)
+                {
+                    log_debug(logger, "Query %d: Se descarta la lectura anticipada del bloque %d de %s:%s",
+                              mm->query_id, pages[i], file, tag);
+                }
+                continue;
+            }
+
+            mm_log_page_added(mm, file, tag, pages[i], frames[i]);
+        }
+
+        free(data);
+        start = group_end;
+    }
+
+    if (logger && count > 1)
+    {
+        log_debug(logger, "Query %d: Lectura anticipada de %u páginas de %s:%s (%u fuera del rango pedido)",
+                  mm->query_id, count, file, tag, ahead);
+    }
+
+    free(pages);
+    free(frames);
+    return result;
 }
 
 static int mm_access_memory(memory_manager_t *mm, page_table_t *pt, char *file, char *tag,
@@ -352,6 +852,22 @@ static int mm_access_memory(memory_manager_t *mm, page_table_t *pt, char *file,
     size_t remaining = size;
     uint8_t *ptr = buffer;
 
+    uint32_t last_page = (uint32_t)((base_address + size - 1) / page_size);
+
+    // Los aciertos se informan antes de traer las páginas faltantes: así la política
+    // distingue una nueva referencia de la primera, que recibe al mapear la página
+    for (uint32_t page = current_page; page <= last_page && page < pt->page_count; page++)
+    {
+        if (pt_is_present(pt, page))
+        {
+            mm->hits++;
+            mm_update_page_access(mm, pt, page);
+        }
+    }
+
+    if (mm_read_ahead(mm, pt, file, tag, current_page, last_page) != 0)
+        return -1;
+
     while (remaining > 0)
     {
         // Expandir la tabla de páginas si es necesario
@@ -362,17 +878,15 @@ static int mm_access_memory(memory_manager_t *mm, page_table_t *pt, char *file,
                 return -1;
         }
 
-        pt_entry_t *entry = &pt->entries[current_page];
-        if (!entry->present)
+        pt_entry_t *entry = pt_find_entry(pt, current_page);
+        if (!entry || !entry->present)
         {
             // Intentar manejar el page fault
             if (mm_handle_page_fault(mm, pt, file, tag, current_page) != 0)
                 return -1;
-            entry = &pt->entries[current_page]; // Releer entry para asegurar que el entry->frame que se usa es el que se acaba de mapear.
+            entry = pt_find_entry(pt, current_page); // Releer entry para asegurar que el entry->frame que se usa es el que se acaba de mapear.
         }
 
-        mm_update_page_access(mm, pt, current_page);
-
         void *frame_addr = mm_get_frame_address(mm, entry->frame);
         size_t bytes_to_copy = page_size - offset;
         if (bytes_to_copy > remaining)
@@ -423,8 +937,19 @@ static int mm_access_memory(memory_manager_t *mm, page_table_t *pt, char *file,
         offset = 0;
     }
 
-    // Retardo de memoria simulado
-    usleep(mm->memory_retardation * 1000);
+    // Retardo de memoria simulado: se cobra una vez por instrucción (ver mm_take_memory_deadline)
+    if (!mm->memory_delay_pending && mm->memory_retardation > 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &mm->memory_deadline);
+        mm->memory_deadline.tv_sec += mm->memory_retardation / 1000;
+        mm->memory_deadline.tv_nsec += (long)(mm->memory_retardation % 1000) * 1000000L;
+        if (mm->memory_deadline.tv_nsec >= 1000000000L)
+        {
+            mm->memory_deadline.tv_sec++;
+            mm->memory_deadline.tv_nsec -= 1000000000L;
+        }
+        mm->memory_delay_pending = true;
+    }
 
     return 0;
 }
@@ -439,7 +964,7 @@ int mm_read_from_memory(memory_manager_t *mm, page_table_t *pt, char *file, char
     return mm_access_memory(mm, pt, file, tag, base_address, out_buffer, size, false);
 }
 
-pt_entry_t *mm_get_dirty_pages(memory_manager_t *mm, char *file, char *tag, size_t *count)
+pt_dirty_page_t *mm_get_dirty_pages(memory_manager_t *mm, char *file, char *tag, size_t *count)
 {
     if (!mm || !file || !tag || !count)
         return NULL;
@@ -459,13 +984,10 @@ int mm_allocate_frame(memory_manager_t *mm)
     if (!mm)
         return -1;
 
-    for (uint32_t i = 0; i < mm->frame_table.frame_count; i++)
+    if (mm->frame_table.free_count > 0)
     {
-        if (!mm->frame_table.frames[i].used)
-        {
-            mm->frame_table.frames[i].used = true;
-            return i;
-        }
+        uint32_t free_frame = mm->frame_table.free_stack[mm->frame_table.free_count - 1];
+        return mm_take_frame(mm, free_frame);
     }
 
     t_log *logger = logger_get();
@@ -474,38 +996,21 @@ int mm_allocate_frame(memory_manager_t *mm)
         log_info(logger, "## Query %d: - Memoria Llena - No hay marcos disponibles (Frame Count: %d)",
                  mm->query_id, mm->frame_table.frame_count);
         log_debug(logger, "## Query %d: Política de reemplazo configurada: %s (%d)",
-                 mm->query_id, mm->policy == LRU ? "LRU" : (mm->policy == CLOCK_M ? "CLOCK-M" : "DESCONOCIDA"), mm->policy);
+                 mm->query_id, mm->policy_ops->name, mm->policy);
     }
 
-    if (mm->policy == LRU)
-    {
-        int victim_frame = mm_find_lru_victim(mm);
-        if (victim_frame != -1)
-        {
-            if (logger)
-            {
-                log_debug(logger, "## Query %d: Frame %d liberado usando algoritmo LRU",
-                         mm->query_id, victim_frame);
-            }
-            mm->frame_table.frames[victim_frame].used = true;
-            return victim_frame;
-        }
-    }
-    else if (mm->policy == CLOCK_M)
+    int victim_frame = mm->policy_ops->choose_victim(mm);
+    if (victim_frame != -1)
+        victim_frame = mm_evict_frame(mm, (uint32_t)victim_frame);
+
+    if (victim_frame != -1)
     {
-        int victim_frame = mm_find_clockm_victim(mm);
-        if (victim_frame != -1)
+        if (logger)
         {
-            if (logger)
-            {
-                log_debug(logger,
-                         "## Query %d: Frame %d liberado usando algoritmo CLOCK-M",
-                         mm->query_id,
-                         victim_frame);
-            }
-            mm->frame_table.frames[victim_frame].used = true;
-            return victim_frame;
+            log_debug(logger, "## Query %d: Frame %d liberado usando algoritmo %s",
+                     mm->query_id, victim_frame, mm->policy_ops->name);
         }
+        return mm_take_frame(mm, victim_frame);
     }
 
     if (logger)
@@ -517,15 +1022,41 @@ int mm_allocate_frame(memory_manager_t *mm)
     return -1;
 }
 
-int mm_free_frame(memory_manager_t *mm, uint32_t frame)
+int mm_map_page(memory_manager_t *mm, page_table_t *pt, uint32_t page_number, uint32_t frame)
 {
-    if (!mm || frame >= mm->frame_table.frame_count)
+    if (!mm || !pt || frame >= mm->frame_table.frame_count)
+        return -1;
+
+    // La tabla guarda su posición en entries: no hace falta buscarla
+    uint32_t owner = pt->owner_index;
+    if (owner >= mm->count || mm->entries[owner].page_table != pt ||
+        pt_map(pt, page_number, frame) != 0)
         return -1;
-    mm->frame_table.frames[frame].used = false;
+
+    frame_t *f = &mm->frame_table.frames[frame];
+    if (f->owner != MM_NO_FRAME && mm->policy_ops->on_remove)
+        mm->policy_ops->on_remove(mm, frame, false);
+    lru_unlink(&mm->frame_table, frame);
+    mm_take_frame(mm, frame);
+    f->owner = owner;
+    f->page = page_number;
+    f->entry = pt_find_entry(pt, page_number);
+    lru_push_mru(&mm->frame_table, frame);
+
+    if (mm->policy_ops->on_insert)
+        mm->policy_ops->on_insert(mm, frame);
     return 0;
 }
 
-void *mm_get_frame_address(memory_manager_t *mm, uint32_t frame)
+int mm_free_frame(memory_manager_t *mm, uint32_t frame)
+{
+    if (!mm || frame >= mm->frame_table.frame_count)
+        return -1;
+    mm_release_frame(mm, frame, false);
+    return 0;
+}
+
+void *mm_get_frame_address(memory_manager_t *mm, uint32_t frame)
 {
     if (!mm || frame >= mm->frame_table.frame_count)
         return NULL;
@@ -541,10 +1072,69 @@ void mm_mark_all_clean(memory_manager_t *mm, char *file, char *tag)
     if (!pt)
         return;
 
-    for (uint32_t i = 0; i < pt->page_count; i++)
+    pt_clear_dirty(pt);
+}
+
+/**
+ * Escribe en Storage las páginas sucias presentes de dirty_pages, agrupadas
+ * en pedidos WRITEV de hasta STORAGE_MAX_VECTOR_BLOCKS bloques, y las marca
+ * limpias. Retorna la cantidad de páginas escritas o -1 si falla algún pedido;
+ * las páginas de un pedido fallido quedan sucias. notify_master indica si un
+ * error del Storage se informa al Master como error de la Query en curso.
+ */
+static int mm_write_back_pages(memory_manager_t *mm, char *file, char *tag, page_table_t *pt,
+                               pt_dirty_page_t *dirty_pages, size_t dirty_count, bool notify_master)
+{
+    uint32_t block_numbers[STORAGE_MAX_VECTOR_BLOCKS];
+    void *blocks[STORAGE_MAX_VECTOR_BLOCKS];
+    t_log *logger = logger_get();
+    int written = 0;
+
+    size_t i = 0;
+    while (i < dirty_count)
     {
-        pt_set_dirty(pt, i, false);
+        uint32_t count = 0;
+        for (; i < dirty_count && count < STORAGE_MAX_VECTOR_BLOCKS; i++)
+        {
+            pt_dirty_page_t *p = &dirty_pages[i];
+            if (!p->present)
+                continue;
+
+            block_numbers[count] = p->page_number;
+            blocks[count] = mm_get_frame_address(mm, p->frame);
+            count++;
+        }
+
+        if (count == 0)
+            break;
+
+        if (write_blocks_to_storage(mm->storage_socket, mm->master_socket, file, tag,
+                                    block_numbers, blocks, count, mm->page_size, mm->query_id,
+                                    notify_master) != 0)
+        {
+            if (logger)
+            {
+                log_error(logger,
+                          "## Query %d: Error al escribir %u página(s) sucia(s) en Storage - File: %s - Tag: %s",
+                          mm->query_id, count, file, tag);
+            }
+            return -1;
+        }
+
+        for (uint32_t k = 0; k < count; k++)
+        {
+            if (logger)
+            {
+                log_info(logger,
+                         "## Query %d: Página sucia escrita en Storage - File: %s - Tag: %s - Pagina: %d",
+                         mm->query_id, file, tag, block_numbers[k]);
+            }
+            pt_set_dirty(pt, block_numbers[k], false);
+        }
+        written += count;
     }
+
+    return written;
 }
 
 int mm_flush_query(memory_manager_t *mm, char *file, char *tag)
@@ -556,7 +1146,7 @@ int mm_flush_query(memory_manager_t *mm, char *file, char *tag)
         return -1;
 
     size_t dirty_count = 0;
-    pt_entry_t *dirty_pages = mm_get_dirty_pages(mm, file, tag, &dirty_count);
+    pt_dirty_page_t *dirty_pages = mm_get_dirty_pages(mm, file, tag, &dirty_count);
     if (!dirty_pages || dirty_count == 0)
     {
         if (dirty_pages)
@@ -571,58 +1161,9 @@ int mm_flush_query(memory_manager_t *mm, char *file, char *tag)
         return -1;
     }
 
-    t_log *logger = logger_get();
-
-    for (size_t i = 0; i < dirty_count; i++)
-    {
-        pt_entry_t *p = &dirty_pages[i];
-
-        if (!p->present)
-        {
-            continue;
-        }
-
-        void *frame_addr = mm_get_frame_address(mm, p->frame);
-        if (!frame_addr)
-        {
-            if (logger)
-            {
-                log_error(logger,
-                          "## Query %d: Error al obtener dirección de marco para flush - File: %s - Tag: %s - Pagina: %d",
-                          mm->query_id, file, tag, p->page_number);
-            }
-            free(dirty_pages);
-            return -1;
-        }
-
-        int write_res = write_block_to_storage(mm->storage_socket, mm->master_socket,
-                               file, tag, p->page_number,
-                               frame_addr, mm->page_size,
-                               mm->query_id);
-        if (write_res != 0)
-        {
-            if (logger)
-            {
-                log_error(logger,
-                          "## Query %d: Error al escribir página sucia en Storage - File: %s - Tag: %s - Pagina: %d",
-                          mm->query_id, file, tag, p->page_number);
-            }
-            free(dirty_pages);
-            return -1;
-        }
-
-        if (logger)
-        {
-            log_info(logger,
-                     "## Query %d: Página sucia escrita en Storage - File: %s - Tag: %s - Pagina: %d",
-                     mm->query_id, file, tag, p->page_number);
-        }
-
-        pt_set_dirty(pt, p->page_number, false);
-    }
-
+    int written = mm_write_back_pages(mm, file, tag, pt, dirty_pages, dirty_count, true);
     free(dirty_pages);
-    return 0;
+    return written < 0 ? -1 : 0;
 }
 
 int mm_flush_all_dirty(memory_manager_t *mm)
@@ -635,6 +1176,9 @@ int mm_flush_all_dirty(memory_manager_t *mm)
 
     t_log *logger = logger_get();
     int total_flushed = 0;
+    int result = 0;
+
+    mm_lock(mm);
 
     // Recorrer todas las entradas de File:Tag
     for (uint32_t i = 0; i < mm->count; i++)
@@ -644,7 +1188,7 @@ int mm_flush_all_dirty(memory_manager_t *mm)
         char *tag = entry->tag;
 
         size_t dirty_count = 0;
-        pt_entry_t *dirty_pages = mm_get_dirty_pages(mm, file, tag, &dirty_count);
+        pt_dirty_page_t *dirty_pages = mm_get_dirty_pages(mm, file, tag, &dirty_count);
         
         if (!dirty_pages || dirty_count == 0)
         {
@@ -667,56 +1211,16 @@ int mm_flush_all_dirty(memory_manager_t *mm)
                      mm->query_id, dirty_count, file, tag);
         }
 
-        // Escribir cada página sucia a Storage
-        for (size_t j = 0; j < dirty_count; j++)
+        int written = mm_write_back_pages(mm, file, tag, pt, dirty_pages, dirty_count, true);
+        free(dirty_pages);
+        if (written < 0)
         {
-            pt_entry_t *p = &dirty_pages[j];
-
-            if (!p->present)
-                continue;
-
-            void *frame_addr = mm_get_frame_address(mm, p->frame);
-            if (!frame_addr)
-            {
-                if (logger)
-                {
-                    log_error(logger,
-                              "## Query %d: Error al obtener dirección de marco para flush - File: %s - Tag: %s - Pagina: %d",
-                              mm->query_id, file, tag, p->page_number);
-                }
-                free(dirty_pages);
-                return -1;
-            }
-
-            int write_res = write_block_to_storage(mm->storage_socket, mm->master_socket,
-                                                   file, tag, p->page_number,
-                                                   frame_addr, mm->page_size,
-                                                   mm->query_id);
-            if (write_res != 0)
-            {
-                if (logger)
-                {
-                    log_error(logger,
-                              "## Query %d: Error al escribir página sucia en Storage - File: %s - Tag: %s - Pagina: %d",
-                              mm->query_id, file, tag, p->page_number);
-                }
-                free(dirty_pages);
-                return -1;
-            }
-
-            if (logger)
-            {
-                log_info(logger,
-                         "## Query %d: Página sucia escrita en Storage - File: %s - Tag: %s - Pagina: %d",
-                         mm->query_id, file, tag, p->page_number);
-            }
-
-            pt_set_dirty(pt, p->page_number, false);
-            total_flushed++;
+            result = -1;
+            break;
         }
-
-        free(dirty_pages);
+        total_flushed += written;
     }
+    mm_unlock(mm);
 
     if (logger && total_flushed > 0)
     {
@@ -725,101 +1229,187 @@ int mm_flush_all_dirty(memory_manager_t *mm)
                  mm->query_id, total_flushed);
     }
 
-    return 0;
+    return result;
 }
 
-void mm_update_page_access(memory_manager_t *mm, page_table_t *pt, uint32_t page_number)
+uint32_t mm_dirty_frame_count(memory_manager_t *mm)
 {
-    if (!mm || !pt)
-        return;
+    if (!mm)
+        return 0;
 
-    if (page_number >= pt->page_count)
-        return;
+    // Cada tabla lleva la cuenta de sus páginas sucias: no hace falta recorrer los marcos
+    uint32_t dirty = 0;
+    for (uint32_t i = 0; i < mm->count; i++)
+        dirty += mm->entries[i].page_table->dirty_count;
+    return dirty;
+}
 
-    if (mm->policy == LRU)
+/**
+ * Escribe hasta MM_FLUSHER_BATCH páginas sucias de un mismo File:Tag, empezando
+ * por la menos recientemente usada: son las primeras candidatas a reemplazo.
+ * Retorna la cantidad escrita, 0 si no hay páginas sucias o -1 si falla.
+ *
+ * La escritura no pertenece a la Query en curso: un error sólo se loguea y las
+ * páginas quedan sucias para el próximo flush o reemplazo, que sí lo informan.
+ */
+static int mm_write_back_lru_batch(memory_manager_t *mm)
+{
+    pt_dirty_page_t batch[MM_FLUSHER_BATCH];
+    uint32_t owner = MM_NO_FRAME;
+    size_t count = 0;
+
+    for (uint32_t idx = mm->frame_table.lru_head; idx != MM_NO_FRAME && count < MM_FLUSHER_BATCH;
+         idx = mm->frame_table.frames[idx].lru_next)
     {
-        uint64_t new_ts = atomic_fetch_add(&global_timestamp, 1) + 1;
-        pt_update_access_time(pt, page_number, new_ts);
-        return;
+        frame_t *frame = &mm->frame_table.frames[idx];
+        if (frame->owner >= mm->count || (owner != MM_NO_FRAME && frame->owner != owner))
+            continue;
+
+        if (!frame->entry || !frame->entry->dirty)
+            continue;
+
+        owner = frame->owner;
+        batch[count++] = (pt_dirty_page_t){
+            .page_number = frame->page,
+            .frame = idx,
+            .present = true,
+            .dirty = true,
+        };
     }
 
-    if (mm->policy == CLOCK_M)
+    if (count == 0)
+        return 0;
+
+    file_tag_entry_t *entry = &mm->entries[owner];
+    return mm_write_back_pages(mm, entry->file, entry->tag, entry->page_table, batch, count, false);
+}
+
+static uint32_t mm_dirty_percent(memory_manager_t *mm)
+{
+    if (mm->frame_table.frame_count == 0)
+        return 0;
+    return mm_dirty_frame_count(mm) * 100 / mm->frame_table.frame_count;
+}
+
+static void *mm_flusher_thread(void *arg)
+{
+    memory_manager_t *mm = (memory_manager_t *)arg;
+
+    pthread_mutex_lock(&mm->lock);
+    while (mm->flusher_running)
     {
-        pt->entries[page_number].use_bit = true;
-        return;
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += mm->flusher_interval_ms / 1000;
+        deadline.tv_nsec += (long)(mm->flusher_interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&mm->flusher_cond, &mm->lock, &deadline);
+
+        if (!mm->flusher_running || mm->storage_socket == -1 || mm_dirty_percent(mm) < mm->flusher_high)
+            continue;
+
+        // De a una tanda por vez, soltando el lock entre tandas para no frenar al ejecutor
+        while (mm->flusher_running && mm_dirty_percent(mm) > mm->flusher_low)
+        {
+            if (mm_write_back_lru_batch(mm) <= 0)
+                break;
+
+            pthread_mutex_unlock(&mm->lock);
+            sched_yield();
+            pthread_mutex_lock(&mm->lock);
+        }
     }
+    pthread_mutex_unlock(&mm->lock);
+
+    return NULL;
 }
 
-int mm_find_lru_victim(memory_manager_t *mm)
+int mm_start_flusher(memory_manager_t *mm, uint32_t high_percent, uint32_t low_percent, uint32_t interval_ms)
 {
-    if (!mm)
+    if (!mm || mm->flusher_running || high_percent == 0 || high_percent > 100 ||
+        low_percent >= high_percent || interval_ms == 0)
         return -1;
 
-    t_log *logger = logger_get();
+    mm->flusher_high = high_percent;
+    mm->flusher_low = low_percent;
+    mm->flusher_interval_ms = interval_ms;
+    mm->flusher_running = true;
 
-    if (mm->count == 0)
+    if (pthread_create(&mm->flusher_thread, NULL, mm_flusher_thread, mm) != 0)
     {
-        if (logger)
-        {
-            log_error(logger, "Query %d: LRU - No hay tablas de páginas (mm->count = 0)",
-                     mm->query_id);
-        }
+        mm->flusher_running = false;
         return -1;
     }
+    return 0;
+}
 
-    uint64_t oldest_time = UINT64_MAX;
-    uint32_t victim_frame = (uint32_t)-1;
-    char *victim_file = NULL;
-    char *victim_tag = NULL;
-    uint32_t victim_page = UINT32_MAX;
-    page_table_t *victim_pt = NULL;
+void mm_stop_flusher(memory_manager_t *mm)
+{
+    if (!mm)
+        return;
 
-    uint32_t total_pages_checked = 0;
-    uint32_t present_pages = 0;
+    pthread_mutex_lock(&mm->lock);
+    bool running = mm->flusher_running;
+    mm->flusher_running = false;
+    pthread_cond_signal(&mm->flusher_cond);
+    pthread_mutex_unlock(&mm->lock);
 
-    for (uint32_t i = 0; i < mm->count; i++)
-    {
-        file_tag_entry_t *entry = &mm->entries[i];
-        page_table_t *pt = entry->page_table;
+    if (running)
+        pthread_join(mm->flusher_thread, NULL);
+}
 
-        for (uint32_t j = 0; j < pt->page_count; j++)
-        {
-            pt_entry_t *page_entry = &pt->entries[j];
-            total_pages_checked++;
-            
-            if (page_entry->present)
-            {
-                present_pages++;
-                if (page_entry->last_access_time < oldest_time)
-                {
-                    oldest_time = page_entry->last_access_time;
-                    victim_frame = page_entry->frame;
-                    victim_file = entry->file;
-                    victim_tag = entry->tag;
-                    victim_page = j;
-                    victim_pt = pt;
-                }
-            }
-        }
-    }
+void mm_update_page_access(memory_manager_t *mm, page_table_t *pt, uint32_t page_number)
+{
+    if (!mm || !pt)
+        return;
 
-    if (logger)
+    if (page_number >= pt->page_count)
+        return;
+
+    pt_entry_t *entry = pt_find_entry(pt, page_number);
+    if (!entry || !entry->present)
+        return;
+
+    // Pasa al final de la lista de recencia
+    if (mm->frame_table.lru_tail != entry->frame)
     {
-        log_info(logger, "## Query %d: LRU - Páginas revisadas: %u, Presentes: %u, Víctima encontrada: %s",
-                 mm->query_id, total_pages_checked, present_pages, 
-                 victim_frame != (uint32_t)-1 ? "Sí" : "No");
+        lru_unlink(&mm->frame_table, entry->frame);
+        lru_push_mru(&mm->frame_table, entry->frame);
     }
 
-    if (victim_frame == UINT32_MAX)
+    if (mm->policy_ops->on_access)
+        mm->policy_ops->on_access(mm, entry->frame);
+}
+
+/**
+ * Desaloja la página que ocupa el marco elegido por la política: si está sucia
+ * la escribe en Storage y después libera el marco. Retorna el marco o -1 si
+ * no se pudo escribir la página.
+ */
+static int mm_evict_frame(memory_manager_t *mm, uint32_t victim_frame)
+{
+    t_log *logger = logger_get();
+    file_tag_entry_t *victim_entry = NULL;
+    page_table_t *victim_pt = NULL;
+    uint32_t victim_page = UINT32_MAX;
+
+    if (!mm_find_page_for_frame(mm, victim_frame, &victim_entry, &victim_pt, &victim_page))
     {
         if (logger)
         {
-            log_error(logger, "Query %d: LRU no encontró ninguna página presente para reemplazar",
-                     mm->query_id);
+            log_error(logger, "Query %d: %s eligió el Marco %u, que no tiene página para reemplazar",
+                     mm->query_id, mm->policy_ops->name, victim_frame);
         }
         return -1;
     }
 
+    char *victim_file = victim_entry->file;
+    char *victim_tag = victim_entry->tag;
+
     if (logger)
     {
         log_info(logger,
@@ -827,7 +1417,7 @@ int mm_find_lru_victim(memory_manager_t *mm)
                  mm->query_id, victim_frame, victim_file, victim_tag);
     }
 
-    if (victim_pt && victim_pt->entries[victim_page].dirty)
+    if (pt_is_dirty(victim_pt, victim_page))
     {
         if (logger)
         {
@@ -838,7 +1428,7 @@ int mm_find_lru_victim(memory_manager_t *mm)
 
         void *frame_addr = mm_get_frame_address(mm, victim_frame);
 
-            int write_result = write_block_to_storage(
+        int write_result = write_block_to_storage(
             mm->storage_socket, mm->master_socket,
             victim_file,
             victim_tag,
@@ -868,193 +1458,57 @@ int mm_find_lru_victim(memory_manager_t *mm)
         }
     }
 
-    if (victim_pt)
-    {
-        pt_unmap(victim_pt, victim_page);
-    }
-
-    mm->frame_table.frames[victim_frame].used = false;
+    mm_release_frame(mm, victim_frame, true);
+    mm->evictions++;
 
     mm->last_victim_file = victim_file;
     mm->last_victim_tag = victim_tag;
     mm->last_victim_page = victim_page;
     mm->last_victim_valid = true;
 
-    return victim_frame;
+    return (int)victim_frame;
 }
 
-int mm_find_clockm_victim(memory_manager_t *mm)
+int mm_find_lru_victim(memory_manager_t *mm)
 {
-    if (!mm || mm->policy != CLOCK_M)
+    if (!mm)
         return -1;
 
-    uint32_t frame_count = mm->frame_table.frame_count;
     t_log *logger = logger_get();
 
-    if (frame_count == 0)
-        return -1;
-
-    while (1)
+    if (mm->count == 0)
     {
-
-        /* -------------- PASADA 1: buscar (U=0, M=0) -------------- */
-        for (uint32_t k = 0; k < frame_count; k++)
+        if (logger)
         {
-
-            uint32_t idx = mm->frame_table.clock_pointer;
-
-            // si el marco está libre, avanzar
-            if (!mm->frame_table.frames[idx].used)
-            {
-                mm->frame_table.clock_pointer = (idx + 1) % frame_count;
-                continue;
-            }
-
-            file_tag_entry_t *entry = NULL;
-            page_table_t *pt = NULL;
-            uint32_t page_idx = 0;
-
-            bool found = mm_find_page_for_frame(mm, idx, &entry, &pt, &page_idx);
-            if (!found)
-            {
-                mm->frame_table.clock_pointer = (idx + 1) % frame_count;
-                continue;
-            }
-
-            pt_entry_t *page = &pt->entries[page_idx];
-
-            // condición ideal de la 1ra pasada
-            if (page->use_bit == false && page->dirty == false)
-            {
-
-                // desmapear y liberar marco
-                pt_unmap(pt, page_idx);
-                mm->frame_table.frames[idx].used = false;
-
-                if (logger)
-                {
-                    log_info(logger,
-                             "Query %d: Se libera el Marco: %d perteneciente al File: %s Tag: %s",
-                             mm->query_id, idx, entry->file, entry->tag);
-                }
-
-                mm->last_victim_file = entry->file;
-                mm->last_victim_tag = entry->tag;
-                mm->last_victim_page = page_idx;
-                mm->last_victim_valid = true;
-
-                mm->frame_table.clock_pointer = (idx + 1) % frame_count;
-                return (int)idx;
-            }
-
-            mm->frame_table.clock_pointer = (idx + 1) % frame_count;
+            log_error(logger, "Query %d: LRU - No hay tablas de páginas (mm->count = 0)",
+                     mm->query_id);
         }
+        return -1;
+    }
 
-        /* -------------- PASADA 2: buscar (U=0, M=1) y limpiar U=1 -------------- */
-        int dirty_candidate_frame = -1;
-        file_tag_entry_t *dirty_entry = NULL;
-        page_table_t *dirty_pt = NULL;
-        uint32_t dirty_page_idx = 0;
-
-        for (uint32_t k = 0; k < frame_count; k++)
+    // La víctima es la cabeza de la lista de recencia: no hace falta recorrer las tablas de páginas
+    int victim_frame = mm_policy_get(LRU)->choose_victim(mm);
+    if (victim_frame == -1)
+    {
+        if (logger)
         {
-
-            uint32_t idx = mm->frame_table.clock_pointer;
-
-            if (!mm->frame_table.frames[idx].used)
-            {
-                mm->frame_table.clock_pointer = (idx + 1) % frame_count;
-                continue;
-            }
-
-            file_tag_entry_t *entry = NULL;
-            page_table_t *pt = NULL;
-            uint32_t page_idx = 0;
-
-            bool found = mm_find_page_for_frame(mm, idx, &entry, &pt, &page_idx);
-            if (!found)
-            {
-                mm->frame_table.clock_pointer = (idx + 1) % frame_count;
-                continue;
-            }
-
-            pt_entry_t *page = &pt->entries[page_idx];
-
-            // buscamos el primero con U=0 y M=1
-            if (page->use_bit == false && page->dirty == true && dirty_candidate_frame == -1)
-            {
-                dirty_candidate_frame = idx;
-                dirty_entry = entry;
-                dirty_pt = pt;
-                dirty_page_idx = page_idx;
-            }
-
-            // en la segunda pasada, SI vemos U=1 lo limpiamos
-            if (page->use_bit == true)
-            {
-                page->use_bit = false;
-            }
-
-            mm->frame_table.clock_pointer = (idx + 1) % frame_count;
+            log_error(logger, "Query %d: LRU no encontró ninguna página presente para reemplazar",
+                     mm->query_id);
         }
+        return -1;
+    }
 
-        // si en la segunda pasada encontramos uno modificado con U=0, lo usamos
-        if (dirty_candidate_frame != -1)
-        {
-
-            void *frame_addr = mm_get_frame_address(mm, dirty_candidate_frame);
-
-            int write_result = write_block_to_storage(
-                mm->storage_socket, mm->master_socket,
-                dirty_entry->file,
-                dirty_entry->tag,
-                dirty_page_idx,
-                frame_addr,
-                mm->page_size,
-                mm->query_id);
-
-            if (write_result != 0)
-            {
-                if (logger)
-                {
-                    log_error(logger,
-                              "## Query %d: Error al escribir página sucia en Storage - File: %s - Tag: %s - Pagina: %d",
-                              mm->query_id, dirty_entry->file, dirty_entry->tag, dirty_page_idx);
-                }
-                return -1;
-            }
-            else
-            {
-                if (logger)
-                {
-                    log_info(logger,
-                             "## Query %d: Página sucia escrita en Storage - File: %s - Tag: %s - Pagina: %d",
-                             mm->query_id, dirty_entry->file, dirty_entry->tag, dirty_page_idx);
-                }
-            }
-
-            pt_unmap(dirty_pt, dirty_page_idx);
-            mm->frame_table.frames[dirty_candidate_frame].used = false;
-
-            if (logger)
-            {
-                log_info(logger,
-                         "Query %d: Se libera el Marco: %d perteneciente al File: %s Tag: %s",
-                         mm->query_id,
-                         dirty_candidate_frame,
-                         dirty_entry->file,
-                         dirty_entry->tag);
-            }
+    return mm_evict_frame(mm, (uint32_t)victim_frame);
+}
 
-            mm->last_victim_file = dirty_entry->file;
-            mm->last_victim_tag = dirty_entry->tag;
-            mm->last_victim_page = dirty_page_idx;
-            mm->last_victim_valid = true;
+int mm_find_clockm_victim(memory_manager_t *mm)
+{
+    if (!mm || mm->policy != CLOCK_M)
+        return -1;
 
-            mm->frame_table.clock_pointer = (dirty_candidate_frame + 1) % frame_count;
-            return dirty_candidate_frame;
-        }
-    }
+    int victim_frame = mm->policy_ops->choose_victim(mm);
+    if (victim_frame == -1)
+        return -1;
 
-    return -1;
+    return mm_evict_frame(mm, (uint32_t)victim_frame);
 }
@@ -2,21 +2,45 @@
 #define MEMORY_MANAGER_H
 
 #include "page_table.h"
+#include <pthread.h>
+#include <time.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <commons/collections/dictionary.h>
+
+// Cantidad máxima de File:Tags que se informan al Master para planificar por afinidad
+#define MM_SUMMARY_MAX_FILE_TAGS 16
 
 typedef enum
 {
     CLOCK_M,
-    LRU
+    LRU,
+    TWO_Q,
+    ARC
 } pt_replacement_t;
 
+// Operaciones de cada política, ver replacement_policy.h
+typedef struct mm_policy_ops mm_policy_ops_t;
+
+// Marca de "sin marco" / "sin dueño" en la tabla invertida y la lista LRU
+#define MM_NO_FRAME UINT32_MAX
+
 typedef struct
 {
     bool used;
+    // Tabla invertida: qué página ocupa el marco (owner == MM_NO_FRAME si no está mapeado)
+    uint32_t owner;     // Índice en mm->entries del File:Tag dueño
+    uint32_t page;      // Número de página dentro de ese File:Tag
+    // Lista de recencia intrusiva entre marcos mapeados, de menos a más recientemente usado
+    uint32_t lru_prev;
+    uint32_t lru_next;
+    uint32_t free_slot; // Posición en free_stack, o MM_NO_FRAME si el marco está en uso
+    // Entrada de la página mapeada: la hoja no se mueve ni se libera mientras la página
+    // esté presente, así los recorridos de marcos no pasan por la tabla de páginas
+    pt_entry_t *entry;
 } frame_t;
 
 typedef struct
@@ -24,6 +48,10 @@ typedef struct
     frame_t *frames;
     uint32_t frame_count;
     uint32_t clock_pointer;  // Para el algoritmo CLOCK
+    uint32_t lru_head;       // Marco menos recientemente usado (víctima de LRU, lo usa el flusher)
+    uint32_t lru_tail;       // Marco más recientemente usado
+    uint32_t *free_stack;    // Marcos libres; se asigna desde el tope en O(1)
+    uint32_t free_count;
 } frame_table_t;
 
 typedef struct
@@ -38,10 +66,16 @@ typedef struct
     file_tag_entry_t *entries;
     uint32_t count;
     uint32_t capacity;
+    t_dictionary *directory; // "FILE:TAG" -> índice en entries + 1 (NULL si no existe)
     size_t page_size;
     pt_replacement_t policy;
+    const mm_policy_ops_t *policy_ops;
+    void *policy_state;      // Estado propio de la política (colas de 2Q/ARC)
     void *physical_memory;
     int memory_retardation;
+    bool memory_delay_pending;      // La instrucción en curso ya accedió a memoria
+    struct timespec memory_deadline; // Fin del retardo simulado de esa instrucción (CLOCK_REALTIME)
+    uint32_t read_ahead_pages; // Páginas extra a pedir cuando el acceso es secuencial
     int storage_socket;
     int worker_id;
     int query_id;
@@ -52,6 +86,24 @@ typedef struct
     uint32_t last_victim_page;
     bool last_victim_valid;
 
+    // Estadísticas de la política de reemplazo (ver mm_policy_log_stats)
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t ghost_hits;     // Fallos sobre páginas recordadas en una lista fantasma
+
+    // Recursivo: el ejecutor lo toma durante cada instrucción, así el flusher
+    // sólo usa el socket de Storage cuando no hay una instrucción en curso
+    pthread_mutex_t lock;
+
+    // Escritura de páginas sucias en segundo plano (ver mm_start_flusher)
+    pthread_t flusher_thread;
+    pthread_cond_t flusher_cond;
+    bool flusher_running;
+    uint32_t flusher_high;        // % de marcos sucios a partir del cual se empieza a escribir
+    uint32_t flusher_low;         // % de marcos sucios hasta el que se escribe
+    uint32_t flusher_interval_ms; // Cada cuánto se revisa la cantidad de marcos sucios
+
 } memory_manager_t;
 
 memory_manager_t *mm_create(size_t memory_size, size_t page_size, pt_replacement_t policy, int retardation_ms);
@@ -60,6 +112,28 @@ void mm_set_storage_connection(memory_manager_t *mm, int storage_socket, int wor
 void mm_set_master_connection(memory_manager_t *mm, int master_socket);
 void mm_set_query_id(memory_manager_t *mm, int query_id);
 
+/**
+ * Retardo de memoria de la instrucción en curso. mm_access_memory no duerme:
+ * el primer acceso de la instrucción fija un plazo de RETARDO_MEMORIA y el
+ * ejecutor lo espera después, sin el lock, pudiendo cortarlo un desalojo.
+ * @return true y el plazo en *deadline si hubo accesos desde la última llamada.
+ */
+bool mm_take_memory_deadline(memory_manager_t *mm, struct timespec *deadline);
+void mm_set_read_ahead(memory_manager_t *mm, uint32_t pages);
+
+void mm_lock(memory_manager_t *mm);
+void mm_unlock(memory_manager_t *mm);
+
+/**
+ * Inicia el hilo que escribe en Storage las páginas sucias menos usadas cuando
+ * superan high_percent de los marcos, hasta bajar a low_percent. Así un
+ * desalojo o un reemplazo suelen encontrar páginas ya limpias.
+ * @return 0 si se inició, -1 si los parámetros son inválidos o falla el hilo.
+ */
+int mm_start_flusher(memory_manager_t *mm, uint32_t high_percent, uint32_t low_percent, uint32_t interval_ms);
+void mm_stop_flusher(memory_manager_t *mm);
+uint32_t mm_dirty_frame_count(memory_manager_t *mm);
+
 page_table_t *mm_find_page_table(memory_manager_t *mm, char *file, char *tag);
 page_table_t *mm_create_page_table(memory_manager_t *mm, char *file, char *tag);
 void mm_remove_page_table(memory_manager_t *mm, char *file, char *tag);
@@ -69,21 +143,23 @@ int mm_write_to_memory(memory_manager_t *mm, page_table_t *pt, char *file, char
 int mm_read_from_memory(memory_manager_t *mm, page_table_t *pt, char *file, char *tag, uint32_t base_address, size_t size, void *out_buffer);
 
 int mm_allocate_frame(memory_manager_t *mm);
+int mm_map_page(memory_manager_t *mm, page_table_t *pt, uint32_t page_number, uint32_t frame);
 int mm_free_frame(memory_manager_t *mm, uint32_t frame);
 void *mm_get_frame_address(memory_manager_t *mm, uint32_t frame);
 
-pt_entry_t *mm_get_dirty_pages(memory_manager_t *mm, char *file, char *tag, size_t *count);
+pt_dirty_page_t *mm_get_dirty_pages(memory_manager_t *mm, char *file, char *tag, size_t *count);
 bool mm_has_page_table(memory_manager_t *mm, char *file, char *tag);
+uint32_t mm_resident_file_tags(memory_manager_t *mm, file_tag_entry_t **out, uint32_t max);
 void mm_mark_all_clean(memory_manager_t *mm, char *file, char *tag);
 int mm_flush_query(memory_manager_t *mm, char *file, char *tag);
 int mm_flush_all_dirty(memory_manager_t *mm);
 int mm_handle_page_fault(memory_manager_t *mm, page_table_t *pt, char *file, char *tag, uint32_t page_number);
 
-int mm_find_lru_victim(memory_manager_t *mm);
+// Nueva referencia a una página presente: la informa a la política de reemplazo
 void mm_update_page_access(memory_manager_t *mm, page_table_t *pt, uint32_t page_number);
 
 int mm_find_lru_victim(memory_manager_t *mm);
-int mm_find_clockm_victim(memory_manager_t *mm);   
+int mm_find_clockm_victim(memory_manager_t *mm);
 bool mm_find_page_for_frame(memory_manager_t *mm, uint32_t frame_idx, file_tag_entry_t **out_entry, page_table_t **out_pt, uint32_t *out_page_idx );
 
 #endif
@@ -1,10 +1,105 @@
 #include "page_table.h"
 
-static pt_entry_t *pt_get_entry(page_table_t *pt, uint32_t page_number)
+static uint32_t pt_leaves_for(uint32_t page_count)
 {
-    if (!pt || page_number >= pt->page_count)
+    return (page_count + PT_LEAF_MASK) >> PT_LEAF_BITS;
+}
+
+static pt_leaf_t *pt_leaf_create(page_table_t *pt, uint32_t index)
+{
+    pt_leaf_t *leaf = calloc(1, sizeof(pt_leaf_t));
+    if (!leaf)
         return NULL;
-    return &pt->entries[page_number];
+
+    leaf->base = index << PT_LEAF_BITS;
+    pt->leaves[index] = leaf;
+    return leaf;
+}
+
+static void pt_dirty_link(page_table_t *pt, pt_leaf_t *leaf)
+{
+    leaf->dirty_prev = NULL;
+    leaf->dirty_next = pt->dirty_leaves;
+    if (pt->dirty_leaves)
+        pt->dirty_leaves->dirty_prev = leaf;
+    pt->dirty_leaves = leaf;
+}
+
+static void pt_dirty_unlink(page_table_t *pt, pt_leaf_t *leaf)
+{
+    if (leaf->dirty_prev)
+        leaf->dirty_prev->dirty_next = leaf->dirty_next;
+    else
+        pt->dirty_leaves = leaf->dirty_next;
+    if (leaf->dirty_next)
+        leaf->dirty_next->dirty_prev = leaf->dirty_prev;
+    leaf->dirty_prev = NULL;
+    leaf->dirty_next = NULL;
+}
+
+// Actualiza present/dirty de la entrada junto con las máscaras, los contadores y el índice de sucias
+static void pt_set_flags(page_table_t *pt, pt_leaf_t *leaf, uint32_t slot, bool present, bool dirty)
+{
+    pt_entry_t *entry = &leaf->entries[slot];
+    uint64_t bit = 1ULL << slot;
+
+    if (entry->present != present)
+    {
+        entry->present = present;
+        leaf->present_mask ^= bit;
+        if (present)
+            pt->present_count++;
+        else
+            pt->present_count--;
+    }
+
+    if (entry->dirty != dirty)
+    {
+        entry->dirty = dirty;
+        if (dirty)
+        {
+            if (leaf->dirty_mask == 0)
+                pt_dirty_link(pt, leaf);
+            leaf->dirty_mask |= bit;
+            pt->dirty_count++;
+        }
+        else
+        {
+            leaf->dirty_mask &= ~bit;
+            if (leaf->dirty_mask == 0)
+                pt_dirty_unlink(pt, leaf);
+            pt->dirty_count--;
+        }
+    }
+}
+
+// Libera la hoja si ya no tiene páginas presentes ni sucias
+static void pt_leaf_release_if_empty(page_table_t *pt, pt_leaf_t *leaf)
+{
+    if ((leaf->present_mask | leaf->dirty_mask) != 0)
+        return;
+
+    pt->leaves[leaf->base >> PT_LEAF_BITS] = NULL;
+    free(leaf);
+}
+
+// Deja sin páginas el rango [from_page, page_count) y libera las hojas que quedan vacías
+static void pt_clear_from(page_table_t *pt, uint32_t from_page)
+{
+    for (uint32_t index = from_page >> PT_LEAF_BITS; index < pt->leaf_count; index++)
+    {
+        pt_leaf_t *leaf = pt->leaves[index];
+        if (!leaf)
+            continue;
+
+        uint32_t first = (index == (from_page >> PT_LEAF_BITS)) ? (from_page & PT_LEAF_MASK) : 0;
+        for (uint32_t slot = first; slot < PT_LEAF_SIZE; slot++)
+        {
+            pt_set_flags(pt, leaf, slot, false, false);
+            leaf->entries[slot] = (pt_entry_t){ 0 };
+        }
+        pt_leaf_release_if_empty(pt, leaf);
+    }
 }
 
 page_table_t *pt_create(uint32_t page_count, size_t page_size)
@@ -12,12 +107,13 @@ page_table_t *pt_create(uint32_t page_count, size_t page_size)
     if (page_count == 0 || page_size == 0)
         return NULL;
 
-    page_table_t *pt = malloc(sizeof(page_table_t));
+    page_table_t *pt = calloc(1, sizeof(page_table_t));
     if (!pt)
         return NULL;
 
-    pt->entries = calloc(page_count, sizeof(pt_entry_t));
-    if (!pt->entries)
+    pt->leaf_count = pt_leaves_for(page_count);
+    pt->leaves = calloc(pt->leaf_count, sizeof(pt_leaf_t *));
+    if (!pt->leaves)
     {
         free(pt);
         return NULL;
@@ -25,12 +121,8 @@ page_table_t *pt_create(uint32_t page_count, size_t page_size)
 
     pt->page_count = page_count;
     pt->page_size = page_size;
-
-    for (uint32_t i = 0; i < page_count; i++)
-    {
-        pt->entries[i].page_number = i;
-        pt->entries[i].last_access_time = 0;
-    }
+    pt->sequential_next = 0;
+    pt->owner_index = UINT32_MAX;
 
     return pt;
 }
@@ -39,7 +131,9 @@ void pt_destroy(page_table_t *pt)
 {
     if (!pt)
         return;
-    free(pt->entries);
+    for (uint32_t i = 0; i < pt->leaf_count; i++)
+        free(pt->leaves[i]);
+    free(pt->leaves);
     free(pt);
 }
 
@@ -51,88 +145,157 @@ int pt_resize(page_table_t *pt, uint32_t new_page_count)
     if (new_page_count == pt->page_count)
         return 0;
 
-    pt_entry_t *new_entries = realloc(pt->entries, new_page_count * sizeof(pt_entry_t));
-    if (!new_entries)
-        return -1;
+    uint32_t new_leaf_count = pt_leaves_for(new_page_count);
+    if (new_page_count < pt->page_count)
+        pt_clear_from(pt, new_page_count);
 
-    if (new_page_count > pt->page_count)
+    if (new_leaf_count != pt->leaf_count)
     {
-        for (uint32_t i = pt->page_count; i < new_page_count; i++)
+        pt_leaf_t **new_leaves = realloc(pt->leaves, new_leaf_count * sizeof(pt_leaf_t *));
+        if (!new_leaves)
+        {
+            // Al achicar alcanza con el directorio anterior, que sobra
+            if (new_leaf_count > pt->leaf_count)
+                return -1;
+        }
+        else
         {
-            new_entries[i].page_number = i;
-            new_entries[i].frame = 0;
-            new_entries[i].dirty = false;
-            new_entries[i].present = false;
-            new_entries[i].last_access_time = 0;
-            new_entries[i].use_bit = false;
+            for (uint32_t i = pt->leaf_count; i < new_leaf_count; i++)
+                new_leaves[i] = NULL;
+            pt->leaves = new_leaves;
+            pt->leaf_count = new_leaf_count;
         }
     }
 
-    pt->entries = new_entries;
     pt->page_count = new_page_count;
     return 0;
 }
 
+pt_entry_t *pt_find_entry(page_table_t *pt, uint32_t page_number)
+{
+    if (!pt || page_number >= pt->page_count)
+        return NULL;
+
+    pt_leaf_t *leaf = pt->leaves[page_number >> PT_LEAF_BITS];
+    return leaf ? &leaf->entries[page_number & PT_LEAF_MASK] : NULL;
+}
+
+pt_entry_t *pt_get_entry(page_table_t *pt, uint32_t page_number)
+{
+    if (!pt || page_number >= pt->page_count)
+        return NULL;
+
+    uint32_t index = page_number >> PT_LEAF_BITS;
+    pt_leaf_t *leaf = pt->leaves[index] ? pt->leaves[index] : pt_leaf_create(pt, index);
+    return leaf ? &leaf->entries[page_number & PT_LEAF_MASK] : NULL;
+}
+
+bool pt_is_present(page_table_t *pt, uint32_t page_number)
+{
+    pt_entry_t *entry = pt_find_entry(pt, page_number);
+    return entry && entry->present;
+}
+
+bool pt_is_dirty(page_table_t *pt, uint32_t page_number)
+{
+    pt_entry_t *entry = pt_find_entry(pt, page_number);
+    return entry && entry->dirty;
+}
+
 int pt_map(page_table_t *page_table, uint32_t page_number, uint32_t frame)
 {
+    if (frame >= PT_MAX_FRAMES)
+        return -1;
+
     pt_entry_t *entry = pt_get_entry(page_table, page_number);
     if (!entry)
         return -1;
 
     entry->frame = frame;
-    entry->present = true;
-    entry->dirty = false;
+    pt_set_flags(page_table, page_table->leaves[page_number >> PT_LEAF_BITS],
+                 page_number & PT_LEAF_MASK, true, false);
     return 0;
 }
 
 int pt_unmap(page_table_t *pt, uint32_t page_number)
 {
-    pt_entry_t *entry = pt_get_entry(pt, page_number);
-    if (!entry)
+    if (!pt || page_number >= pt->page_count)
         return -1;
 
-    entry->frame = 0;
-    entry->present = false;
-    entry->dirty = false;
+    pt_leaf_t *leaf = pt->leaves[page_number >> PT_LEAF_BITS];
+    if (!leaf)
+        return 0;
+
+    leaf->entries[page_number & PT_LEAF_MASK].frame = 0;
+    pt_set_flags(pt, leaf, page_number & PT_LEAF_MASK, false, false);
+    pt_leaf_release_if_empty(pt, leaf);
     return 0;
 }
 
 void pt_set_dirty(page_table_t *pt, uint32_t page_number, bool dirty)
 {
-    pt_entry_t *entry = pt_get_entry(pt, page_number);
-    if (entry)
-        entry->dirty = dirty;
+    pt_entry_t *entry = dirty ? pt_get_entry(pt, page_number) : pt_find_entry(pt, page_number);
+    if (!entry)
+        return;
+
+    pt_leaf_t *leaf = pt->leaves[page_number >> PT_LEAF_BITS];
+    pt_set_flags(pt, leaf, page_number & PT_LEAF_MASK, entry->present, dirty);
+    pt_leaf_release_if_empty(pt, leaf);
 }
 
 void pt_set_present(page_table_t *pt, uint32_t page_number, bool present)
 {
-    pt_entry_t *entry = pt_get_entry(pt, page_number);
-    if (entry)
-        entry->present = present;
+    pt_entry_t *entry = present ? pt_get_entry(pt, page_number) : pt_find_entry(pt, page_number);
+    if (!entry)
+        return;
+
+    pt_leaf_t *leaf = pt->leaves[page_number >> PT_LEAF_BITS];
+    pt_set_flags(pt, leaf, page_number & PT_LEAF_MASK, present, entry->dirty);
+    pt_leaf_release_if_empty(pt, leaf);
 }
 
-void pt_update_access_time(page_table_t *pt, uint32_t page_number, uint64_t timestamp)
+pt_entry_t *pt_next_present(page_table_t *pt, uint32_t *page_number)
 {
-    pt_entry_t *entry = pt_get_entry(pt, page_number);
-    if (entry)
-        entry->last_access_time = timestamp;
+    if (!pt || !page_number || pt->present_count == 0)
+        return NULL;
+
+    uint32_t first_index = *page_number >> PT_LEAF_BITS;
+    for (uint32_t index = first_index; index < pt->leaf_count; index++)
+    {
+        pt_leaf_t *leaf = pt->leaves[index];
+        if (!leaf)
+            continue;
+
+        uint64_t mask = leaf->present_mask;
+        if (index == first_index)
+            mask &= ~0ULL << (*page_number & PT_LEAF_MASK);
+        if (mask == 0)
+            continue;
+
+        uint32_t slot = (uint32_t)__builtin_ctzll(mask);
+        *page_number = leaf->base + slot;
+        return &leaf->entries[slot];
+    }
+    return NULL;
 }
 
-pt_entry_t *pt_get_dirty_entries(page_table_t *pt, size_t *count)
+static int pt_compare_page_number(const void *a, const void *b)
+{
+    uint32_t left = ((const pt_dirty_page_t *)a)->page_number;
+    uint32_t right = ((const pt_dirty_page_t *)b)->page_number;
+    return (left > right) - (left < right);
+}
+
+pt_dirty_page_t *pt_get_dirty_entries(page_table_t *pt, size_t *count)
 {
     if (!pt || !count)
         return NULL;
 
-    size_t dirty_count = 0;
-    for (uint32_t i = 0; i < pt->page_count; i++)
-        if (pt->entries[i].dirty)
-            dirty_count++;
-
-    *count = dirty_count;
-    if (dirty_count == 0)
+    *count = pt->dirty_count;
+    if (pt->dirty_count == 0)
         return NULL;
 
-    pt_entry_t *dirty_entries = malloc(dirty_count * sizeof(pt_entry_t));
+    pt_dirty_page_t *dirty_entries = malloc(pt->dirty_count * sizeof(pt_dirty_page_t));
     if (!dirty_entries)
     {
         *count = 0;
@@ -140,9 +303,41 @@ pt_entry_t *pt_get_dirty_entries(page_table_t *pt, size_t *count)
     }
 
     size_t idx = 0;
-    for (uint32_t i = 0; i < pt->page_count; i++)
-        if (pt->entries[i].dirty)
-            dirty_entries[idx++] = pt->entries[i];
+    for (pt_leaf_t *leaf = pt->dirty_leaves; leaf; leaf = leaf->dirty_next)
+    {
+        for (uint64_t mask = leaf->dirty_mask; mask != 0; mask &= mask - 1)
+        {
+            uint32_t slot = (uint32_t)__builtin_ctzll(mask);
+            pt_entry_t *entry = &leaf->entries[slot];
+            dirty_entries[idx++] = (pt_dirty_page_t){
+                .page_number = leaf->base + slot,
+                .frame = entry->frame,
+                .present = entry->present,
+                .dirty = entry->dirty,
+            };
+        }
+    }
+
+    // Las hojas del índice no están ordenadas; dentro de cada hoja sí
+    if (pt->dirty_leaves && pt->dirty_leaves->dirty_next)
+        qsort(dirty_entries, idx, sizeof(pt_dirty_page_t), pt_compare_page_number);
 
     return dirty_entries;
 }
+
+void pt_clear_dirty(page_table_t *pt)
+{
+    if (!pt)
+        return;
+
+    while (pt->dirty_leaves)
+    {
+        pt_leaf_t *leaf = pt->dirty_leaves;
+        for (uint64_t mask = leaf->dirty_mask; mask != 0; mask &= mask - 1)
+        {
+            uint32_t slot = (uint32_t)__builtin_ctzll(mask);
+            pt_set_flags(pt, leaf, slot, leaf->entries[slot].present, false);
+        }
+        pt_leaf_release_if_empty(pt, leaf);
+    }
+}
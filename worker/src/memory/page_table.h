@@ -5,19 +5,60 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+/*
+ * Tabla de dos niveles: un directorio con un puntero por cada PT_LEAF_SIZE
+ * páginas y hojas con las entradas. Una hoja existe sólo mientras alguna de
+ * sus páginas está presente o sucia, así que escribir en una dirección alta
+ * no aloca entradas para las páginas intermedias.
+ */
+#define PT_LEAF_BITS 6
+#define PT_LEAF_SIZE (1u << PT_LEAF_BITS)
+#define PT_LEAF_MASK (PT_LEAF_SIZE - 1)
+
+/*
+ * Entrada empaquetada en una palabra: el número de página es la posición en
+ * la hoja y la recencia para LRU vive en la tabla de marcos, así un recorrido
+ * lee 16 entradas por línea de caché en lugar de 2.
+ */
+#define PT_FRAME_BITS 29
+#define PT_MAX_FRAMES (1u << PT_FRAME_BITS)
+
+typedef struct {
+    uint32_t frame : PT_FRAME_BITS;
+    uint32_t present : 1;
+    uint32_t dirty : 1;
+    uint32_t use_bit : 1;
+} pt_entry_t;
+
+_Static_assert(sizeof(pt_entry_t) == sizeof(uint32_t), "pt_entry_t debe ocupar 32 bits");
+
+// Copia de una página sucia, con su número (la entrada no lo guarda)
 typedef struct {
     uint32_t page_number;
     uint32_t frame;
-    bool dirty;
     bool present;
-    uint64_t last_access_time;
-    bool use_bit;
-} pt_entry_t;
+    bool dirty;
+} pt_dirty_page_t;
+
+typedef struct pt_leaf {
+    pt_entry_t entries[PT_LEAF_SIZE];
+    uint64_t present_mask;      // Bit i: entries[i] presente
+    uint64_t dirty_mask;        // Bit i: entries[i] sucia
+    uint32_t base;              // Número de la primera página de la hoja
+    struct pt_leaf *dirty_prev; // Lista de hojas con páginas sucias
+    struct pt_leaf *dirty_next;
+} pt_leaf_t;
 
 typedef struct {
-    pt_entry_t *entries;
+    pt_leaf_t **leaves;       // NULL donde ninguna página de la hoja está presente ni sucia
+    uint32_t leaf_count;
     uint32_t page_count;
     size_t page_size;
+    uint32_t sequential_next; // Página siguiente al último acceso, para detectar lecturas secuenciales
+    uint32_t present_count;
+    uint32_t dirty_count;
+    pt_leaf_t *dirty_leaves;  // Índice de páginas sucias: sólo se recorren estas hojas
+    uint32_t owner_index;     // Posición de su File:Tag en el memory manager (UINT32_MAX si no tiene)
 } page_table_t;
 
 page_table_t *pt_create(uint32_t page_count, size_t page_size);
@@ -30,8 +71,25 @@ int pt_unmap(page_table_t *page_table, uint32_t page_number);
 
 void pt_set_dirty(page_table_t *page_table, uint32_t page_number, bool dirty);
 void pt_set_present(page_table_t *page_table, uint32_t page_number, bool present);
-void pt_update_access_time(page_table_t *page_table, uint32_t page_number, uint64_t timestamp);
 
-pt_entry_t *pt_get_dirty_entries(page_table_t *page_table, size_t *count);
+// Entrada de la página, o NULL si está fuera de rango o su hoja no existe (no está presente ni sucia)
+pt_entry_t *pt_find_entry(page_table_t *page_table, uint32_t page_number);
+
+// Igual que pt_find_entry pero crea la hoja si hace falta; para modificar la entrada
+pt_entry_t *pt_get_entry(page_table_t *page_table, uint32_t page_number);
+
+bool pt_is_present(page_table_t *page_table, uint32_t page_number);
+bool pt_is_dirty(page_table_t *page_table, uint32_t page_number);
+
+/**
+ * Busca la primera página presente a partir de *page_number y la deja ahí.
+ * Saltea las hojas vacías sin mirar sus entradas.
+ * @return La entrada encontrada, o NULL si no hay más páginas presentes.
+ */
+pt_entry_t *pt_next_present(page_table_t *page_table, uint32_t *page_number);
+
+// Copia de las entradas sucias, de menor a mayor página; recorre sólo el índice de sucias
+pt_dirty_page_t *pt_get_dirty_entries(page_table_t *page_table, size_t *count);
+void pt_clear_dirty(page_table_t *page_table);
 
 #endif
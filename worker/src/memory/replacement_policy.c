@@ -0,0 +1,532 @@
+#include "replacement_policy.h"
+#include <utils/logger.h>
+#include <stdio.h>
+#include <strings.h>
+
+//--Helper--
+// Entrada de la página que ocupa el marco, o NULL si el marco está libre o sin mapear
+static pt_entry_t *policy_page_of(memory_manager_t *mm, uint32_t frame)
+{
+    return mm->frame_table.frames[frame].entry;
+}
+//--Helper--
+
+/* ---------------------------------- LRU ---------------------------------- */
+
+// La lista de recencia ya está ordenada: la víctima es su cabeza
+static int lru_choose_victim(memory_manager_t *mm)
+{
+    uint32_t head = mm->frame_table.lru_head;
+    return head == MM_NO_FRAME ? -1 : (int)head;
+}
+
+/* -------------------------------- CLOCK-M -------------------------------- */
+
+static void clockm_on_reference(memory_manager_t *mm, uint32_t frame)
+{
+    pt_entry_t *page = policy_page_of(mm, frame);
+    if (page)
+        page->use_bit = true;
+}
+
+static int clockm_choose_victim(memory_manager_t *mm)
+{
+    frame_table_t *ft = &mm->frame_table;
+    uint32_t frame_count = ft->frame_count;
+
+    if (frame_count == 0)
+        return -1;
+
+    // La pasada 2 deja todos los U en 0, así que la segunda vuelta siempre encuentra
+    // víctima si hay alguna página mapeada
+    for (int round = 0; round < 2; round++)
+    {
+        /* -------------- PASADA 1: buscar (U=0, M=0) -------------- */
+        for (uint32_t k = 0; k < frame_count; k++)
+        {
+            uint32_t idx = ft->clock_pointer;
+            ft->clock_pointer = (idx + 1) % frame_count;
+
+            // si el marco está libre o todavía no tiene página, avanzar
+            pt_entry_t *page = ft->frames[idx].entry;
+            if (page && !page->use_bit && !page->dirty)
+                return (int)idx;
+        }
+
+        /* -------------- PASADA 2: buscar (U=0, M=1) y limpiar U=1 -------------- */
+        int dirty_candidate_frame = -1;
+        for (uint32_t k = 0; k < frame_count; k++)
+        {
+            uint32_t idx = ft->clock_pointer;
+            ft->clock_pointer = (idx + 1) % frame_count;
+
+            pt_entry_t *page = ft->frames[idx].entry;
+            if (!page)
+                continue;
+
+            if (!page->use_bit && page->dirty && dirty_candidate_frame == -1)
+                dirty_candidate_frame = (int)idx;
+
+            page->use_bit = false;
+        }
+
+        if (dirty_candidate_frame != -1)
+        {
+            ft->clock_pointer = (dirty_candidate_frame + 1) % frame_count;
+            return dirty_candidate_frame;
+        }
+    }
+
+    return -1;
+}
+
+/* ------------------------- Colas de 2Q y ARC ------------------------- */
+
+/*
+ * 2Q y ARC reparten las páginas residentes en dos colas: la de páginas vistas
+ * una sola vez (2Q: A1in, ARC: T1) y la de páginas referenciadas de nuevo
+ * (2Q: Am, ARC: T2). Un recorrido secuencial sólo pasa por la primera, por lo
+ * que no desplaza a las páginas que se usan seguido.
+ *
+ * De las páginas desalojadas se recuerda sólo la clave (listas fantasma): si
+ * vuelven a pedirse al poco tiempo entran directamente a la cola frecuente.
+ */
+enum
+{
+    QUEUE_RECENT,
+    QUEUE_FREQUENT,
+    QUEUE_COUNT
+};
+
+#define QUEUE_NONE UINT8_MAX
+
+typedef struct
+{
+    uint32_t prev;
+    uint32_t next;
+    uint8_t queue; // QUEUE_NONE si el marco no está en ninguna cola
+} queue_link_t;
+
+typedef struct
+{
+    uint32_t head; // Menos recientemente usado
+    uint32_t tail;
+    uint32_t count;
+} frame_queue_t;
+
+typedef struct ghost_node
+{
+    char *key;
+    uint8_t list;
+    struct ghost_node *prev;
+    struct ghost_node *next;
+} ghost_node_t;
+
+typedef struct
+{
+    ghost_node_t *head; // Más antiguo
+    ghost_node_t *tail;
+    uint32_t count;
+} ghost_list_t;
+
+typedef struct
+{
+    queue_link_t *links; // Uno por marco
+    frame_queue_t queues[QUEUE_COUNT];
+    ghost_list_t ghosts[QUEUE_COUNT]; // 2Q sólo usa la de QUEUE_RECENT (A1out)
+    t_dictionary *ghost_index;        // "FILE:TAG/página" -> ghost_node_t
+    uint32_t target;                  // 2Q: máximo de A1in (Kin). ARC: tamaño objetivo de T1 (p)
+    uint32_t ghost_limit;             // 2Q: máximo de A1out (Kout)
+} queue_policy_t;
+
+static void queue_unlink(queue_policy_t *state, uint32_t frame)
+{
+    queue_link_t *link = &state->links[frame];
+    if (link->queue == QUEUE_NONE)
+        return;
+
+    frame_queue_t *queue = &state->queues[link->queue];
+    if (link->prev != MM_NO_FRAME)
+        state->links[link->prev].next = link->next;
+    else
+        queue->head = link->next;
+
+    if (link->next != MM_NO_FRAME)
+        state->links[link->next].prev = link->prev;
+    else
+        queue->tail = link->prev;
+
+    queue->count--;
+    link->prev = MM_NO_FRAME;
+    link->next = MM_NO_FRAME;
+    link->queue = QUEUE_NONE;
+}
+
+static void queue_push_mru(queue_policy_t *state, uint8_t queue_id, uint32_t frame)
+{
+    queue_unlink(state, frame);
+
+    frame_queue_t *queue = &state->queues[queue_id];
+    queue_link_t *link = &state->links[frame];
+    link->queue = queue_id;
+    link->prev = queue->tail;
+    link->next = MM_NO_FRAME;
+    if (queue->tail != MM_NO_FRAME)
+        state->links[queue->tail].next = frame;
+    else
+        queue->head = frame;
+    queue->tail = frame;
+    queue->count++;
+}
+
+// Clave de la página que ocupa el marco; el caller la libera
+static char *ghost_key(memory_manager_t *mm, uint32_t frame)
+{
+    file_tag_entry_t *entry = NULL;
+    uint32_t page = 0;
+    char *key = NULL;
+
+    if (!mm_find_page_for_frame(mm, frame, &entry, NULL, &page))
+        return NULL;
+    if (asprintf(&key, "%s:%s/%u", entry->file, entry->tag, page) == -1)
+        return NULL;
+    return key;
+}
+
+static void ghost_drop(queue_policy_t *state, ghost_node_t *node)
+{
+    ghost_list_t *list = &state->ghosts[node->list];
+
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        list->head = node->next;
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        list->tail = node->prev;
+    list->count--;
+
+    dictionary_remove(state->ghost_index, node->key);
+    free(node->key);
+    free(node);
+}
+
+static void ghost_drop_oldest(queue_policy_t *state, uint8_t list_id, uint32_t keep)
+{
+    while (state->ghosts[list_id].count > keep)
+        ghost_drop(state, state->ghosts[list_id].head);
+}
+
+// Recuerda la página del marco al final de la lista fantasma indicada
+static void ghost_remember(memory_manager_t *mm, queue_policy_t *state, uint32_t frame, uint8_t list_id)
+{
+    char *key = ghost_key(mm, frame);
+    if (!key)
+        return;
+
+    ghost_node_t *previous = dictionary_get(state->ghost_index, key);
+    if (previous)
+        ghost_drop(state, previous);
+
+    ghost_node_t *node = calloc(1, sizeof(ghost_node_t));
+    if (!node)
+    {
+        free(key);
+        return;
+    }
+
+    ghost_list_t *list = &state->ghosts[list_id];
+    node->key = key;
+    node->list = list_id;
+    node->prev = list->tail;
+    if (list->tail)
+        list->tail->next = node;
+    else
+        list->head = node;
+    list->tail = node;
+    list->count++;
+
+    dictionary_put(state->ghost_index, key, node);
+}
+
+// Busca la página del marco en las listas fantasma (NULL si no fue desalojada hace poco)
+static ghost_node_t *ghost_find(memory_manager_t *mm, queue_policy_t *state, uint32_t frame)
+{
+    if (dictionary_is_empty(state->ghost_index))
+        return NULL;
+
+    char *key = ghost_key(mm, frame);
+    if (!key)
+        return NULL;
+
+    ghost_node_t *node = dictionary_get(state->ghost_index, key);
+    free(key);
+    return node;
+}
+
+static int queue_policy_init(memory_manager_t *mm)
+{
+    uint32_t frame_count = mm->frame_table.frame_count;
+    queue_policy_t *state = calloc(1, sizeof(queue_policy_t));
+    if (!state)
+        return -1;
+
+    state->links = malloc(frame_count * sizeof(queue_link_t));
+    state->ghost_index = dictionary_create();
+    if (!state->links || !state->ghost_index)
+    {
+        free(state->links);
+        if (state->ghost_index)
+            dictionary_destroy(state->ghost_index);
+        free(state);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < frame_count; i++)
+    {
+        state->links[i].prev = MM_NO_FRAME;
+        state->links[i].next = MM_NO_FRAME;
+        state->links[i].queue = QUEUE_NONE;
+    }
+    for (int q = 0; q < QUEUE_COUNT; q++)
+    {
+        state->queues[q].head = MM_NO_FRAME;
+        state->queues[q].tail = MM_NO_FRAME;
+    }
+
+    mm->policy_state = state;
+    return 0;
+}
+
+static void queue_policy_destroy(memory_manager_t *mm)
+{
+    queue_policy_t *state = mm->policy_state;
+    if (!state)
+        return;
+
+    for (int q = 0; q < QUEUE_COUNT; q++)
+        ghost_drop_oldest(state, q, 0);
+
+    dictionary_destroy(state->ghost_index);
+    free(state->links);
+    free(state);
+    mm->policy_state = NULL;
+}
+
+// Víctima: cabeza de la cola de una sola referencia si se pasó de target, si no de la frecuente
+static int queue_policy_choose_victim(memory_manager_t *mm)
+{
+    queue_policy_t *state = mm->policy_state;
+    frame_queue_t *recent = &state->queues[QUEUE_RECENT];
+    frame_queue_t *frequent = &state->queues[QUEUE_FREQUENT];
+
+    if (recent->count > 0 && (recent->count > state->target || frequent->count == 0))
+        return (int)recent->head;
+    if (frequent->count > 0)
+        return (int)frequent->head;
+
+    // Páginas mapeadas fuera de las colas: se recurre a la lista de recencia
+    return lru_choose_victim(mm);
+}
+
+/* ----------------------------------- 2Q ---------------------------------- */
+
+static int twoq_init(memory_manager_t *mm)
+{
+    if (queue_policy_init(mm) != 0)
+        return -1;
+
+    // Valores sugeridos por Johnson y Shasha: A1in 25% de los marcos, A1out 50%
+    queue_policy_t *state = mm->policy_state;
+    uint32_t frame_count = mm->frame_table.frame_count;
+    state->target = frame_count / 4 > 0 ? frame_count / 4 : 1;
+    state->ghost_limit = frame_count / 2 > 0 ? frame_count / 2 : 1;
+    return 0;
+}
+
+static void twoq_on_insert(memory_manager_t *mm, uint32_t frame)
+{
+    queue_policy_t *state = mm->policy_state;
+    ghost_node_t *ghost = ghost_find(mm, state, frame);
+
+    if (ghost)
+    {
+        mm->ghost_hits++;
+        ghost_drop(state, ghost);
+        queue_push_mru(state, QUEUE_FREQUENT, frame);
+        return;
+    }
+    queue_push_mru(state, QUEUE_RECENT, frame);
+}
+
+static void twoq_on_access(memory_manager_t *mm, uint32_t frame)
+{
+    queue_policy_t *state = mm->policy_state;
+
+    // A1in es FIFO: las referencias seguidas de un mismo recorrido no promueven la página
+    if (state->links[frame].queue == QUEUE_FREQUENT)
+        queue_push_mru(state, QUEUE_FREQUENT, frame);
+}
+
+static void twoq_on_remove(memory_manager_t *mm, uint32_t frame, bool evicted)
+{
+    queue_policy_t *state = mm->policy_state;
+    uint8_t queue = state->links[frame].queue;
+
+    queue_unlink(state, frame);
+
+    // Sólo se recuerdan en A1out las páginas desalojadas de A1in
+    if (evicted && queue == QUEUE_RECENT)
+    {
+        ghost_remember(mm, state, frame, QUEUE_RECENT);
+        ghost_drop_oldest(state, QUEUE_RECENT, state->ghost_limit);
+    }
+}
+
+/* ---------------------------------- ARC ---------------------------------- */
+
+static void arc_on_insert(memory_manager_t *mm, uint32_t frame)
+{
+    queue_policy_t *state = mm->policy_state;
+    ghost_node_t *ghost = ghost_find(mm, state, frame);
+
+    if (!ghost)
+    {
+        queue_push_mru(state, QUEUE_RECENT, frame);
+        return;
+    }
+
+    // Un acierto en B1 indica que T1 quedó chica; uno en B2, que T2 quedó chica
+    uint32_t b1 = state->ghosts[QUEUE_RECENT].count;
+    uint32_t b2 = state->ghosts[QUEUE_FREQUENT].count;
+    uint32_t frame_count = mm->frame_table.frame_count;
+
+    if (ghost->list == QUEUE_RECENT)
+    {
+        uint32_t delta = (b1 >= b2) ? 1 : b2 / b1;
+        state->target = (state->target + delta < frame_count) ? state->target + delta : frame_count;
+    }
+    else
+    {
+        uint32_t delta = (b2 >= b1) ? 1 : b1 / b2;
+        state->target = (state->target > delta) ? state->target - delta : 0;
+    }
+
+    mm->ghost_hits++;
+    ghost_drop(state, ghost);
+    queue_push_mru(state, QUEUE_FREQUENT, frame);
+}
+
+static void arc_on_access(memory_manager_t *mm, uint32_t frame)
+{
+    queue_policy_t *state = mm->policy_state;
+
+    if (state->links[frame].queue != QUEUE_NONE)
+        queue_push_mru(state, QUEUE_FREQUENT, frame);
+}
+
+static void arc_on_remove(memory_manager_t *mm, uint32_t frame, bool evicted)
+{
+    queue_policy_t *state = mm->policy_state;
+    uint8_t queue = state->links[frame].queue;
+
+    queue_unlink(state, frame);
+    if (!evicted || queue == QUEUE_NONE)
+        return;
+
+    // T1 va a B1 y T2 a B2
+    ghost_remember(mm, state, frame, queue);
+
+    // Límites del directorio: |T1| + |B1| <= c y |T1| + |T2| + |B1| + |B2| <= 2c
+    uint32_t frame_count = mm->frame_table.frame_count;
+    uint32_t t1 = state->queues[QUEUE_RECENT].count;
+    uint32_t resident = t1 + state->queues[QUEUE_FREQUENT].count;
+    ghost_drop_oldest(state, QUEUE_RECENT, frame_count - t1);
+
+    uint32_t used = resident + state->ghosts[QUEUE_RECENT].count;
+    ghost_drop_oldest(state, QUEUE_FREQUENT, used < 2 * frame_count ? 2 * frame_count - used : 0);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static const mm_policy_ops_t lru_ops = {
+    .name = "LRU",
+    .choose_victim = lru_choose_victim,
+};
+
+static const mm_policy_ops_t clockm_ops = {
+    .name = "CLOCK-M",
+    .on_insert = clockm_on_reference,
+    .on_access = clockm_on_reference,
+    .choose_victim = clockm_choose_victim,
+};
+
+static const mm_policy_ops_t twoq_ops = {
+    .name = "2Q",
+    .init = twoq_init,
+    .destroy = queue_policy_destroy,
+    .on_insert = twoq_on_insert,
+    .on_access = twoq_on_access,
+    .choose_victim = queue_policy_choose_victim,
+    .on_remove = twoq_on_remove,
+};
+
+static const mm_policy_ops_t arc_ops = {
+    .name = "ARC",
+    .init = queue_policy_init,
+    .destroy = queue_policy_destroy,
+    .on_insert = arc_on_insert,
+    .on_access = arc_on_access,
+    .choose_victim = queue_policy_choose_victim,
+    .on_remove = arc_on_remove,
+};
+
+const mm_policy_ops_t *mm_policy_get(pt_replacement_t policy)
+{
+    switch (policy)
+    {
+    case LRU:
+        return &lru_ops;
+    case CLOCK_M:
+        return &clockm_ops;
+    case TWO_Q:
+        return &twoq_ops;
+    case ARC:
+        return &arc_ops;
+    }
+    return NULL;
+}
+
+bool mm_policy_from_name(const char *name, pt_replacement_t *out)
+{
+    if (!name || !out)
+        return false;
+
+    if (strcasecmp(name, "LRU") == 0)
+        *out = LRU;
+    else if (strcasecmp(name, "CLOCK_M") == 0 || strcasecmp(name, "CLOCK-M") == 0)
+        *out = CLOCK_M;
+    else if (strcasecmp(name, "2Q") == 0)
+        *out = TWO_Q;
+    else if (strcasecmp(name, "ARC") == 0)
+        *out = ARC;
+    else
+        return false;
+    return true;
+}
+
+void mm_policy_log_stats(memory_manager_t *mm)
+{
+    t_log *logger = logger_get();
+    if (!mm || !logger)
+        return;
+
+    uint64_t references = mm->hits + mm->misses;
+    double hit_ratio = references > 0 ? 100.0 * (double)mm->hits / (double)references : 0.0;
+
+    log_debug(logger,
+              "## Memoria - Política %s - hits: %lu - misses: %lu - hit ratio: %.2f%% - reemplazos: %lu - hits fantasma: %lu",
+              mm->policy_ops->name, (unsigned long)mm->hits, (unsigned long)mm->misses, hit_ratio,
+              (unsigned long)mm->evictions, (unsigned long)mm->ghost_hits);
+}
@@ -0,0 +1,41 @@
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include "memory_manager.h"
+
+/**
+ * Operaciones de una política de reemplazo. El memory manager las invoca con
+ * su lock tomado y cualquiera puede ser NULL.
+ *
+ * La lista de recencia de frame_table la mantiene el memory manager para
+ * todas las políticas (también la usa el flusher); lo que una política
+ * necesite además lo guarda en mm->policy_state.
+ */
+struct mm_policy_ops
+{
+    const char *name;
+    int (*init)(memory_manager_t *mm);
+    void (*destroy)(memory_manager_t *mm);
+
+    // Se acaba de mapear una página en el marco (primera referencia)
+    void (*on_insert)(memory_manager_t *mm, uint32_t frame);
+    // Nueva referencia a una página que ya estaba presente
+    void (*on_access)(memory_manager_t *mm, uint32_t frame);
+    // Marco a desalojar, sin escribirlo ni liberarlo; -1 si no hay candidato
+    int (*choose_victim)(memory_manager_t *mm);
+    // La página deja el marco; evicted indica si fue elegida como víctima
+    void (*on_remove)(memory_manager_t *mm, uint32_t frame, bool evicted);
+};
+
+const mm_policy_ops_t *mm_policy_get(pt_replacement_t policy);
+
+/**
+ * Traduce el valor de ALGORITMO_REEMPLAZO (LRU, CLOCK-M, 2Q o ARC).
+ * @return false si el nombre no corresponde a ninguna política.
+ */
+bool mm_policy_from_name(const char *name, pt_replacement_t *out);
+
+// Informa aciertos, fallos y reemplazos acumulados de la política configurada
+void mm_policy_log_stats(memory_manager_t *mm);
+
+#endif
@@ -1,13 +1,18 @@
 #include "query_executor.h"
 #include <unistd.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdio.h>
 #include <utils/logger.h>
 #include <query_interpreter/query_interpreter.h>
+#include <query_interpreter/script_cache.h>
+#include <memory/replacement_policy.h>
 
 static bool fetch_next_query(worker_state_t *state);
 static query_result_t execute_single_instruction(worker_state_t *state, query_context_t *ctx, int *next_pc);
 static void notify_master_query_error(worker_state_t *state, int query_id, int pc);
+static void wait_memory_delay(worker_state_t *state);
 
 void *query_executor_thread(void *arg)
 {
@@ -76,6 +81,7 @@ void *query_executor_thread(void *arg)
             log_info(state->logger, "## Query %d: %s",
                      ctx.query_id,
                      (result == QUERY_RESULT_END ? "Finalizada" : "Abortada"));
+            mm_policy_log_stats(state->memory_manager);
         }
 
         pthread_mutex_unlock(&state->mux);
@@ -118,6 +124,7 @@ static query_result_t execute_single_instruction(worker_state_t *state, query_co
         t_package *res = package_create_empty(OP_WORKER_EVICT_RES);
         package_add_uint32(res, ctx->query_id);
         package_add_uint32(res, ctx->program_counter);
+        package_add_resident_summary(res, state->memory_manager);
         package_send(res, state->master_socket);
         package_destroy(res);
 
@@ -125,67 +132,49 @@ static query_result_t execute_single_instruction(worker_state_t *state, query_co
         return QUERY_RESULT_EJECT;
     }
 
-    char *path = malloc(256);
-    if (!path) {
-        log_error(state->logger, "## Query %d: Error al asignar memoria para path", ctx->query_id);
-        return QUERY_RESULT_ERROR;
-    }
-    
-    strcpy(path, state->config->path_scripts);
-    strcat(path, ctx->query_path);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s%s", state->config->path_scripts, ctx->query_path);
 
-    char *raw_instruction = NULL;
-    if (fetch_instruction(path, ctx->program_counter, &raw_instruction) < 0)
+    compiled_script_t *script = script_cache_get(state->script_cache, path);
+    compiled_instruction_t *compiled = script_cache_instruction_at(script, ctx->program_counter);
+    if (compiled == NULL)
     {
         log_error(state->logger, "## Query %d: Error en FETCH - PC: %d", 
                   ctx->query_id, ctx->program_counter);
-        free(path); 
         return QUERY_RESULT_ERROR;
     }
-    free(path); 
 
     log_info(state->logger, "## Query %d: FETCH Program Counter: %d %s", 
-             ctx->query_id, ctx->program_counter, raw_instruction);
+             ctx->query_id, ctx->program_counter, compiled->raw);
 
-    instruction_t *instruction = malloc(sizeof(instruction_t));
-    if (!instruction) {
-        log_error(state->logger, "## Query %d: Error al asignar memoria para instrucción", 
-                  ctx->query_id);
-        free(raw_instruction);
-        return QUERY_RESULT_ERROR;
-    }
-
-    if (decode_instruction(raw_instruction, instruction) < 0)
+    if (!compiled->valid)
     {
         log_error(state->logger, "## Query %d: Error al decodificar - %s", 
-                  ctx->query_id, raw_instruction);
-        free(raw_instruction);
-        free(instruction);
+                  ctx->query_id, compiled->raw);
         return QUERY_RESULT_ERROR;
     }
 
+    // Mientras dura la instrucción el flusher no usa el socket de Storage
+    mm_lock(state->memory_manager);
     int exec_res = execute_instruction(
-        instruction, state->storage_socket, state->master_socket,
+        &compiled->instruction, state->storage_socket, state->master_socket,
         state->memory_manager, ctx->query_id, state->worker_id);
+    mm_unlock(state->memory_manager);
 
-    bool end_detected = (instruction->operation == END);
-    
-    // Liberar instruction ANTES de retornar
-    free_instruction(instruction);
-    free(instruction);
+    wait_memory_delay(state);
+
+    bool end_detected = (compiled->instruction.operation == END);
 
     if (exec_res < 0)
     {
         log_error(state->logger, "## Query %d: Falló la instrucción - %s", 
-                  ctx->query_id, raw_instruction);
-        free(raw_instruction);
+                  ctx->query_id, compiled->raw);
         return QUERY_RESULT_ERROR;  // El caller se encarga de notificar a Master
     }
 
     log_info(state->logger, "## Query %d: Instrucción realizada: %s", 
-             ctx->query_id, raw_instruction);
+             ctx->query_id, compiled->raw);
 
-    free(raw_instruction);
     *next_pc = ctx->program_counter + 1;
 
     pthread_mutex_lock(&state->mux);
@@ -199,6 +188,7 @@ static query_result_t execute_single_instruction(worker_state_t *state, query_co
         t_package *res = package_create_empty(OP_WORKER_EVICT_RES);
         package_add_uint32(res, ctx->query_id);
         package_add_uint32(res, *next_pc);  // Envío el PC actualizado
+        package_add_resident_summary(res, state->memory_manager);
         package_send(res, state->master_socket);
         package_destroy(res);
 
@@ -216,6 +206,26 @@ static query_result_t execute_single_instruction(worker_state_t *state, query_co
     return QUERY_RESULT_OK;
 }
 
+/*
+ * Espera el retardo de memoria de la instrucción recién ejecutada. Un pedido
+ * de desalojo o de fin lo corta: la instrucción ya se hizo, así que se desaloja
+ * con el PC siguiente sin esperar el resto del retardo.
+ */
+static void wait_memory_delay(worker_state_t *state)
+{
+    struct timespec deadline;
+    if (!mm_take_memory_deadline(state->memory_manager, &deadline))
+        return;
+
+    pthread_mutex_lock(&state->mux);
+    while (!state->ejection_requested && !state->should_stop)
+    {
+        if (pthread_cond_timedwait(&state->preempt_cond, &state->mux, &deadline) == ETIMEDOUT)
+            break;
+    }
+    pthread_mutex_unlock(&state->mux);
+}
+
 // Notificar error a Master
 static void notify_master_query_error(worker_state_t *state, int query_id, int pc)
 {
@@ -228,6 +238,7 @@ static void notify_master_query_error(worker_state_t *state, int query_id, int p
     if (error_pkg) {
         package_add_uint32(error_pkg, state->worker_id);
         package_add_uint32(error_pkg, query_id);
+        package_add_resident_summary(error_pkg, state->memory_manager);
         
         if (package_send(error_pkg, state->master_socket) != 0) {
             log_error(state->logger, 
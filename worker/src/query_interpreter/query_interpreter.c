@@ -309,7 +309,7 @@ int execute_instruction(instruction_t *instruction, int socket_storage, int sock
             break;
         }
         case END:
-            end_query_in_master(socket_master, worker_id, query_id);
+            end_query_in_master(socket_master, worker_id, query_id, memory_manager);
             break;
         default:
             return -1;
@@ -0,0 +1,158 @@
+#include "script_cache.h"
+#include <sys/stat.h>
+
+static void compiled_script_destroy(void *element) {
+    compiled_script_t *script = (compiled_script_t *)element;
+    if (script == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < script->instruction_count; i++) {
+        if (script->instructions[i].valid) {
+            free_instruction(&script->instructions[i].instruction);
+        }
+        free(script->instructions[i].raw);
+    }
+    free(script->instructions);
+    free(script->path);
+    free(script);
+}
+
+static compiled_script_t *compile_script(const char *path, const struct timespec *mtime) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return NULL;
+    }
+
+    compiled_script_t *script = calloc(1, sizeof(compiled_script_t));
+    if (script == NULL) {
+        fclose(file);
+        return NULL;
+    }
+    script->path = string_duplicate((char *)path);
+    script->mtime = *mtime;
+    script->bytes = sizeof(compiled_script_t) + strlen(path) + 1;
+
+    uint32_t capacity = 0;
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t line_length;
+
+    while ((line_length = getline(&line, &line_capacity, file)) != -1) {
+        if (script->instruction_count == capacity) {
+            uint32_t new_capacity = capacity == 0 ? 16 : capacity * 2;
+            compiled_instruction_t *resized = realloc(script->instructions, new_capacity * sizeof(compiled_instruction_t));
+            if (resized == NULL) {
+                goto error;
+            }
+            script->instructions = resized;
+            capacity = new_capacity;
+        }
+
+        line[strcspn(line, "\n")] = 0;
+
+        compiled_instruction_t *compiled = &script->instructions[script->instruction_count];
+        compiled->raw = string_duplicate(line);
+        compiled->valid = decode_instruction(compiled->raw, &compiled->instruction) == 0;
+        script->instruction_count++;
+
+        // La línea original y los strings decodificados nunca superan el largo de la línea
+        script->bytes += sizeof(compiled_instruction_t) + 2 * (strlen(compiled->raw) + 1);
+    }
+
+    free(line);
+    fclose(file);
+    return script;
+
+error:
+    free(line);
+    fclose(file);
+    compiled_script_destroy(script);
+    return NULL;
+}
+
+static void evict_script(script_cache_t *cache, compiled_script_t *script) {
+    dictionary_remove(cache->scripts, script->path);
+    list_remove_element(cache->lru, script);
+    cache->used_bytes -= script->bytes;
+    compiled_script_destroy(script);
+}
+
+static void touch_script(script_cache_t *cache, compiled_script_t *script) {
+    if (list_get(cache->lru, 0) == script) {
+        return;
+    }
+    list_remove_element(cache->lru, script);
+    list_add_in_index(cache->lru, 0, script);
+}
+
+script_cache_t *script_cache_create(size_t budget) {
+    script_cache_t *cache = calloc(1, sizeof(script_cache_t));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    cache->scripts = dictionary_create();
+    cache->lru = list_create();
+    cache->budget = budget;
+    return cache;
+}
+
+void script_cache_destroy(script_cache_t *cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    dictionary_destroy(cache->scripts);
+    list_destroy_and_destroy_elements(cache->lru, compiled_script_destroy);
+    free(cache);
+}
+
+compiled_script_t *script_cache_get(script_cache_t *cache, const char *path) {
+    if (cache == NULL || path == NULL) {
+        return NULL;
+    }
+
+    struct stat file_stat;
+    if (stat(path, &file_stat) != 0) {
+        return NULL;
+    }
+
+    compiled_script_t *script = dictionary_get(cache->scripts, (char *)path);
+    if (script != NULL) {
+        if (script->mtime.tv_sec == file_stat.st_mtim.tv_sec &&
+            script->mtime.tv_nsec == file_stat.st_mtim.tv_nsec) {
+            cache->hits++;
+            touch_script(cache, script);
+            return script;
+        }
+        // El script cambió en disco: se descarta la versión compilada
+        evict_script(cache, script);
+    }
+
+    cache->misses++;
+    script = compile_script(path, &file_stat.st_mtim);
+    if (script == NULL) {
+        return NULL;
+    }
+
+    dictionary_put(cache->scripts, script->path, script);
+    list_add_in_index(cache->lru, 0, script);
+    cache->used_bytes += script->bytes;
+
+    // Nunca se desaloja el script recién compilado, aunque supere el presupuesto por sí solo
+    while (cache->used_bytes > cache->budget && list_size(cache->lru) > 1) {
+        compiled_script_t *victim = list_get(cache->lru, list_size(cache->lru) - 1);
+        evict_script(cache, victim);
+        cache->evictions++;
+    }
+
+    return script;
+}
+
+compiled_instruction_t *script_cache_instruction_at(compiled_script_t *script, uint32_t program_counter) {
+    if (script == NULL || program_counter >= script->instruction_count) {
+        return NULL;
+    }
+    return &script->instructions[program_counter];
+}
@@ -0,0 +1,70 @@
+#ifndef SCRIPT_CACHE_H
+#define SCRIPT_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include <commons/collections/dictionary.h>
+#include <commons/collections/list.h>
+#include "query_interpreter.h"
+
+typedef struct {
+    char *raw;                  // Línea original, se conserva para los logs de FETCH
+    instruction_t instruction;  // Instrucción ya decodificada
+    bool valid;                 // false si la línea no pudo decodificarse
+} compiled_instruction_t;
+
+typedef struct {
+    char *path;
+    struct timespec mtime;
+    compiled_instruction_t *instructions;
+    uint32_t instruction_count;
+    size_t bytes;               // Tamaño estimado que ocupa en el presupuesto de la caché
+} compiled_script_t;
+
+typedef struct {
+    t_dictionary *scripts;      // path -> compiled_script_t
+    t_list *lru;                // compiled_script_t, el más reciente al principio
+    size_t budget;
+    size_t used_bytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+} script_cache_t;
+
+/**
+ * Crea la caché de scripts compilados del Worker.
+ * La caché no es thread-safe: pertenece al hilo ejecutor de queries.
+ *
+ * @param budget Cantidad máxima de bytes que pueden ocupar los scripts compilados
+ * @return La caché creada o NULL si falla
+ */
+script_cache_t *script_cache_create(size_t budget);
+
+/**
+ * Libera la caché y todos los scripts compilados que contiene.
+ */
+void script_cache_destroy(script_cache_t *cache);
+
+/**
+ * Devuelve el script compilado para el path indicado.
+ * Si no está en caché, o el archivo fue modificado desde que se compiló,
+ * lo lee y decodifica completo una única vez. Si al agregarlo se supera el
+ * presupuesto, desaloja los scripts menos usados recientemente.
+ *
+ * @param cache Caché de scripts
+ * @param path Ruta completa del script
+ * @return El script compilado o NULL si no se pudo leer. El puntero es válido
+ *         hasta la próxima llamada a script_cache_get o script_cache_destroy.
+ */
+compiled_script_t *script_cache_get(script_cache_t *cache, const char *path);
+
+/**
+ * Devuelve la instrucción compilada correspondiente al program counter.
+ *
+ * @return La instrucción o NULL si el program counter está fuera de rango
+ */
+compiled_instruction_t *script_cache_instruction_at(compiled_script_t *script, uint32_t program_counter);
+
+#endif
@@ -6,6 +6,7 @@
 #include <pthread.h>
 #include <memory/memory_manager.h>
 #include <config/worker_config.h>
+#include <query_interpreter/script_cache.h>
 #include <commons/log.h>
 
 typedef struct
@@ -21,6 +22,7 @@ typedef struct
     // --- Concurrencia y Sincronización ---
     pthread_mutex_t mux;
     pthread_cond_t new_query_cond;
+    pthread_cond_t preempt_cond;    // Se señala al pedir desalojo o fin: corta el retardo de memoria
     bool has_query;
     bool should_stop;
     bool ejection_requested;
@@ -33,6 +35,7 @@ typedef struct
     t_worker_config *config;
     t_log *logger;
     memory_manager_t *memory_manager;
+    script_cache_t *script_cache;
     int worker_id;
 } worker_state_t;
 
@@ -89,6 +89,7 @@ static void eject_query(t_package *pkg, worker_state_t *state)
     if (state->has_query && state->current_query.query_id == query_id) {
         if (state->is_executing) {
             state->ejection_requested = true;
+            pthread_cond_signal(&state->preempt_cond);
         } else {
             state->has_query = false;
             int pc = state->current_query.program_counter;
@@ -99,6 +100,7 @@ static void eject_query(t_package *pkg, worker_state_t *state)
             t_package *resp = package_create_empty(OP_WORKER_EVICT_RES);
             package_add_uint32(resp, query_id);
             package_add_uint32(resp, pc);
+            package_add_resident_summary(resp, state->memory_manager);
             package_send(resp, state->master_socket);
             package_destroy(resp);
             log_info(state->logger, "## Query %d: Desalojada en READY, PC=%d", query_id, pc);
@@ -116,6 +118,7 @@ static void end_query(t_package *pkg, worker_state_t *state)
     pthread_mutex_lock(&state->mux);
     state->should_stop = true;
     state->has_query = false;
+    pthread_cond_signal(&state->preempt_cond);
     pthread_mutex_unlock(&state->mux);
     package_destroy(pkg);
 }
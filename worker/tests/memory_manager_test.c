@@ -1,10 +1,16 @@
 #include <memory/memory_manager.h>
+#include <memory/replacement_policy.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 #include <cspecs/cspec.h>
 #include <commons/log.h>
+#include <connection/protocol.h>
+#include <connection/serialization.h>
+#include <utils/logger.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 
 static int mm_test_write(memory_manager_t *mm, page_table_t *pt,
@@ -21,6 +27,31 @@ static int mm_test_read(memory_manager_t *mm, page_table_t *pt,
                                base, size, out);
 }
 
+// Respuesta de Storage a un READV: count bloques con el mismo contenido
+static void storage_test_send_blocks(int socket, const char *content, uint32_t count, size_t block_size)
+{
+    uint8_t *blocks = calloc(count, block_size);
+    for (uint32_t i = 0; i < count; i++)
+        memcpy(blocks + i * block_size, content, strlen(content));
+
+    t_package *response = package_create_empty(STORAGE_OP_BLOCK_READV_RES);
+    package_add_uint32(response, block_size);
+    package_add_uint32(response, count);
+    package_add_data(response, blocks, count * block_size);
+    package_send(response, socket);
+    package_destroy(response);
+    free(blocks);
+}
+
+static void storage_test_send_error(int socket, int query_id, char *message)
+{
+    t_package *response = package_create_empty(STORAGE_OP_ERROR);
+    package_add_uint32(response, query_id);
+    package_add_string(response, message);
+    package_send(response, socket);
+    package_destroy(response);
+}
+
 
 context(memory_manager_tests) {
     describe("Crear administrador de memoria") {
@@ -100,6 +131,19 @@ context(memory_manager_tests) {
             should_string(last_entry->file) be equal to("file_overflow");
             should_string(last_entry->tag) be equal to("tag_overflow");
         } end
+        it("debería seguir encontrando la última tabla después de borrar una del medio") {
+            page_table_t *pt1 = mm_create_page_table(mm, "file1", "tag1");
+            mm_create_page_table(mm, "file2", "tag2");
+            page_table_t *pt3 = mm_create_page_table(mm, "file3", "tag3");
+
+            mm_remove_page_table(mm, "file2", "tag2");
+
+            should_int(mm->count) be equal to(2);
+            should_ptr(mm_find_page_table(mm, "file1", "tag1")) be equal to(pt1);
+            should_ptr(mm_find_page_table(mm, "file3", "tag3")) be equal to(pt3);
+            should_ptr(mm_find_page_table(mm, "file2", "tag2")) be equal to(NULL);
+            should_ptr(mm->entries[1].page_table) be equal to(pt3);
+        } end
     } end
     describe("Escribir en la memoria") {
         memory_manager_t *mm = NULL;
@@ -152,7 +196,7 @@ context(memory_manager_tests) {
             int result = mm_test_write(mm, pt, 0, data, strlen(data));
 
             should_int(result) be equal to(0);
-            should_bool(pt->entries[0].dirty) be equal to(true);
+            should_bool(pt_is_dirty(pt, 0)) be equal to(true);
 
             for (size_t i = 0; i < strlen(data); i++) {
                 should_char(((char *)mm->physical_memory)[i]) be equal to(data[i]);
@@ -238,13 +282,13 @@ context(memory_manager_tests) {
         } end
 
         it("debería retornar NULL al intentar obtener páginas sucias de una tabla de páginas inexistente") {
-            pt_entry_t *dirty_pages = mm_get_dirty_pages(mm, "nonexistent_file", "nonexistent_tag", &dirty_count);
+            pt_dirty_page_t *dirty_pages = mm_get_dirty_pages(mm, "nonexistent_file", "nonexistent_tag", &dirty_count);
 
             should_ptr(dirty_pages) be equal to(NULL);
             should_int(dirty_count) be equal to(0);
         } end
         it("debería retornar las páginas sucias correctamente") {
-            pt_entry_t *dirty_pages = mm_get_dirty_pages(mm, "file1", "tag1", &dirty_count);
+            pt_dirty_page_t *dirty_pages = mm_get_dirty_pages(mm, "file1", "tag1", &dirty_count);
 
             should_ptr(dirty_pages) not be equal to(NULL);
             should_int(dirty_count) be equal to(1);
@@ -252,6 +296,253 @@ context(memory_manager_tests) {
             should_bool(dirty_pages[0].dirty) be equal to(true);
         } end
     } end
+    describe("Asignación de marcos") {
+        memory_manager_t *mm = NULL;
+
+        before {
+            mm = mm_create(4096 * 4, 4096, LRU, 0);
+        } end
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("debería asignar primero los marcos más bajos") {
+            should_int(mm_allocate_frame(mm)) be equal to(0);
+            should_int(mm_allocate_frame(mm)) be equal to(1);
+            should_int(mm->frame_table.free_count) be equal to(2);
+        } end
+
+        it("debería reutilizar el marco liberado") {
+            for (int i = 0; i < 4; i++) {
+                mm_allocate_frame(mm);
+            }
+            mm_free_frame(mm, 2);
+
+            should_int(mm->frame_table.free_count) be equal to(1);
+            should_int(mm_allocate_frame(mm)) be equal to(2);
+            should_bool(mm->frame_table.frames[2].used) be equal to(true);
+        } end
+    } end
+    describe("Escritura en segundo plano") {
+        memory_manager_t *mm = NULL;
+
+        before {
+            mm = mm_create(4096 * 4, 4096, LRU, 0);
+        } end
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("debería contar sólo los marcos con páginas sucias") {
+            page_table_t *pt = mm_create_page_table(mm, "file1", "tag1");
+            pt_resize(pt, 3);
+            mm_map_page(mm, pt, 0, mm_allocate_frame(mm));
+            mm_map_page(mm, pt, 1, mm_allocate_frame(mm));
+            pt_set_dirty(pt, 1, true);
+
+            should_int(mm_dirty_frame_count(mm)) be equal to(1);
+        } end
+
+        it("debería rechazar marcas inválidas") {
+            should_int(mm_start_flusher(mm, 0, 0, 100)) be equal to(-1);
+            should_int(mm_start_flusher(mm, 50, 50, 100)) be equal to(-1);
+            should_int(mm_start_flusher(mm, 120, 10, 100)) be equal to(-1);
+            should_bool(mm->flusher_running) be equal to(false);
+        } end
+
+        it("debería iniciar y frenar el hilo") {
+            should_int(mm_start_flusher(mm, 50, 25, 10)) be equal to(0);
+            should_bool(mm->flusher_running) be equal to(true);
+            mm_stop_flusher(mm);
+            should_bool(mm->flusher_running) be equal to(false);
+        } end
+
+        it("no debería notificar al Master si falla una escritura en segundo plano") {
+            logger_init("memory_manager_test", LOG_LEVEL_ERROR, false);
+            int storage[2];
+            int master[2];
+            socketpair(AF_UNIX, SOCK_STREAM, 0, storage);
+            socketpair(AF_UNIX, SOCK_STREAM, 0, master);
+            mm_set_storage_connection(mm, storage[0], 1);
+            mm_set_master_connection(mm, master[0]);
+            mm_set_query_id(mm, 7);
+
+            page_table_t *pt = mm_create_page_table(mm, "file1", "tag1");
+            pt_resize(pt, 3);
+            for (uint32_t page = 0; page < 3; page++)
+            {
+                mm_map_page(mm, pt, page, mm_allocate_frame(mm));
+                pt_set_dirty(pt, page, true);
+            }
+
+            // Storage rechaza cada tanda que intente el flusher
+            for (int i = 0; i < 32; i++)
+                storage_test_send_error(storage[1], 7, "Error de escritura");
+
+            should_int(mm_start_flusher(mm, 50, 25, 10)) be equal to(0);
+            usleep(100 * 1000);
+            mm_stop_flusher(mm);
+
+            char byte;
+            should_int(recv(master[1], &byte, 1, MSG_DONTWAIT)) be equal to(-1);
+            should_int(mm_dirty_frame_count(mm)) be equal to(3);
+
+            close(storage[0]);
+            close(storage[1]);
+            close(master[0]);
+            close(master[1]);
+            logger_destroy();
+        } end
+    } end
+    describe("Retardo de memoria") {
+        memory_manager_t *mm = NULL;
+
+        before {
+            mm = mm_create(4096 * 4, 4096, LRU, 500);
+        } end
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("no debería haber plazo si la instrucción no accedió a memoria") {
+            struct timespec deadline;
+            should_bool(mm_take_memory_deadline(mm, &deadline)) be equal to(false);
+        } end
+
+        it("debería fijar un único plazo por instrucción sin dormir") {
+            page_table_t *pt = mm_create_page_table(mm, "file1", "tag1");
+            mm_map_page(mm, pt, 0, mm_allocate_frame(mm));
+            char data[] = "prueba";
+
+            struct timespec before_access, after_access, deadline;
+            clock_gettime(CLOCK_REALTIME, &before_access);
+            mm_test_write(mm, pt, 0, data, strlen(data));
+            mm_test_read(mm, pt, 0, strlen(data), data);
+            clock_gettime(CLOCK_REALTIME, &after_access);
+
+            long elapsed_ms = (after_access.tv_sec - before_access.tv_sec) * 1000 +
+                              (after_access.tv_nsec - before_access.tv_nsec) / 1000000;
+            should_bool(elapsed_ms < 250) be equal to(true);
+            should_bool(mm_take_memory_deadline(mm, &deadline)) be equal to(true);
+            should_bool(deadline.tv_sec > after_access.tv_sec ||
+                        (deadline.tv_sec == after_access.tv_sec && deadline.tv_nsec > after_access.tv_nsec)) be equal to(true);
+            should_bool(mm_take_memory_deadline(mm, &deadline)) be equal to(false);
+        } end
+    } end
+    describe("Lectura anticipada") {
+        memory_manager_t *mm = NULL;
+        int storage[2];
+        int master[2];
+
+        before {
+            // handler_error_from_storage necesita el logger para notificar al Master
+            logger_init("memory_manager_test", LOG_LEVEL_ERROR, false);
+            mm = mm_create(4096 * 8, 4096, LRU, 0);
+            socketpair(AF_UNIX, SOCK_STREAM, 0, storage);
+            socketpair(AF_UNIX, SOCK_STREAM, 0, master);
+            mm_set_storage_connection(mm, storage[0], 1);
+            mm_set_master_connection(mm, master[0]);
+            mm_set_query_id(mm, 7);
+            mm_set_read_ahead(mm, 2);
+        } end
+
+        after {
+            mm_destroy(mm);
+            close(storage[0]);
+            close(storage[1]);
+            close(master[0]);
+            close(master[1]);
+            logger_destroy();
+        } end
+
+        it("no debería notificar al Master si falla una página anticipada") {
+            page_table_t *pt = mm_create_page_table(mm, "file1", "tag1");
+            pt->sequential_next = 1; // El acceso anterior fue a la página 0
+
+            // La página 1 llega; las anticipadas 2 y 3 están fuera del archivo en Storage
+            storage_test_send_blocks(storage[1], "pagina1", 1, 4096);
+            storage_test_send_error(storage[1], 7, "Lectura fuera de limite");
+
+            char buffer[8] = {0};
+            should_int(mm_test_read(mm, pt, 4096, 7, buffer)) be equal to(0);
+            should_string(buffer) be equal to("pagina1");
+            should_bool(pt_is_present(pt, 1)) be equal to(true);
+            should_bool(pt_is_present(pt, 2)) be equal to(false);
+            should_bool(pt_is_present(pt, 3)) be equal to(false);
+            should_int(pt->page_count) be equal to(2); // Sólo crece por las páginas que llegan
+            should_int(mm->frame_table.free_count) be equal to(7);
+
+            char byte;
+            should_int(recv(master[1], &byte, 1, MSG_DONTWAIT)) be equal to(-1);
+        } end
+
+        it("debería traer las páginas siguientes de una lectura secuencial") {
+            page_table_t *pt = mm_create_page_table(mm, "file1", "tag1");
+
+            // Página 0; después la 1 y, por ser secuencial, las anticipadas 2 y 3
+            storage_test_send_blocks(storage[1], "pagina0", 1, 4096);
+            storage_test_send_blocks(storage[1], "pagina1", 1, 4096);
+            storage_test_send_blocks(storage[1], "siguiente", 2, 4096);
+
+            char buffer[10] = {0};
+            should_int(mm_test_read(mm, pt, 0, 7, buffer)) be equal to(0);
+            should_int(mm_test_read(mm, pt, 4096, 7, buffer)) be equal to(0);
+            should_string(buffer) be equal to("pagina1");
+            should_bool(pt_is_present(pt, 2)) be equal to(true);
+            should_bool(pt_is_present(pt, 3)) be equal to(true);
+            should_int(mm->misses) be equal to(2);
+
+            // Descartar los pedidos ya enviados: la próxima lectura no debería enviar ninguno
+            char request[4096];
+            while (recv(storage[1], request, sizeof(request), MSG_DONTWAIT) > 0)
+                ;
+
+            should_int(mm_test_read(mm, pt, 2 * 4096, 9, buffer)) be equal to(0);
+            should_string(buffer) be equal to("siguiente");
+            should_int(mm_test_read(mm, pt, 3 * 4096, 9, buffer)) be equal to(0);
+            should_string(buffer) be equal to("siguiente");
+            should_int(mm->misses) be equal to(2);
+            should_int(recv(storage[1], request, sizeof(request), MSG_DONTWAIT)) be equal to(-1);
+        } end
+    } end
+    describe("Resumen de File:Tags residentes") {
+        memory_manager_t *mm = NULL;
+        file_tag_entry_t *resident[MM_SUMMARY_MAX_FILE_TAGS];
+
+        before {
+            mm = mm_create(1024 * 1024, 4096, LRU, 0);
+            page_table_t *pt1 = mm_create_page_table(mm, "file1", "tag1");
+            page_table_t *pt2 = mm_create_page_table(mm, "file2", "tag2");
+            mm_create_page_table(mm, "file3", "tag3");
+            pt_resize(pt2, 3);
+            mm_map_page(mm, pt1, 0, 0);
+            for (uint32_t i = 0; i < 3; i++) {
+                mm_map_page(mm, pt2, i, i + 1);
+            }
+        } end
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("debería informar sólo los File:Tag con páginas presentes, de mayor a menor") {
+            uint32_t count = mm_resident_file_tags(mm, resident, MM_SUMMARY_MAX_FILE_TAGS);
+
+            should_int(count) be equal to(2);
+            should_string(resident[0]->file) be equal to("file2");
+            should_string(resident[1]->file) be equal to("file1");
+        } end
+
+        it("debería respetar la cantidad máxima pedida") {
+            uint32_t count = mm_resident_file_tags(mm, resident, 1);
+
+            should_int(count) be equal to(1);
+            should_string(resident[0]->file) be equal to("file2");
+        } end
+    } end
     describe("Algoritmo de reemplazo LRU") {
         memory_manager_t *mm = NULL;
 
@@ -263,12 +554,7 @@ context(memory_manager_tests) {
                 sprintf(tag, "tag_%d", i);
 
                 page_table_t *pt = mm_create_page_table(mm, file, tag);
-                pt_map(pt, 0, i);
-
-                mm->frame_table.frames[i].used = true;
-                pt->entries[0].present = true;
-                pt->entries[0].frame = i;
-                pt->entries[0].last_access_time = i + 1;
+                mm_map_page(mm, pt, 0, i);
             }
         } end
 
@@ -286,6 +572,26 @@ context(memory_manager_tests) {
             should_bool(mm->frame_table.frames[victim_frame].used) be equal to(false);
         } end
 
+        it("debería dejar de elegir una página recién accedida") {
+            page_table_t *pt = mm_find_page_table(mm, "file_0", "tag_0");
+            mm_update_page_access(mm, pt, 0);
+
+            int victim_frame = mm_find_lru_victim(mm);
+            should_int(victim_frame) be equal to(1);
+        } end
+
+        it("debería mantener el dueño de los marcos al borrar un File:Tag") {
+            file_tag_entry_t *entry = NULL;
+            uint32_t page = 0;
+
+            mm_remove_page_table(mm, "file_1", "tag_1");
+
+            should_bool(mm->frame_table.frames[1].used) be equal to(false);
+            should_bool(mm_find_page_for_frame(mm, 3, &entry, NULL, &page)) be equal to(true);
+            should_string(entry->file) be equal to("file_3");
+            should_int(page) be equal to(0);
+        } end
+
     } end
 
     describe("Algoritmo de reemplazo CLOCK-M") {
@@ -301,15 +607,11 @@ context(memory_manager_tests) {
                 sprintf(tag, "t%d", i);
 
                 page_table_t *pt = mm_create_page_table(mm, file, tag);
-                pt_map(pt, 0, i);
+                mm_map_page(mm, pt, 0, i);
 
-                pt->entries[0].present = true;
-                pt->entries[0].frame   = i;
-                pt->entries[0].dirty   = false;
+                pt_set_dirty(pt, 0, false);
                 // solo el 2 tiene U=0, el resto U=1
-                pt->entries[0].use_bit = (i != 2);
-
-                mm->frame_table.frames[i].used = true;
+                pt_get_entry(pt, 0)->use_bit = (i != 2);
             }
 
             mm->frame_table.clock_pointer = 0;
@@ -325,6 +627,111 @@ context(memory_manager_tests) {
         } end
 
     } end
+    describe("Algoritmo de reemplazo 2Q") {
+        memory_manager_t *mm = NULL;
+        page_table_t *pt = NULL;
+
+        before {
+            mm = mm_create(4096 * 4, 4096, TWO_Q, 0);
+            pt = mm_create_page_table(mm, "f", "t");
+            pt_resize(pt, 8);
+            for (int i = 0; i < 4; i++)
+                mm_map_page(mm, pt, i, i);
+        } end
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("no promueve una página de A1in por referencias seguidas") {
+            mm_update_page_access(mm, pt, 0);
+            mm_update_page_access(mm, pt, 0);
+
+            should_int(mm->policy_ops->choose_victim(mm)) be equal to(0);
+        } end
+
+        it("debería pasar a Am una página desalojada que se vuelve a pedir") {
+            int frame = mm_allocate_frame(mm);
+            should_int(frame) be equal to(0);
+
+            mm_map_page(mm, pt, 0, frame);
+            should_int(mm->ghost_hits) be equal to(1);
+
+            // A1in sigue excedida: la víctima sale de ahí y la página 0 se conserva
+            should_int(mm_allocate_frame(mm)) be equal to(1);
+            should_bool(pt_is_present(pt, 0)) be equal to(true);
+        } end
+    } end
+
+    describe("Algoritmo de reemplazo ARC") {
+        memory_manager_t *mm = NULL;
+        page_table_t *pt = NULL;
+
+        before {
+            mm = mm_create(4096 * 4, 4096, ARC, 0);
+            pt = mm_create_page_table(mm, "f", "t");
+            pt_resize(pt, 8);
+            for (int i = 0; i < 4; i++)
+                mm_map_page(mm, pt, i, i);
+        } end
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("debería elegir la página de T1 aunque sea la más reciente") {
+            mm_update_page_access(mm, pt, 0);
+            mm_update_page_access(mm, pt, 1);
+            mm_update_page_access(mm, pt, 2);
+
+            should_int(mm->policy_ops->choose_victim(mm)) be equal to(3);
+        } end
+
+        it("debería pasar a T2 una página recordada en B1") {
+            int frame = mm_allocate_frame(mm);
+            should_int(frame) be equal to(0);
+
+            mm_map_page(mm, pt, 0, frame);
+
+            should_int(mm->ghost_hits) be equal to(1);
+            should_int(mm->evictions) be equal to(1);
+            should_int(mm->policy_ops->choose_victim(mm)) be equal to(1);
+        } end
+    } end
+
+    describe("Estadísticas de la política de reemplazo") {
+        memory_manager_t *mm = NULL;
+
+        after {
+            mm_destroy(mm);
+        } end
+
+        it("debería contar aciertos sobre páginas presentes") {
+            char out[8];
+            mm = mm_create(4096 * 4, 4096, LRU, 0);
+            page_table_t *pt = mm_create_page_table(mm, "TEST_FILE", "TEST_TAG");
+            mm_map_page(mm, pt, 0, mm_allocate_frame(mm));
+
+            mm_test_read(mm, pt, 0, sizeof(out), out);
+            mm_test_read(mm, pt, 8, sizeof(out), out);
+
+            should_int(mm->hits) be equal to(2);
+            should_int(mm->misses) be equal to(0);
+        } end
+
+        it("debería reconocer los nombres de ALGORITMO_REEMPLAZO") {
+            pt_replacement_t policy = LRU;
+            mm = NULL;
+
+            should_bool(mm_policy_from_name("arc", &policy)) be equal to(true);
+            should_int(policy) be equal to(ARC);
+            should_bool(mm_policy_from_name("2Q", &policy)) be equal to(true);
+            should_int(policy) be equal to(TWO_Q);
+            should_bool(mm_policy_from_name("CLOCK-M", &policy)) be equal to(true);
+            should_int(policy) be equal to(CLOCK_M);
+            should_bool(mm_policy_from_name("FIFO", &policy)) be equal to(false);
+        } end
+    } end
 }   // cierra context(memory_manager_tests)
 
 
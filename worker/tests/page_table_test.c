@@ -17,9 +17,9 @@ context(tests_page_table) {
             should_int(pt->page_count) be equal to(page_count);
             should_int(pt->page_size) be equal to(page_size);
             for (uint32_t i = 0; i < page_count; i++) {
-                should_int(pt->entries[i].frame) be equal to(0);
-                should_bool(pt->entries[i].dirty) be equal to(false);
-                should_bool(pt->entries[i].present) be equal to(false);
+                should_ptr(pt_find_entry(pt, i)) be equal to(NULL);
+                should_bool(pt_is_dirty(pt, i)) be equal to(false);
+                should_bool(pt_is_present(pt, i)) be equal to(false);
             }
             pt_destroy(pt);
         } end
@@ -41,7 +41,7 @@ context(tests_page_table) {
 
             pt_set_dirty(pt, 5, true);
 
-            should_bool(pt->entries[5].dirty) be equal to(true);
+            should_bool(pt_is_dirty(pt, 5)) be equal to(true);
             pt_destroy(pt);
         } end
         it("No deberia marcar ninguna entrada si el indice es invalido") {
@@ -53,7 +53,7 @@ context(tests_page_table) {
             pt_set_dirty(pt, invalid_index, true);
 
             for (uint32_t i = 0; i < page_count; i++) {
-                should_bool(pt->entries[i].dirty) be equal to(false);
+                should_bool(pt_is_dirty(pt, i)) be equal to(false);
             }
             pt_destroy(pt);
         } end
@@ -67,7 +67,7 @@ context(tests_page_table) {
 
             pt_set_dirty(pt, 5, false);
 
-            should_bool(pt->entries[5].dirty) be equal to(false);
+            should_bool(pt_is_dirty(pt, 5)) be equal to(false);
             pt_destroy(pt);
         } end
         it("No deberia cambiar ninguna entrada si el indice es invalido") {
@@ -79,7 +79,7 @@ context(tests_page_table) {
 
             pt_set_dirty(pt, invalid_index, false);
 
-            should_bool(pt->entries[5].dirty) be equal to(true);
+            should_bool(pt_is_dirty(pt, 5)) be equal to(true);
             pt_destroy(pt);
         } end
     } end
@@ -93,7 +93,7 @@ context(tests_page_table) {
             pt_set_dirty(pt, 7, true);
 
             size_t dirty_count = 0;
-            pt_entry_t *dirty_entries = pt_get_dirty_entries(pt, &dirty_count);
+            pt_dirty_page_t *dirty_entries = pt_get_dirty_entries(pt, &dirty_count);
 
             should_int(dirty_count) be equal to(3);
             for (size_t i = 0; i < dirty_count; i++) {
@@ -102,17 +102,95 @@ context(tests_page_table) {
             free(dirty_entries);
             pt_destroy(pt);
         } end
+        it("Deberia devolver las entradas modificadas ordenadas aunque esten en hojas distintas") {
+            page_table_t *pt = pt_create(1024, 256);
+            pt_set_dirty(pt, 700, true);
+            pt_set_dirty(pt, 3, true);
+            pt_set_dirty(pt, 130, true);
+
+            size_t dirty_count = 0;
+            pt_dirty_page_t *dirty_entries = pt_get_dirty_entries(pt, &dirty_count);
+
+            should_int(dirty_count) be equal to(3);
+            should_int(dirty_entries[0].page_number) be equal to(3);
+            should_int(dirty_entries[1].page_number) be equal to(130);
+            should_int(dirty_entries[2].page_number) be equal to(700);
+            free(dirty_entries);
+            pt_destroy(pt);
+        } end
         it("Deberia retornar count 0 y NULL si no hay entradas modificadas") {
             size_t page_size = 256;
             uint32_t page_count = 16;
             page_table_t *pt = pt_create(page_count, page_size);
             size_t dirty_count = 0;
 
-            pt_entry_t *dirty_entries = pt_get_dirty_entries(pt, &dirty_count);
+            pt_dirty_page_t *dirty_entries = pt_get_dirty_entries(pt, &dirty_count);
             
             should_int(dirty_count) be equal to(0);
             should_ptr(dirty_entries) be equal to(NULL);
             pt_destroy(pt);
         } end
     } end
+    describe("Tabla dispersa") {
+        it("No deberia alocar hojas para las paginas intermedias al mapear una pagina lejana") {
+            page_table_t *pt = pt_create(1, 4096);
+
+            should_int(pt_resize(pt, 1u << 20)) be equal to(0);
+            should_int(pt_map(pt, (1u << 20) - 1, 3)) be equal to(0);
+
+            uint32_t allocated = 0;
+            for (uint32_t i = 0; i < pt->leaf_count; i++) {
+                if (pt->leaves[i] != NULL)
+                    allocated++;
+            }
+            should_int(allocated) be equal to(1);
+            should_int(pt->present_count) be equal to(1);
+            should_ptr(pt_find_entry(pt, 5)) be equal to(NULL);
+            pt_destroy(pt);
+        } end
+        it("Deberia liberar la hoja cuando no le quedan paginas presentes ni sucias") {
+            page_table_t *pt = pt_create(256, 4096);
+            pt_map(pt, 100, 1);
+            pt_set_dirty(pt, 100, true);
+
+            pt_unmap(pt, 100);
+
+            should_ptr(pt->leaves[100 >> PT_LEAF_BITS]) be equal to(NULL);
+            should_int(pt->dirty_count) be equal to(0);
+            should_ptr(pt->dirty_leaves) be equal to(NULL);
+            pt_destroy(pt);
+        } end
+        it("Deberia recorrer solo las paginas presentes") {
+            page_table_t *pt = pt_create(4096, 256);
+            pt_map(pt, 10, 0);
+            pt_map(pt, 2000, 1);
+            pt_map(pt, 2001, 2);
+
+            uint32_t visited[4];
+            uint32_t count = 0;
+            uint32_t page = 0;
+            for (; pt_next_present(pt, &page) != NULL && count < 4; page++)
+                visited[count++] = page;
+
+            should_int(count) be equal to(3);
+            should_int(visited[0]) be equal to(10);
+            should_int(visited[1]) be equal to(2000);
+            should_int(visited[2]) be equal to(2001);
+            pt_destroy(pt);
+        } end
+        it("Deberia descartar las paginas que quedan afuera al achicar") {
+            page_table_t *pt = pt_create(200, 256);
+            pt_map(pt, 10, 0);
+            pt_map(pt, 150, 1);
+            pt_set_dirty(pt, 150, true);
+
+            should_int(pt_resize(pt, 100)) be equal to(0);
+            should_int(pt_resize(pt, 200)) be equal to(0);
+
+            should_bool(pt_is_present(pt, 150)) be equal to(false);
+            should_int(pt->present_count) be equal to(1);
+            should_int(pt->dirty_count) be equal to(0);
+            pt_destroy(pt);
+        } end
+    } end
 }
@@ -0,0 +1,87 @@
+#include <query_interpreter/script_cache.h>
+#include <cspecs/cspec.h>
+
+#define SCRIPT_PATH "tests/resources/test_script_cache.txt"
+#define OTHER_SCRIPT_PATH "tests/resources/test_script_cache_2.txt"
+
+context(test_script_cache)
+{
+    describe("Caché de scripts compilados")
+    {
+        script_cache_t *cache = NULL;
+
+        before {
+            FILE *file = fopen(SCRIPT_PATH, "w");
+            fprintf(file, "CREATE ARCHIVO1:TAG1\n");
+            fprintf(file, "INSTRUCCION_INVALIDA\n");
+            fprintf(file, "END\n");
+            fclose(file);
+
+            file = fopen(OTHER_SCRIPT_PATH, "w");
+            fprintf(file, "END\n");
+            fclose(file);
+
+            cache = script_cache_create(64 * 1024);
+        } end
+
+        after {
+            script_cache_destroy(cache);
+            remove(SCRIPT_PATH);
+            remove(OTHER_SCRIPT_PATH);
+        } end
+
+        it("debería compilar el script completo en la primera lectura")
+        {
+            compiled_script_t *script = script_cache_get(cache, SCRIPT_PATH);
+
+            should_ptr(script) not be null;
+            should_int(script->instruction_count) be equal to(3);
+            should_int(cache->misses) be equal to(1);
+            should_int(cache->hits) be equal to(0);
+        } end
+
+        it("debería devolver la instrucción decodificada según el program counter")
+        {
+            compiled_script_t *script = script_cache_get(cache, SCRIPT_PATH);
+
+            compiled_instruction_t *first = script_cache_instruction_at(script, 0);
+            should_ptr(first) not be null;
+            should_bool(first->valid) be truthy;
+            should_string(first->raw) be equal to("CREATE ARCHIVO1:TAG1");
+            should_int(first->instruction.operation) be equal to(CREATE);
+            should_string(first->instruction.file_tag.file) be equal to("ARCHIVO1");
+
+            compiled_instruction_t *invalid = script_cache_instruction_at(script, 1);
+            should_bool(invalid->valid) be falsey;
+
+            should_ptr(script_cache_instruction_at(script, 3)) be null;
+        } end
+
+        it("debería contar un hit al pedir un script ya compilado")
+        {
+            compiled_script_t *first = script_cache_get(cache, SCRIPT_PATH);
+            compiled_script_t *second = script_cache_get(cache, SCRIPT_PATH);
+
+            should_ptr(second) be equal to(first);
+            should_int(cache->hits) be equal to(1);
+            should_int(cache->misses) be equal to(1);
+        } end
+
+        it("debería fallar con un archivo inexistente")
+        {
+            should_ptr(script_cache_get(cache, "archivo_inexistente.txt")) be null;
+        } end
+
+        it("debería desalojar el script menos usado al superar el presupuesto")
+        {
+            cache->budget = 0;
+
+            script_cache_get(cache, SCRIPT_PATH);
+            script_cache_get(cache, OTHER_SCRIPT_PATH);
+
+            should_int(list_size(cache->lru)) be equal to(1);
+            should_int(cache->evictions) be equal to(1);
+            should_ptr(dictionary_get(cache->scripts, SCRIPT_PATH)) be null;
+        } end
+    } end
+}